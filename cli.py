@@ -22,6 +22,7 @@ class INS(enum.IntEnum):
 
 P2_MORE = 0x80  # specific for SIGN_TX instruction
 P2_LAST = 0x00  # specific for SIGN_TX instruction
+MAX_CHUNK_LEN = 255  # transaction bytes per SIGN_TX APDU
 
 BIP44 = bytes.fromhex("8000002C"
                       "80000378"
@@ -61,7 +62,12 @@ def get_public_key(conn, showOnDevice: bool = True) -> cryptography.ECPoint:
 def sign_tx(conn, tx_unsigned_data: bytes) -> str:
     conn.exchange(apdu(INS.SIGN_TX, p1=0, p2=P2_MORE, cdata=BIP44))  # send BIP44 path
     conn.exchange(apdu(INS.SIGN_TX, p1=1, p2=P2_MORE, cdata=NETWORK_MAGIC))
-    result = conn.exchange(apdu(INS.SIGN_TX, p1=2, p2=P2_LAST, cdata=tx_unsigned_data))
+    # the transaction may be of any length, it is hashed by the app chunk by chunk. The chunks are numbered from 2 on,
+    # the ones past 0xFF keep it
+    chunks = [tx_unsigned_data[i:i + MAX_CHUNK_LEN] for i in range(0, len(tx_unsigned_data), MAX_CHUNK_LEN)]
+    for i, chunk in enumerate(chunks):
+        last = i == len(chunks) - 1
+        result = conn.exchange(apdu(INS.SIGN_TX, p1=min(i + 2, 0xFF), p2=P2_LAST if last else P2_MORE, cdata=chunk))
     return result.hex()
 
 
@@ -3,12 +3,16 @@ set -e
 
 SCRIPTDIR="$(cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd)"
 BUILDDIR="$SCRIPTDIR/cmake-build-fuzz"
+# fuzz_message (transaction parser) or fuzz_apdu (APDU state machines)
+FUZZER="${FUZZER:-fuzz_message}"
+# TX_MUTATOR=OFF builds fuzz_message without its structure-aware mutator
+TX_MUTATOR="${TX_MUTATOR:-ON}"
 
 # Compile fuzzer
 rm -rf "$BUILDDIR"
 mkdir "$BUILDDIR"
 cd "$BUILDDIR"
 
-cmake -DCMAKE_C_COMPILER=clang ..
+cmake -DCMAKE_C_COMPILER=clang -DTX_MUTATOR="$TX_MUTATOR" ..
 make clean
-make fuzz_message
\ No newline at end of file
+make "$FUZZER"
@@ -1,21 +1,38 @@
 #!/usr/bin/env bash
 # Generate code coverage reports from fuzzing results
+#
+#   FUZZER        fuzz_message (transaction parser, default) or fuzz_apdu (APDU state machines)
+#   FUZZ_SECONDS  fuzz for that long first, from a copy of the corpus, and report the coverage of the whole run
+#   TX_MUTATOR    OFF to fuzz without the structure-aware mutator of fuzz_message, to compare the coverage reached
 
 set -e
 
 SCRIPTDIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
 BUILDDIR="$SCRIPTDIR/cmake-build-fuzz-coverage"
-CORPUSDIR="$SCRIPTDIR/corpus"
+FUZZER="${FUZZER:-fuzz_message}"
+TX_MUTATOR="${TX_MUTATOR:-ON}"
+if [ "$FUZZER" = fuzz_apdu ]; then
+    CORPUSDIR="$SCRIPTDIR/corpus_apdu"
+else
+    CORPUSDIR="$SCRIPTDIR/corpus"
+fi
 HTMLCOVDIR="$SCRIPTDIR/html-coverage"
 
 # Compile the fuzzer with code coverage support
 rm -rf "$BUILDDIR" "$HTMLCOVDIR"
-cmake -DCMAKE_C_COMPILER=clang -DCODE_COVERAGE=1 -B"$BUILDDIR" -H.
-cmake --build "$BUILDDIR" --target fuzz_message
+cmake -DCMAKE_C_COMPILER=clang -DCODE_COVERAGE=1 -DTX_MUTATOR="$TX_MUTATOR" -B"$BUILDDIR" -H.
+cmake --build "$BUILDDIR" --target "$FUZZER"
 
-# Run the fuzzer on the corpus files
-export LLVM_PROFILE_FILE="$BUILDDIR/fuzz_message.profraw"
-"$BUILDDIR/fuzz_message" "$CORPUSDIR"/*
-llvm-profdata merge --sparse "$LLVM_PROFILE_FILE" -o "$BUILDDIR/fuzz_message.profdata"
-llvm-cov show "$BUILDDIR/fuzz_message" -instr-profile="$BUILDDIR/fuzz_message.profdata" -show-line-counts-or-regions -output-dir="$HTMLCOVDIR" -format=html
-llvm-cov report "$BUILDDIR/fuzz_message" -instr-profile="$BUILDDIR/fuzz_message.profdata"
+export LLVM_PROFILE_FILE="$BUILDDIR/$FUZZER.profraw"
+if [ -n "$FUZZ_SECONDS" ]; then
+    # Fuzz a copy of the corpus, every input run is counted
+    mkdir -p "$BUILDDIR/corpus"
+    cp "$CORPUSDIR"/* "$BUILDDIR/corpus" 2>/dev/null || true
+    "$BUILDDIR/$FUZZER" -max_total_time="$FUZZ_SECONDS" "$BUILDDIR/corpus" > /dev/null 2>&1
+else
+    # Run the fuzzer on the corpus files
+    "$BUILDDIR/$FUZZER" "$CORPUSDIR"/*
+fi
+llvm-profdata merge --sparse "$LLVM_PROFILE_FILE" -o "$BUILDDIR/$FUZZER.profdata"
+llvm-cov show "$BUILDDIR/$FUZZER" -instr-profile="$BUILDDIR/$FUZZER.profdata" -show-line-counts-or-regions -output-dir="$HTMLCOVDIR" -format=html
+llvm-cov report "$BUILDDIR/$FUZZER" -instr-profile="$BUILDDIR/$FUZZER.profdata"
@@ -0,0 +1,63 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "emulator.h"
+
+/**
+ * Fuzzer of the APDU state machines, the app as a whole: parser, dispatcher, handlers (SIGN_TX chunks, batches, the
+ * context shared by the commands) and io.c, on the emulator of the unit tests (unit-tests/emulator/emulator.h).
+ *
+ * The input is a session with the app, started from scratch:
+ *
+ *   settings (1) || exchange * n
+ *   exchange = control (1) || CLA || INS || P1 || P2 || Lc || CData (Lc)
+ *
+ * 'settings' allows arbitrary scripts (bit 0) and shows the script hash (bit 1). 'control' rejects the reviews of the
+ * exchange (bit 0), locks the device (bit 1) and sends a ticker event before the command (bit 2), so the keys cache is
+ * flushed when the device is locked. The last command is cut at the end of the input, with Lc left as is.
+ */
+
+#define SETTING_SCRIPTS_ALLOWED  0x01
+#define SETTING_SHOW_SCRIPT_HASH 0x02
+
+#define CONTROL_REJECT 0x01
+#define CONTROL_LOCK   0x02
+#define CONTROL_TICKER 0x04
+
+#define OFFSET_LC 4
+
+int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    size_t offset = 0;
+
+    if (Size < 1) {
+        return 0;
+    }
+    emu_reset();
+    emu_set_settings(Data[0] & SETTING_SCRIPTS_ALLOWED, Data[0] & SETTING_SHOW_SCRIPT_HASH);
+    offset++;
+
+    while (offset < Size) {
+        uint8_t control = Data[offset++];
+        size_t command_len = Size - offset;
+
+        if (command_len > OFFSET_LC && command_len > OFFSET_LC + 1 + (size_t) Data[offset + OFFSET_LC]) {
+            command_len = OFFSET_LC + 1 + (size_t) Data[offset + OFFSET_LC];
+        }
+        emu_set_approval(!(control & CONTROL_REJECT));
+        emu_set_locked(control & CONTROL_LOCK);
+        if (control & CONTROL_TICKER) {
+            emu_ticker();
+        }
+
+        int rapdu_len = emu_exchange(Data + offset, command_len, rapdu, sizeof(rapdu));
+        // the app responds with a status word at least, or not at all
+        if (rapdu_len != -1 && rapdu_len < 2) {
+            abort();
+        }
+        offset += command_len;
+    }
+    return 0;
+}
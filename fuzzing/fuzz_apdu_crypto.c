@@ -0,0 +1,160 @@
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <string.h>   // memcpy
+
+#include "cx.h"
+
+/**
+ * Fast stand-ins for the keys and signatures of the emulator (unit-tests/emulator/emulator_crypto.c), for the APDU
+ * fuzzer: the derivation, the public keys and the signatures are SHA-256 of their inputs, not points of the curve, so
+ * a session costs microseconds. They are deterministic and shaped as the real ones: the public keys are uncompressed
+ * (0x04 || x || y) and the signatures are DER encoded, with the lengths of their integers varying.
+ */
+
+cx_err_t os_derive_bip32_with_seed_no_throw(unsigned int derivation_mode,
+                                            cx_curve_t curve,
+                                            const uint32_t *path,
+                                            size_t path_len,
+                                            uint8_t raw_privkey[static 64],
+                                            uint8_t *chain_code,
+                                            unsigned char *seed,
+                                            size_t seed_len) {
+    (void) derivation_mode;
+    (void) seed;
+    (void) seed_len;
+
+    if (curve != CX_CURVE_256R1) {
+        return CX_INVALID_PARAMETER;
+    }
+    SHA256((const uint8_t *) path, path_len * sizeof(*path), raw_privkey);
+    if (chain_code != NULL) {
+        SHA256(raw_privkey, 32, chain_code);
+    }
+    return CX_OK;
+}
+
+cx_err_t cx_ecfp_init_private_key_no_throw(cx_curve_t curve,
+                                           const uint8_t *raw_key,
+                                           size_t key_len,
+                                           cx_ecfp_private_key_t *pvkey) {
+    if (curve != CX_CURVE_256R1 || key_len != sizeof(pvkey->d)) {
+        return CX_INVALID_PARAMETER;
+    }
+    pvkey->curve = curve;
+    pvkey->d_len = key_len;
+    memcpy(pvkey->d, raw_key, key_len);
+    return CX_OK;
+}
+
+cx_err_t cx_ecfp_generate_pair_no_throw(cx_curve_t curve,
+                                        cx_ecfp_public_key_t *pubkey,
+                                        cx_ecfp_private_key_t *privkey,
+                                        bool keep_private) {
+    if (curve != CX_CURVE_256R1 || !keep_private || privkey->d_len != sizeof(privkey->d)) {
+        return CX_INVALID_PARAMETER;
+    }
+    pubkey->curve = curve;
+    pubkey->W_len = sizeof(pubkey->W);
+    pubkey->W[0] = 0x04;
+    SHA256(privkey->d, sizeof(privkey->d), pubkey->W + 1);
+    SHA256(pubkey->W + 1, 32, pubkey->W + 33);
+    return CX_OK;
+}
+
+/**
+ * DER integer of big endian 'value' (32 bytes) at 'der', minimal: without leading zeros, with a zero if the first
+ * byte has its high bit set.
+ *
+ * @return length of the integer, header included.
+ */
+static size_t encode_der_integer(const uint8_t value[static 32], uint8_t *der) {
+    size_t start = 0;
+
+    while (start < 31 && value[start] == 0) {
+        start++;
+    }
+    size_t pad = (value[start] & 0x80) ? 1 : 0;
+    der[0] = 0x02;
+    der[1] = (uint8_t) (32 - start + pad);
+    der[2] = 0x00;
+    memcpy(der + 2 + pad, value + start, 32 - start);
+    return 2 + pad + 32 - start;
+}
+
+cx_err_t cx_ecdsa_sign_no_throw(const cx_ecfp_private_key_t *pvkey,
+                                uint32_t mode,
+                                cx_md_t hashID,
+                                const uint8_t *hash,
+                                size_t hash_len,
+                                uint8_t *sig,
+                                size_t *sig_len,
+                                uint32_t *info) {
+    (void) mode;
+    (void) hashID;
+
+    uint8_t r[32];
+    uint8_t s[32];
+    uint8_t der[2 + 2 * (2 + 33)];
+
+    if (pvkey->d_len != sizeof(pvkey->d) || hash_len != 32) {
+        return CX_INVALID_PARAMETER;
+    }
+    SHA256(pvkey->d, sizeof(pvkey->d), r);
+    memcpy(s, hash, sizeof(s));
+
+    size_t len = 2;
+    len += encode_der_integer(r, der + len);
+    len += encode_der_integer(s, der + len);
+    der[0] = 0x30;
+    der[1] = (uint8_t) (len - 2);
+    if (len > *sig_len) {
+        return CX_INVALID_PARAMETER;
+    }
+    memcpy(sig, der, len);
+    *sig_len = len;
+    if (info != NULL) {
+        *info = r[31] & 1;  // CX_ECCINFO_PARITY_ODD
+    }
+    return CX_OK;
+}
+
+/**
+ * Read DER integer 'value' at 'offset' of 'sig', at most 'max_size' bytes long.
+ */
+static bool decode_der_integer(const uint8_t *sig,
+                               size_t sig_len,
+                               size_t *offset,
+                               size_t max_size,
+                               const uint8_t **value,
+                               size_t *value_len) {
+    if (*offset + 2 > sig_len || sig[*offset] != 0x02) {
+        return false;
+    }
+    size_t len = sig[*offset + 1];
+    *offset += 2;
+    if (len == 0 || len > max_size || *offset + len > sig_len) {
+        return false;
+    }
+    *value = sig + *offset;
+    *value_len = len;
+    *offset += len;
+    return true;
+}
+
+int cx_ecfp_decode_sig_der(const uint8_t *sig,
+                           size_t sig_len,
+                           size_t max_size,
+                           const uint8_t **r,
+                           size_t *r_len,
+                           const uint8_t **s,
+                           size_t *s_len) {
+    size_t offset = 2;
+
+    if (sig_len < 2 || sig[0] != 0x30 || sig[1] != sig_len - 2 ||
+        !decode_der_integer(sig, sig_len, &offset, max_size, r, r_len) ||
+        !decode_der_integer(sig, sig_len, &offset, max_size, s, s_len) || offset != sig_len) {
+        return 0;
+    }
+    return 1;
+}
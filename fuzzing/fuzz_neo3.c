@@ -3,10 +3,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+static uint8_t store[TRANSACTION_STORE_LEN];
+
 int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
     buffer_t buf = {.offset = 0, .ptr = Data, .size = Size};
     transaction_t tx = {0};
 
-    transaction_deserialize(&buf, &tx);
+    transaction_deserialize(&buf, &tx, store, sizeof(store));
     return 0;
 }
@@ -0,0 +1,503 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "transaction/transaction_types.h"
+#include "transaction/script.h"
+#include "transaction/tokens.h"
+
+/**
+ * Structure-aware mutator of fuzz_message: the input is read as a NEO N3 transaction (doc/TRANSACTION.md), mutated
+ * field by field and written back with consistent lengths, so the mutations reach the signers, the attributes and the
+ * script templates of tx_utils.c instead of stopping at a varint or a length check. Inputs that aren't transactions
+ * are replaced by a new one. Some of the mutations are those of libFuzzer, on the script or the whole transaction,
+ * so the malformed transactions are still explored.
+ *
+ * Built unless TX_MUTATOR is OFF, to compare with the byte-level mutations of libFuzzer alone.
+ */
+
+size_t LLVMFuzzerMutate(uint8_t *Data, size_t Size, size_t MaxSize);
+
+#define HEADER_LEN (1 + 4 + 8 + 8 + 4)  // version, nonce, system fee, network fee, valid until block
+
+// one more than accepted, to reach the checks of the counts
+#define MODEL_MAX_SIGNERS    (MAX_TX_SIGNERS + 1)
+#define MODEL_MAX_CONTRACTS  (MAX_SIGNER_ALLOWED_CONTRACTS + 1)
+#define MODEL_MAX_GROUPS     (MAX_SIGNER_ALLOWED_GROUPS + 1)
+#define MODEL_MAX_ATTRIBUTES (MAX_ATTRIBUTES + 1)
+#define MODEL_MAX_SCRIPT_LEN 1024
+
+typedef struct {
+    uint8_t account[UINT160_LEN];
+    uint8_t scope;
+    uint8_t contracts_count;
+    uint8_t contracts[MODEL_MAX_CONTRACTS][UINT160_LEN];
+    uint8_t groups_count;
+    uint8_t groups[MODEL_MAX_GROUPS][ECPOINT_LEN];
+} model_signer_t;
+
+/**
+ * A transaction, as its fields.
+ */
+typedef struct {
+    uint8_t header[HEADER_LEN];
+    uint8_t signers_count;
+    model_signer_t signers[MODEL_MAX_SIGNERS];
+    uint8_t attributes_count;
+    uint8_t attributes[MODEL_MAX_ATTRIBUTES];
+    size_t script_len;
+    uint8_t script[MODEL_MAX_SCRIPT_LEN];
+} tx_model_t;
+
+typedef struct {
+    uint8_t *ptr;
+    size_t size;
+    size_t offset;
+    bool overflow;  /// something didn't fit
+} writer_t;
+
+static const uint8_t SCOPES[] = {NONE,
+                                 CALLED_BY_ENTRY,
+                                 CUSTOM_CONTRACTS,
+                                 CUSTOM_GROUPS,
+                                 CUSTOM_CONTRACTS | CUSTOM_GROUPS,
+                                 CALLED_BY_ENTRY | CUSTOM_CONTRACTS,
+                                 GLOBAL,
+                                 GLOBAL | CALLED_BY_ENTRY,
+                                 0x40};  // WitnessRules, not supported
+
+// the buffers of a mutation, too large for the stack of libFuzzer
+static tx_model_t model;
+static uint8_t output[MODEL_MAX_SCRIPT_LEN * 2];
+
+static uint32_t rand_state;
+
+static uint32_t rand_next(void) {
+    // xorshift32
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static uint32_t rand_below(uint32_t n) {
+    return rand_next() % n;
+}
+
+static void rand_bytes(uint8_t *out, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        out[i] = (uint8_t) rand_next();
+    }
+}
+
+/**
+ * Read varint at 'offset' of 'data', of at most 'max'.
+ */
+static bool read_count(const uint8_t *data, size_t size, size_t *offset, uint64_t max, uint64_t *value) {
+    if (*offset >= size) {
+        return false;
+    }
+    uint8_t prefix = data[(*offset)++];
+    size_t len = (prefix == 0xFD) ? 2 : (prefix == 0xFE) ? 4 : (prefix == 0xFF) ? 8 : 0;
+    if (len == 0) {
+        *value = prefix;
+    } else {
+        if (*offset + len > size) {
+            return false;
+        }
+        *value = 0;
+        for (size_t i = 0; i < len; i++) {
+            *value |= (uint64_t) data[*offset + i] << (8 * i);
+        }
+        *offset += len;
+    }
+    return *value <= max;
+}
+
+static bool read_bytes(const uint8_t *data, size_t size, size_t *offset, uint8_t *out, size_t len) {
+    if (*offset + len > size) {
+        return false;
+    }
+    memcpy(out, data + *offset, len);
+    *offset += len;
+    return true;
+}
+
+/**
+ * Read transaction 'data' of length 'size' into 'tx'. Counts up to one more than the parser accepts are read.
+ *
+ * @return false if 'data' isn't a transaction.
+ */
+static bool model_read(const uint8_t *data, size_t size, tx_model_t *tx) {
+    size_t offset = 0;
+    uint64_t value;
+
+    if (!read_bytes(data, size, &offset, tx->header, HEADER_LEN) ||
+        !read_count(data, size, &offset, MODEL_MAX_SIGNERS, &value)) {
+        return false;
+    }
+    tx->signers_count = (uint8_t) value;
+    for (size_t s = 0; s < tx->signers_count; s++) {
+        model_signer_t *signer = &tx->signers[s];
+
+        signer->contracts_count = 0;
+        signer->groups_count = 0;
+        if (!read_bytes(data, size, &offset, signer->account, UINT160_LEN) ||
+            !read_bytes(data, size, &offset, &signer->scope, 1)) {
+            return false;
+        }
+        if (signer->scope & CUSTOM_CONTRACTS) {
+            if (!read_count(data, size, &offset, MODEL_MAX_CONTRACTS, &value)) {
+                return false;
+            }
+            signer->contracts_count = (uint8_t) value;
+            for (size_t i = 0; i < signer->contracts_count; i++) {
+                if (!read_bytes(data, size, &offset, signer->contracts[i], UINT160_LEN)) {
+                    return false;
+                }
+            }
+        }
+        if (signer->scope & CUSTOM_GROUPS) {
+            if (!read_count(data, size, &offset, MODEL_MAX_GROUPS, &value)) {
+                return false;
+            }
+            signer->groups_count = (uint8_t) value;
+            for (size_t i = 0; i < signer->groups_count; i++) {
+                if (!read_bytes(data, size, &offset, signer->groups[i], ECPOINT_LEN)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (!read_count(data, size, &offset, MODEL_MAX_ATTRIBUTES, &value)) {
+        return false;
+    }
+    tx->attributes_count = (uint8_t) value;
+    if (!read_bytes(data, size, &offset, tx->attributes, tx->attributes_count) ||
+        !read_count(data, size, &offset, MODEL_MAX_SCRIPT_LEN, &value)) {
+        return false;
+    }
+    tx->script_len = (size_t) value;
+    return read_bytes(data, size, &offset, tx->script, tx->script_len);
+}
+
+static void write_bytes(writer_t *w, const uint8_t *data, size_t len) {
+    if (w->offset + len > w->size) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->ptr + w->offset, data, len);
+    w->offset += len;
+}
+
+static void write_u8(writer_t *w, uint8_t value) {
+    write_bytes(w, &value, 1);
+}
+
+static void write_le(writer_t *w, uint64_t value, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        write_u8(w, (uint8_t) (value >> (8 * i)));
+    }
+}
+
+/**
+ * Write varint 'value', sometimes in a longer encoding than needed, which the app accepts too.
+ */
+static void write_count(writer_t *w, uint64_t value) {
+    if (value < 0xFD && rand_below(32) != 0) {
+        write_u8(w, (uint8_t) value);
+    } else {
+        write_u8(w, 0xFD);
+        write_le(w, value, 2);
+    }
+}
+
+static void model_write(const tx_model_t *tx, writer_t *w) {
+    write_bytes(w, tx->header, HEADER_LEN);
+    write_count(w, tx->signers_count);
+    for (size_t s = 0; s < tx->signers_count; s++) {
+        const model_signer_t *signer = &tx->signers[s];
+
+        write_bytes(w, signer->account, UINT160_LEN);
+        write_u8(w, signer->scope);
+        if (signer->scope & CUSTOM_CONTRACTS) {
+            write_count(w, signer->contracts_count);
+            write_bytes(w, signer->contracts[0], signer->contracts_count * UINT160_LEN);
+        }
+        if (signer->scope & CUSTOM_GROUPS) {
+            write_count(w, signer->groups_count);
+            write_bytes(w, signer->groups[0], signer->groups_count * ECPOINT_LEN);
+        }
+    }
+    write_count(w, tx->attributes_count);
+    write_bytes(w, tx->attributes, tx->attributes_count);
+    write_count(w, tx->script_len);
+    write_bytes(w, tx->script, tx->script_len);
+}
+
+static void script_hash(writer_t *w) {
+    uint8_t hash[UINT160_LEN];
+
+    write_u8(w, OPCODE_PUSHDATA1);
+    write_u8(w, UINT160_LEN);
+    rand_bytes(hash, sizeof(hash));
+    write_bytes(w, hash, sizeof(hash));
+}
+
+static void script_contract_call(writer_t *w, const char *method, const uint8_t contract[static UINT160_LEN]) {
+    write_u8(w, OPCODE_PUSH15);  // CallFlags
+    write_u8(w, OPCODE_PUSHDATA1);
+    write_u8(w, (uint8_t) strlen(method));
+    write_bytes(w, (const uint8_t *) method, strlen(method));
+    write_u8(w, OPCODE_PUSHDATA1);
+    write_u8(w, UINT160_LEN);
+    write_bytes(w, contract, UINT160_LEN);
+    write_u8(w, OPCODE_SYSCALL);
+    write_bytes(w, SYSCALL_CONTRACT_CALL, SYSCALL_ID_LEN);
+}
+
+/**
+ * Push of a transfer amount, in any of the encodings of an integer.
+ */
+static void script_amount(writer_t *w) {
+    static const uint8_t PUSHINT_LENS[] = {1, 2, 4, 8, 16};
+    uint8_t operand[16];
+
+    switch (rand_below(4)) {
+        case 0:
+            write_u8(w, (uint8_t) (OPCODE_PUSH0 + rand_below(17)));  // PUSH0 to PUSH16
+            break;
+        case 1:
+            write_u8(w, OPCODE_PUSHM1);
+            break;
+        case 2: {
+            size_t i = rand_below(sizeof(PUSHINT_LENS));
+            write_u8(w, (uint8_t) (OPCODE_PUSHINT8 + i));
+            rand_bytes(operand, PUSHINT_LENS[i]);
+            write_bytes(w, operand, PUSHINT_LENS[i]);
+            break;
+        }
+        default:
+            write_u8(w, OPCODE_PUSHNULL);
+            break;
+    }
+}
+
+/**
+ * NEP-17 transfer of a token of the registry, or of an unknown contract.
+ */
+static void script_transfer(writer_t *w) {
+    uint8_t contract[UINT160_LEN];
+
+    write_u8(w, OPCODE_PUSHNULL);  // data
+    script_amount(w);
+    script_hash(w);  // to
+    script_hash(w);  // from
+    write_u8(w, OPCODE_PUSH4);
+    write_u8(w, OPCODE_PACK);
+    if (rand_below(8) != 0) {
+        memcpy(contract, TOKENS[rand_below(TOKENS_COUNT)].script_hash, UINT160_LEN);
+    } else {
+        rand_bytes(contract, sizeof(contract));
+    }
+    script_contract_call(w, "transfer", contract);
+}
+
+/**
+ * NEO vote for a candidate, or retraction of the vote.
+ */
+static void script_vote(writer_t *w) {
+    uint8_t candidate[ECPOINT_LEN];
+
+    if (rand_below(4) == 0) {
+        write_u8(w, OPCODE_PUSHNULL);
+    } else {
+        rand_bytes(candidate, sizeof(candidate));
+        if (rand_below(8) != 0) {
+            candidate[0] = (uint8_t) (0x02 + rand_below(2));
+        }
+        write_u8(w, OPCODE_PUSHDATA1);
+        write_u8(w, ECPOINT_LEN);
+        write_bytes(w, candidate, sizeof(candidate));
+    }
+    script_hash(w);  // account
+    write_u8(w, OPCODE_PUSH2);
+    write_u8(w, OPCODE_PACK);
+    script_contract_call(w, "vote", NEO_SCRIPT_HASH);
+}
+
+static void mutate_script(tx_model_t *tx, size_t max_len) {
+    writer_t w = {.ptr = tx->script, .size = MODEL_MAX_SCRIPT_LEN};
+
+    switch (rand_below(4)) {
+        case 0: {
+            // transfers, up to one more than the app accepts
+            size_t count = 1 + rand_below(MAX_TX_TRANSFERS + 1);
+            for (size_t i = 0; i < count; i++) {
+                script_transfer(&w);
+            }
+            break;
+        }
+        case 1:
+            script_vote(&w);
+            break;
+        case 2:
+            // a call of anything else, an arbitrary script
+            script_hash(&w);
+            write_u8(&w, OPCODE_PUSH2);
+            write_u8(&w, OPCODE_PACK);
+            script_contract_call(&w, "balanceOf", NEO_SCRIPT_HASH);
+            break;
+        default:
+            // libFuzzer on the script alone
+            tx->script_len = LLVMFuzzerMutate(tx->script, tx->script_len, max_len);
+            return;
+    }
+    if (!w.overflow) {
+        tx->script_len = w.offset;
+    }
+}
+
+static void new_signer(model_signer_t *signer) {
+    rand_bytes(signer->account, UINT160_LEN);
+    signer->scope = SCOPES[rand_below(sizeof(SCOPES))];
+    signer->contracts_count = 0;
+    signer->groups_count = 0;
+}
+
+static void mutate_signers(tx_model_t *tx) {
+    model_signer_t *signer = &tx->signers[rand_below(tx->signers_count)];
+
+    switch (rand_below(6)) {
+        case 0:
+            if (tx->signers_count < MODEL_MAX_SIGNERS) {
+                new_signer(&tx->signers[tx->signers_count]);
+                // sometimes a duplicate of another signer
+                if (rand_below(4) == 0) {
+                    memcpy(tx->signers[tx->signers_count].account, signer->account, UINT160_LEN);
+                }
+                tx->signers_count++;
+            }
+            break;
+        case 1:
+            tx->signers_count--;
+            memmove(signer, signer + 1, (tx->signers_count - (size_t) (signer - tx->signers)) * sizeof(*signer));
+            break;
+        case 2:
+            signer->scope = (rand_below(8) != 0) ? SCOPES[rand_below(sizeof(SCOPES))] : (uint8_t) rand_next();
+            break;
+        case 3:
+            signer->scope |= CUSTOM_CONTRACTS;
+            if (rand_below(4) != 0 && signer->contracts_count < MODEL_MAX_CONTRACTS) {
+                rand_bytes(signer->contracts[signer->contracts_count++], UINT160_LEN);
+            } else if (signer->contracts_count > 0) {
+                signer->contracts_count--;
+            }
+            break;
+        case 4:
+            signer->scope |= CUSTOM_GROUPS;
+            if (rand_below(4) != 0 && signer->groups_count < MODEL_MAX_GROUPS) {
+                uint8_t *group = signer->groups[signer->groups_count++];
+                rand_bytes(group, ECPOINT_LEN);
+                group[0] = (uint8_t) (0x02 + rand_below(2));
+            } else if (signer->groups_count > 0) {
+                signer->groups_count--;
+            }
+            break;
+        default:
+            rand_bytes(signer->account, UINT160_LEN);
+            break;
+    }
+}
+
+static void mutate_attributes(tx_model_t *tx) {
+    tx->attributes_count = (uint8_t) rand_below(MODEL_MAX_ATTRIBUTES + 1);
+    for (size_t i = 0; i < tx->attributes_count; i++) {
+        switch (rand_below(4)) {
+            case 0:
+                tx->attributes[i] = ORACLE_RESPONSE;
+                break;
+            case 1:
+                tx->attributes[i] = (uint8_t) rand_next();
+                break;
+            default:
+                tx->attributes[i] = HIGH_PRIORITY;
+                break;
+        }
+    }
+}
+
+static void mutate_header(tx_model_t *tx) {
+    switch (rand_below(4)) {
+        case 0:
+            // version, 0 but sometimes not
+            tx->header[0] = (rand_below(8) != 0) ? 0 : (uint8_t) rand_next();
+            break;
+        case 1:
+            // system fee or network fee, sometimes negative
+            rand_bytes(tx->header + 5 + 8 * rand_below(2), 8);
+            if (rand_below(4) != 0) {
+                tx->header[5 + 7] &= 0x7F;
+                tx->header[5 + 8 + 7] &= 0x7F;
+            }
+            break;
+        default:
+            // nonce or valid until block
+            rand_bytes(tx->header + (rand_below(2) ? 1 : 21), 4);
+            break;
+    }
+}
+
+static void model_new(tx_model_t *tx) {
+    memset(tx->header, 0, HEADER_LEN);
+    rand_bytes(tx->header + 1, 4);
+    tx->signers_count = 1;
+    new_signer(&tx->signers[0]);
+    tx->attributes_count = 0;
+    tx->script_len = 0;
+    mutate_script(tx, MODEL_MAX_SCRIPT_LEN);
+}
+
+size_t LLVMFuzzerCustomMutator(uint8_t *Data, size_t Size, size_t MaxSize, unsigned int Seed) {
+    rand_state = Seed | 1;
+
+    // libFuzzer on the whole transaction, for the malformed ones
+    if (rand_below(8) == 0) {
+        return LLVMFuzzerMutate(Data, Size, MaxSize);
+    }
+
+    if (!model_read(Data, Size, &model)) {
+        model_new(&model);
+    } else {
+        switch (rand_below(5)) {
+            case 0:
+                mutate_header(&model);
+                break;
+            case 1:
+                if (model.signers_count > 0) {
+                    mutate_signers(&model);
+                } else {
+                    model.signers_count = 1;
+                    new_signer(&model.signers[0]);
+                }
+                break;
+            case 2:
+                mutate_attributes(&model);
+                break;
+            default:
+                mutate_script(&model, MODEL_MAX_SCRIPT_LEN);
+                break;
+        }
+    }
+
+    writer_t w = {.ptr = output, .size = (MaxSize < sizeof(output)) ? MaxSize : sizeof(output)};
+    model_write(&model, &w);
+    if (w.overflow) {
+        return LLVMFuzzerMutate(Data, Size, MaxSize);
+    }
+    memcpy(Data, output, w.offset);
+    return w.offset;
+}
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+"""Seed corpus of fuzz_apdu, from APDU traces (doc/APDU_TRACE.md).
+
+    python3 gen_apdu_corpus.py OUTPUT_DIR TRACE...
+
+Each trace is a session of the fuzzer, with arbitrary scripts allowed and the reviews of the commands recorded with
+SW_DENY rejected (see fuzz_apdu.c).
+"""
+
+import json
+import os
+import sys
+
+SETTING_SCRIPTS_ALLOWED = 0x01
+CONTROL_REJECT = 0x01
+SW_DENY = "6985"
+
+
+def session(trace_path: str) -> bytes:
+    data = bytes([SETTING_SCRIPTS_ALLOWED])
+    with open(trace_path, encoding="utf-8") as trace:
+        for line in trace:
+            start = line.find("{")
+            if start < 0 or '"command"' not in line:
+                continue
+            exchange = json.loads(line[start:])
+            control = CONTROL_REJECT if exchange["sw"].lower() == SW_DENY else 0
+            data += bytes([control]) + bytes.fromhex(exchange["command"])
+    return data
+
+
+def main() -> int:
+    if len(sys.argv) < 3:
+        print(__doc__, file=sys.stderr)
+        return 2
+    os.makedirs(sys.argv[1], exist_ok=True)
+    for trace_path in sys.argv[2:]:
+        name = os.path.splitext(os.path.basename(trace_path))[0]
+        with open(os.path.join(sys.argv[1], name + ".raw"), "wb") as seed:
+            seed.write(session(trace_path))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
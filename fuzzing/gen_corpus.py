@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Seed corpus of fuzz_message: the transactions of the functional tests, serialized for signing.
+
+    python3 gen_corpus.py [OUTPUT_DIR]
+
+The transactions are built as in tests/ (test_sign_cmd.py, test_sign_batch.py, test_arbitrary_scripts.py,
+test_tx_deserialization.py), with neo-mamba (pip install -r tests/requirements.txt), and written to OUTPUT_DIR,
+fuzzing/corpus by default, one .raw file each.
+"""
+
+import os
+import struct
+import sys
+from typing import List
+
+from neo3 import vm
+from neo3.api.wrappers import GasToken, NeoToken
+from neo3.core import serialization, types
+from neo3.network.payloads.transaction import HighPriorityAttribute, Transaction
+from neo3.network.payloads.verification import Signer, WitnessScope
+from neo3.wallet.utils import address_to_script_hash
+
+from_account = address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+to_account = address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+signer_account = types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654")
+flm_hash = types.UInt160.from_string("f0151f528127558851b39c2cd8aa47da7418ab28")
+candidate = bytes.fromhex("03b209fd4f53a7170ea4444e0cb0a6bb6a53c2bd016926989cf85f9b0fba17a70c")
+
+
+def transfer(sb: vm.ScriptBuilder, contract: types.UInt160, amount: int) -> vm.ScriptBuilder:
+    sb.emit_contract_call_with_args(contract, "transfer", [from_account, to_account, amount, None])
+    return sb
+
+
+def tx(script: bytes, signers: List[Signer], attributes=None) -> Transaction:
+    return Transaction(version=0,
+                       nonce=123,
+                       system_fee=456,
+                       network_fee=789,
+                       valid_until_block=1,
+                       attributes=attributes or [],
+                       signers=signers,
+                       script=script,
+                       witnesses=[])
+
+
+def serialize(transaction: Transaction) -> bytes:
+    with serialization.BinaryWriter() as writer:
+        transaction.serialize_unsigned(writer)
+        return writer.to_array()
+
+
+def corpus() -> dict:
+    entry = Signer(account=signer_account, scope=WitnessScope.CALLED_BY_ENTRY)
+    seeds = {}
+
+    # transfers, with the amounts pushed by each encoding of an integer
+    for amount in [0, 11, -1, 100, 1000, 100000, 10**12]:
+        script = transfer(vm.ScriptBuilder(), NeoToken().hash, amount).to_array()
+        seeds[f"neo_transfer_{amount}"] = serialize(tx(script, [entry]))
+    script = transfer(vm.ScriptBuilder(), GasToken().hash, 10**8).to_array()
+    seeds["gas_transfer"] = serialize(tx(script, [entry]))
+    seeds["gas_transfer_high_priority"] = serialize(tx(script, [entry], [HighPriorityAttribute()]))
+
+    # batch of transfers of several tokens
+    sb = vm.ScriptBuilder()
+    for contract, amount in [(GasToken().hash, 1), (NeoToken().hash, 2), (flm_hash, 3), (GasToken().hash, 4)]:
+        transfer(sb, contract, amount)
+    seeds["transfers_batch"] = serialize(tx(sb.to_array(), [entry]))
+
+    # votes
+    sb = vm.ScriptBuilder()
+    sb.emit_contract_call_with_args(NeoToken().hash, "vote", [from_account, candidate])
+    seeds["vote"] = serialize(tx(sb.to_array(), [entry]))
+    sb = vm.ScriptBuilder()
+    sb.emit_contract_call_with_args(NeoToken().hash, "vote", [from_account, None])
+    seeds["vote_retract"] = serialize(tx(sb.to_array(), [entry]))
+
+    # arbitrary script
+    sb = vm.ScriptBuilder()
+    sb.emit_contract_call_with_args(NeoToken().hash, "arbitrary", [])
+    seeds["arbitrary_script"] = serialize(tx(sb.to_array(), [entry]))
+
+    # signers with custom contracts, as test_sign_tx
+    contracts = Signer(account=signer_account, scope=WitnessScope.CUSTOM_CONTRACTS)
+    for i in range(1, 17):
+        contracts.allowed_contracts.append(types.UInt160(20 * i.to_bytes(1, 'little')))
+    both = Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac412345"),
+                  scope=WitnessScope.CUSTOM_CONTRACTS | WitnessScope.CUSTOM_GROUPS)
+    both.allowed_contracts.append(types.UInt160.from_string("5b7074e873973a6ed3708862f219a6fbf4d1c411"))
+    script = transfer(vm.ScriptBuilder(), NeoToken().hash, 11).to_array()
+    seeds["signers_custom_contracts"] = serialize(tx(script, [contracts, both]))
+    global_signer = Signer(account=types.UInt160(from_account), scope=WitnessScope.GLOBAL)
+    seeds["signers_global"] = serialize(tx(script, [entry, global_signer]))
+
+    # signer with custom groups, as test_tx_deserialization.py builds it
+    header = b'\x00' + b'\x00' * 4 + struct.pack("<q", 0) + struct.pack("<q", 0) + b'\x00' * 4
+    groups = bytes([WitnessScope.CUSTOM_GROUPS]) + b'\x02' + b'\x02' * 33 + b'\x03' * 33
+    seeds["signer_custom_groups"] = header + b'\x01' + b'\x00' * 20 + groups + b'\x00' + bytes([len(script)]) + script
+
+    return seeds
+
+
+def main() -> int:
+    output_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), "corpus")
+    os.makedirs(output_dir, exist_ok=True)
+    for name, data in corpus().items():
+        with open(os.path.join(output_dir, name + ".raw"), "wb") as seed:
+            seed.write(data)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,10 +1,24 @@
-  
 #!/usr/bin/env bash
 
 set -e
 
 SCRIPTDIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
 BUILDDIR="$SCRIPTDIR/cmake-build-fuzz"
-CORPUSDIR="$SCRIPTDIR/corpus"
+# fuzz_message (transaction parser) or fuzz_apdu (APDU state machines)
+FUZZER="${FUZZER:-fuzz_message}"
 
-"$BUILDDIR"/fuzz_message "$CORPUSDIR" "$@" > /dev/null
+if [ "$FUZZER" = fuzz_apdu ]; then
+    CORPUSDIR="$SCRIPTDIR/corpus_apdu"
+    # seeded with the sessions of the APDU traces of the unit tests
+    if [ ! -d "$CORPUSDIR" ]; then
+        python3 "$SCRIPTDIR/gen_apdu_corpus.py" "$CORPUSDIR" "$SCRIPTDIR"/../unit-tests/traces/*.jsonl
+    fi
+else
+    CORPUSDIR="$SCRIPTDIR/corpus"
+    # seeded with the transactions of the functional tests, built with their requirements (tests/requirements.txt)
+    if ! ls "$CORPUSDIR"/*.raw > /dev/null 2>&1; then
+        python3 "$SCRIPTDIR/gen_corpus.py" "$CORPUSDIR" || echo "No seed corpus: gen_corpus.py requires neo-mamba"
+    fi
+fi
+
+"$BUILDDIR/$FUZZER" "$CORPUSDIR" "$@" > /dev/null
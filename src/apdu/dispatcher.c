@@ -28,7 +28,30 @@
 #include "handler/get_version.h"
 #include "handler/get_app_name.h"
 #include "handler/get_public_key.h"
+#include "handler/get_public_keys.h"
+#include "handler/get_extended_public_key.h"
 #include "handler/sign_tx.h"
+#include "handler/sign_tx_batch.h"
+#include "handler/get_address.h"
+
+/**
+ * Signature encoding requested by the flags of the first APDU of a signing command.
+ */
+static bool read_sig_format(uint8_t p2, sig_format_e *sig_format) {
+    switch (p2 & (P2_SIG_RS | P2_SIG_INVOCATION)) {
+        case 0:
+            *sig_format = SIG_FORMAT_DER;
+            return true;
+        case P2_SIG_RS:
+            *sig_format = SIG_FORMAT_RS;
+            return true;
+        case P2_SIG_INVOCATION:
+            *sig_format = SIG_FORMAT_INVOCATION;
+            return true;
+        default:
+            return false;
+    }
+}
 
 int apdu_dispatcher(const command_t *cmd) {
     if (cmd->cla != CLA) {
@@ -36,6 +59,7 @@ int apdu_dispatcher(const command_t *cmd) {
     }
 
     buffer_t buf = {0};
+    sig_format_e sig_format = SIG_FORMAT_DER;
 
     switch (cmd->ins) {
         case GET_VERSION:
@@ -51,7 +75,77 @@ int apdu_dispatcher(const command_t *cmd) {
 
             return handler_get_app_name();
         case GET_PUBLIC_KEY:
-            if (cmd->p1 > 0 || cmd->p2 > 1) {
+            if (cmd->p1 > 0 || (cmd->p2 & ~(P2_PUBKEY_DISPLAY | P2_PUBKEY_COMPRESSED)) != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_public_key(&buf, cmd->p2 & P2_PUBKEY_DISPLAY, cmd->p2 & P2_PUBKEY_COMPRESSED);
+        case GET_PUBLIC_KEYS:
+            if (cmd->p1 > P1_KEYS_NEXT || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (cmd->p1 == P1_KEYS_FIRST && !cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_public_keys(&buf, cmd->p1 == P1_KEYS_FIRST);
+        case GET_EXTENDED_PUBLIC_KEY:
+            if (cmd->p1 != 0 || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_extended_public_key(&buf);
+        case SIGN_TX: {
+            // the session flags are only allowed on the first apdu
+            uint8_t flags = (cmd->p1 == P1_START) ? cmd->p2 & (P2_OPEN_SESSION | P2_SIG_RS | P2_SIG_INVOCATION) : 0;
+            bool open_session = (flags & P2_OPEN_SESSION);
+            uint8_t p2_more = cmd->p2 & ~flags;
+
+            if ((cmd->p1 == P1_START && !open_session && p2_more != P2_MORE) ||  // first apdu must be the BIP44 path
+                (p2_more != P2_LAST && p2_more != P2_MORE) ||                    //
+                !read_sig_format(flags, &sig_format)) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_sign_tx(&buf, cmd->p1, (bool) (p2_more & P2_MORE), open_session, sig_format);
+        }
+        case SIGN_TX_BATCH: {
+            uint8_t flags = (cmd->p1 == P1_BATCH_START) ? cmd->p2 & (P2_SIG_RS | P2_SIG_INVOCATION) : 0;
+            uint8_t p2_more = cmd->p2 & ~flags;
+
+            if ((cmd->p1 == P1_BATCH_START && p2_more != P2_LAST) ||  // the batch description is a single apdu
+                cmd->p1 > P1_BATCH_TX ||                              //
+                (p2_more != P2_LAST && p2_more != P2_MORE) ||         //
+                !read_sig_format(flags, &sig_format)) {
                 return io_send_sw(SW_WRONG_P1P2);
             }
 
@@ -63,11 +157,10 @@ int apdu_dispatcher(const command_t *cmd) {
             buf.size = cmd->lc;
             buf.offset = 0;
 
-            return handler_get_public_key(&buf, (bool) cmd->p2);
-        case SIGN_TX:
-            if ((cmd->p1 == P1_START && cmd->p2 != P2_MORE) ||  // first apdu must be the BIP44 path
-                cmd->p1 > P1_MAX ||                             //
-                (cmd->p2 != P2_LAST && cmd->p2 != P2_MORE)) {
+            return handler_sign_tx_batch(&buf, cmd->p1, (bool) (p2_more & P2_MORE), sig_format);
+        }
+        case GET_ADDRESS:
+            if (cmd->p1 != 0 || (cmd->p2 & ~(P2_ADDRESS_SCRIPT_HASH | P2_ADDRESS_PUBKEY)) != 0) {
                 return io_send_sw(SW_WRONG_P1P2);
             }
 
@@ -79,7 +172,7 @@ int apdu_dispatcher(const command_t *cmd) {
             buf.size = cmd->lc;
             buf.offset = 0;
 
-            return handler_sign_tx(&buf, cmd->p1, (bool) (cmd->p2 & P2_MORE));
+            return handler_get_address(&buf, cmd->p2 & P2_ADDRESS_SCRIPT_HASH, cmd->p2 & P2_ADDRESS_PUBKEY);
         default:
             return io_send_sw(SW_INS_NOT_SUPPORTED);
     }
@@ -10,19 +10,65 @@
  * Parameter 2 for more APDU to receive.
  */
 #define P2_MORE 0x80
+/**
+ * Parameter 2 flag for a first SIGN_TX APDU also carrying the network magic and the first transaction bytes.
+ */
+#define P2_OPEN_SESSION 0x01
+/**
+ * Parameter 2 flag for a first SIGN_TX or SIGN_TX_BATCH APDU requesting signatures as r || s.
+ */
+#define P2_SIG_RS 0x02
+/**
+ * Parameter 2 flag for a first SIGN_TX or SIGN_TX_BATCH APDU requesting signatures as invocation scripts.
+ */
+#define P2_SIG_INVOCATION 0x04
 /**
  * Parameter 1 for first APDU number.
+ * First apdu must always be the BIP44 path (P1 chunk 0)
+ * Second apdu must always be the network magic, (P1 chunk 1)
+ * The transaction part follows in as many APDUs as it takes, numbered from P1 chunk 2 up to 0xFF, which the chunks
+ * after it keep: the transaction has no maximum length, only its fields kept for the review must fit
+ * TRANSACTION_STORE_LEN (see transaction_parser_init())
+ * The first apdu may instead carry the BIP44 path, the network magic and the first transaction bytes together
+ * (P2_OPEN_SESSION), the following ones are then numbered from P1 chunk 2 as well
  */
 #define P1_START 0x00
 
 /**
- * Parameter 1 for maximum APDU number.
- * First apdu must always be the BIP44 path (P1 chunk 0)
- * Second apdu must always be the network magic, (P1 chunk 1)
- * The maximum APDU length is 255 bytes. Subtracting the 5 bytes header leaves 250 bytes per APDU of actual data.
- * With MAX_TRANSACTION_LEN set to 1024 we should at most need 5 APDU's to transmit the transaction part (P1 chunk 2..6)
+ * Parameter 1 for the first APDU of GET_PUBLIC_KEYS, with the range of public keys to export.
+ */
+#define P1_KEYS_FIRST 0x00
+/**
+ * Parameter 1 for the following APDUs of GET_PUBLIC_KEYS, each returning the next page of public keys.
+ */
+#define P1_KEYS_NEXT 0x01
+
+/**
+ * Parameter 1 for the first APDU of SIGN_TX_BATCH, with the batch description to approve.
+ */
+#define P1_BATCH_START 0x00
+/**
+ * Parameter 1 for the following APDUs of SIGN_TX_BATCH, each with a part of a transaction of the batch.
+ */
+#define P1_BATCH_TX 0x01
+
+/**
+ * Parameter 2 flag for GET_PUBLIC_KEY to display the address of the public key for approval.
+ */
+#define P2_PUBKEY_DISPLAY 0x01
+/**
+ * Parameter 2 flag for GET_PUBLIC_KEY to return the compressed public key.
+ */
+#define P2_PUBKEY_COMPRESSED 0x02
+
+/**
+ * Parameter 2 flag for GET_ADDRESS to append the script hash of the account to the address.
+ */
+#define P2_ADDRESS_SCRIPT_HASH 0x01
+/**
+ * Parameter 2 flag for GET_ADDRESS to append the uncompressed public key to the address.
  */
-#define P1_MAX 0x06
+#define P2_ADDRESS_PUBKEY 0x02
 
 /**
  * Dispatch APDU command received to the right handler.
@@ -0,0 +1,95 @@
+#ifdef HAVE_APDU_TRACE
+
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // memcpy
+
+#include "os.h"
+
+#include "trace.h"
+#include "common/format.h"
+
+// longest command: header and 255 bytes of data
+#define TRACE_MAX_COMMAND_LEN (5 + 255)
+
+// bytes written as hex at once
+#define TRACE_HEX_CHUNK_LEN 32
+
+static struct {
+    uint8_t command[TRACE_MAX_COMMAND_LEN];  /// last command received
+    size_t command_len;                     /// length of 'command'
+    bool pending;                           /// 'command' waits for its response
+    bool started;                           /// a command was recorded, 'start_us' is set
+    uint64_t start_us;                      /// time of the first command
+    uint64_t command_us;                    /// time of the last command
+} trace;
+
+static void trace_write_hex(const uint8_t *data, size_t len) {
+    char hex[2 * TRACE_HEX_CHUNK_LEN + 1];
+
+    for (size_t offset = 0; offset < len; offset += TRACE_HEX_CHUNK_LEN) {
+        size_t chunk_len = (len - offset < TRACE_HEX_CHUNK_LEN) ? len - offset : TRACE_HEX_CHUNK_LEN;
+        format_hex(data + offset, chunk_len, hex, sizeof(hex));
+        apdu_trace_write(hex);
+    }
+}
+
+static void trace_write_u64(uint64_t value) {
+    char text[21];
+
+    format_u64(text, sizeof(text), value);
+    apdu_trace_write(text);
+}
+
+void apdu_trace_command(const uint8_t *command, size_t command_len) {
+    if (!apdu_trace_enabled()) {
+        return;
+    }
+
+    trace.command_len = (command_len < sizeof(trace.command)) ? command_len : sizeof(trace.command);
+    memcpy(trace.command, command, trace.command_len);
+    trace.pending = true;
+    trace.command_us = apdu_trace_time_us();
+    if (!trace.started) {
+        trace.start_us = trace.command_us;
+        trace.started = true;
+    }
+}
+
+void apdu_trace_response(const uint8_t *response, size_t response_len) {
+    if (!apdu_trace_enabled() || !trace.pending || response_len < 2) {
+        return;
+    }
+
+    uint64_t duration_us = apdu_trace_time_us() - trace.command_us;
+    trace.pending = false;
+
+    apdu_trace_write("{\"command\":\"");
+    trace_write_hex(trace.command, trace.command_len);
+    apdu_trace_write("\",\"response\":\"");
+    trace_write_hex(response, response_len - 2);
+    apdu_trace_write("\",\"sw\":\"");
+    trace_write_hex(response + response_len - 2, 2);
+    apdu_trace_write("\",\"ts_us\":");
+    trace_write_u64(trace.command_us - trace.start_us);
+    apdu_trace_write(",\"duration_us\":");
+    trace_write_u64(duration_us);
+    apdu_trace_write("}\n");
+}
+
+__attribute__((weak)) void apdu_trace_write(const char *text) {
+    // PRINTF is empty without DEBUG
+    (void) text;
+    PRINTF("%s", text);
+}
+
+__attribute__((weak)) uint64_t apdu_trace_time_us(void) {
+    return 0;
+}
+
+__attribute__((weak)) bool apdu_trace_enabled(void) {
+    return true;
+}
+
+#endif  // HAVE_APDU_TRACE
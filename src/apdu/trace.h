@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+/**
+ * Recorder of the APDU exchanges, in the trace format of doc/APDU_TRACE.md: a JSON object per line, e.g.
+ *
+ *   {"command":"80040000148000002C...","response":"046E66A6...","sw":"9000","ts_us":1520,"duration_us":812}
+ *
+ * io.c calls the recorder only when built with HAVE_APDU_TRACE (`make DEBUG=1 APDU_TRACE=1`). The lines are written
+ * piece by piece with apdu_trace_write(): the device prints them (PRINTF) without any timing, a host harness
+ * overrides the weak apdu_trace_write(), apdu_trace_time_us() and apdu_trace_enabled() of trace.c.
+ */
+
+/**
+ * Record command 'command' of length 'command_len' just received.
+ */
+void apdu_trace_command(const uint8_t *command, size_t command_len);
+
+/**
+ * Record response 'response' (RData || SW) of length 'response_len' to the last command, which completes its line.
+ */
+void apdu_trace_response(const uint8_t *response, size_t response_len);
+
+/**
+ * Write the next piece of the trace.
+ */
+void apdu_trace_write(const char *text);
+
+/**
+ * Current time in microseconds, from any origin, or 0 if unknown.
+ */
+uint64_t apdu_trace_time_us(void);
+
+/**
+ * Whether the exchanges are recorded.
+ */
+bool apdu_trace_enabled(void);
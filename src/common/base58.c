@@ -151,4 +151,152 @@ int base58_encode(const uint8_t *in, size_t in_len, char *out, size_t out_len) {
     }
 
     return i;
-}
\ No newline at end of file
+}
+
+/** 58^5, the base of the limbs of base58_encode_address(), fits in 32 bits */
+#define BASE58_R5 656356768U
+
+/** Number of 32 bits words of the address input, whose first word is the version byte alone */
+#define ADDRESS_WORDS 7
+
+/** Number of limbs of 5 base 58 digits needed for the address input: 58^35 > 2^200 */
+#define ADDRESS_LIMBS 7
+
+/**
+ * ADDRESS_ENC_TABLE[i][j] is limb j (most significant first) of 2^(32 * (ADDRESS_WORDS - 1 - i)) in base 58^5.
+ */
+static const uint32_t ADDRESS_ENC_TABLE[ADDRESS_WORDS][ADDRESS_LIMBS] = {
+    {78508U, 646269101U, 118408823U, 91512303U, 209184527U, 413102373U, 153715680U},
+    {0U, 11997U, 486083817U, 3737691U, 294005210U, 247894721U, 289024608U},
+    {0U, 0U, 1833U, 324463681U, 385795061U, 551597588U, 21339008U},
+    {0U, 0U, 0U, 280U, 127692781U, 389432875U, 357132832U},
+    {0U, 0U, 0U, 0U, 42U, 537767569U, 410450016U},
+    {0U, 0U, 0U, 0U, 0U, 6U, 356826688U},
+    {0U, 0U, 0U, 0U, 0U, 0U, 1U},
+};
+
+int base58_encode_address(const uint8_t in[static BASE58_ADDRESS_INPUT_SIZE], char *out, size_t out_len) {
+    uint32_t words[ADDRESS_WORDS];
+    uint64_t limbs[ADDRESS_LIMBS] = {0};
+    uint8_t digits[ADDRESS_LIMBS * 5];
+    size_t zero_count = 0;
+    size_t skip = 0;
+
+    words[0] = in[0];
+    for (size_t i = 1; i < ADDRESS_WORDS; i++) {
+        const uint8_t *p = in + 1 + 4 * (i - 1);
+        words[i] = ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+    }
+
+    // The products are below 2^62 and the first word below 2^8, so each sum stays below 2^64 before the carries
+    for (size_t i = 0; i < ADDRESS_WORDS; i++) {
+        for (size_t j = i; j < ADDRESS_LIMBS; j++) {
+            limbs[j] += (uint64_t) words[i] * ADDRESS_ENC_TABLE[i][j];
+        }
+    }
+    for (size_t j = ADDRESS_LIMBS - 1; j > 0; j--) {
+        limbs[j - 1] += limbs[j] / BASE58_R5;
+        limbs[j] %= BASE58_R5;
+    }
+
+    // Each limb now holds 5 base 58 digits, split with 32 bits divisions only
+    for (size_t j = 0; j < ADDRESS_LIMBS; j++) {
+        uint32_t limb = (uint32_t) limbs[j];
+        for (size_t k = 5; k > 0; k--) {
+            digits[5 * j + k - 1] = limb % 58;
+            limb /= 58;
+        }
+    }
+
+    // Every leading zero byte is encoded as a '1', the leading zero digits of the value are dropped
+    while (zero_count < BASE58_ADDRESS_INPUT_SIZE && in[zero_count] == 0) {
+        ++zero_count;
+    }
+    while (skip < sizeof(digits) && digits[skip] == 0) {
+        ++skip;
+    }
+    if (out_len < zero_count + sizeof(digits) - skip) {
+        return -1;
+    }
+
+    memset(out, BASE58_ALPHABET[0], zero_count);
+    size_t i = zero_count;
+    while (skip < sizeof(digits)) {
+        out[i++] = BASE58_ALPHABET[digits[skip++]];
+    }
+
+    return i;
+}
+
+/** Number of limbs of 5 base 58 digits of an address, whose first limb has 4 digits only */
+#define ADDRESS_DEC_LIMBS 7
+
+/**
+ * ADDRESS_DEC_TABLE[i][j] is word j (most significant first) of 58^(5 * (ADDRESS_DEC_LIMBS - 1 - i)) in base 2^32.
+ */
+static const uint32_t ADDRESS_DEC_TABLE[ADDRESS_DEC_LIMBS][ADDRESS_WORDS] = {
+    {0U, 54706U, 2996985344U, 1834629191U, 3964963911U, 485140318U, 1073741824U},
+    {0U, 0U, 357981U, 1476998812U, 3337178590U, 1483338760U, 4194304000U},
+    {0U, 0U, 0U, 2342503U, 3052466824U, 2595180627U, 17825792U},
+    {0U, 0U, 0U, 0U, 15328518U, 1933902296U, 4063920128U},
+    {0U, 0U, 0U, 0U, 0U, 100304420U, 3355157504U},
+    {0U, 0U, 0U, 0U, 0U, 0U, 656356768U},
+    {0U, 0U, 0U, 0U, 0U, 0U, 1U},
+};
+
+int base58_decode_address(const char *in, size_t in_len, uint8_t out[static BASE58_ADDRESS_INPUT_SIZE]) {
+    uint32_t limbs[ADDRESS_DEC_LIMBS] = {0};
+    uint64_t words[ADDRESS_WORDS] = {0};
+    size_t ones_count = 0;
+    size_t zero_count = 0;
+
+    if (in_len != BASE58_ADDRESS_LEN) {
+        return -1;
+    }
+
+    // Group the digits in limbs of 5, the first limb takes the 4 first digits
+    for (size_t i = 0; i < BASE58_ADDRESS_LEN; i++) {
+        uint8_t c = (uint8_t) in[i];
+        if (c >= sizeof(BASE58_TABLE) || BASE58_TABLE[c] == 0xFF) {
+            return -1;
+        }
+        limbs[(i + 1) / 5] = limbs[(i + 1) / 5] * 58 + BASE58_TABLE[c];
+    }
+
+    // The first limb is below 58^4, so each sum stays below 2^64 before the carries
+    for (size_t i = 0; i < ADDRESS_DEC_LIMBS; i++) {
+        for (size_t j = i; j < ADDRESS_WORDS; j++) {
+            words[j] += (uint64_t) limbs[i] * ADDRESS_DEC_TABLE[i][j];
+        }
+    }
+    for (size_t j = ADDRESS_WORDS - 1; j > 0; j--) {
+        words[j - 1] += words[j] >> 32;
+        words[j] &= 0xFFFFFFFF;
+    }
+
+    // The value must fit in BASE58_ADDRESS_INPUT_SIZE bytes, the first word holding the first byte only
+    if (words[0] > 0xFF) {
+        return -1;
+    }
+    out[0] = (uint8_t) words[0];
+    for (size_t i = 1; i < ADDRESS_WORDS; i++) {
+        uint8_t *p = out + 1 + 4 * (i - 1);
+        p[0] = (uint8_t) (words[i] >> 24);
+        p[1] = (uint8_t) (words[i] >> 16);
+        p[2] = (uint8_t) (words[i] >> 8);
+        p[3] = (uint8_t) words[i];
+    }
+
+    // Every leading '1' stands for a leading zero byte, and the other way around
+    while (ones_count < in_len && in[ones_count] == BASE58_ALPHABET[0]) {
+        ++ones_count;
+    }
+    while (zero_count < BASE58_ADDRESS_INPUT_SIZE && out[zero_count] == 0) {
+        ++zero_count;
+    }
+    if (ones_count != zero_count) {
+        return -1;
+    }
+
+    return BASE58_ADDRESS_INPUT_SIZE;
+}
@@ -12,6 +12,18 @@
  * Maximum length of input when encoding in base 58.
  */
 #define MAX_ENC_INPUT_SIZE 120
+/**
+ * Length of a NEO address before encoding in base 58: version (1) || script hash (20) || checksum (4).
+ */
+#define BASE58_ADDRESS_INPUT_SIZE 25
+/**
+ * Maximum length of BASE58_ADDRESS_INPUT_SIZE bytes once encoded in base 58.
+ */
+#define BASE58_ADDRESS_MAX_SIZE 35
+/**
+ * Length of a NEO N3 address (version 0x35) encoded in base 58.
+ */
+#define BASE58_ADDRESS_LEN 34
 
 /**
  * Decode input string in base 58.
@@ -49,4 +61,37 @@ int base58_decode(const char *in, size_t in_len, uint8_t *out, size_t out_len);
  * @return number of bytes encoded, -1 otherwise.
  *
  */
-int base58_encode(const uint8_t *in, size_t in_len, char *out, size_t out_len);
\ No newline at end of file
+int base58_encode(const uint8_t *in, size_t in_len, char *out, size_t out_len);
+
+/**
+ * Encode a NEO address (version, script hash and checksum) in base 58.
+ * Same output as base58_encode() on BASE58_ADDRESS_INPUT_SIZE bytes, computed in limbs of 5 base 58 digits
+ * instead of one digit at a time.
+ *
+ * @param[in]  in
+ *   Pointer to input byte buffer of BASE58_ADDRESS_INPUT_SIZE bytes.
+ * @param[out] out
+ *   Pointer to output string buffer.
+ * @param[in]  out_len
+ *   Maximum length to write in output byte buffer.
+ *
+ * @return number of bytes encoded, -1 otherwise.
+ *
+ */
+int base58_encode_address(const uint8_t in[static BASE58_ADDRESS_INPUT_SIZE], char *out, size_t out_len);
+
+/**
+ * Decode a NEO N3 address in base 58 to its version, script hash and checksum, without checking them.
+ * Same output as base58_decode() for such addresses, computed in limbs of 5 base 58 digits.
+ *
+ * @param[in]  in
+ *   Pointer to input string buffer.
+ * @param[in]  in_len
+ *   Length of the input string buffer, must be BASE58_ADDRESS_LEN.
+ * @param[out] out
+ *   Pointer to output byte buffer of BASE58_ADDRESS_INPUT_SIZE bytes.
+ *
+ * @return number of bytes decoded, -1 otherwise.
+ *
+ */
+int base58_decode_address(const char *in, size_t in_len, uint8_t out[static BASE58_ADDRESS_INPUT_SIZE]);
@@ -16,4 +16,16 @@
  * @return false if failed to parse a BIP44 path or any validation fails.
  */
 
-bool buffer_read_and_validate_bip44(buffer_t *in, uint32_t *bip44path_out, uint16_t *status_out);
\ No newline at end of file
+bool buffer_read_and_validate_bip44(buffer_t *in, uint32_t *bip44path_out, uint16_t *status_out);
+
+/**
+ * @brief Parse the account level of a BIP44 path (m / purpose' / coin_type' / account') from buffer and perform
+ * the same validations as buffer_read_and_validate_bip44() on these levels
+ *
+ * @param in
+ * @param bip44path_out array where the BIP44_ACCOUNT_PATH_LEN path numbers will be stored
+ * @param status_out a status word indicating the failure reason
+ * @return true if an account path is successfully parsed and passes all validations
+ * @return false if failed to parse an account path or any validation fails.
+ */
+bool buffer_read_and_validate_bip44_account(buffer_t *in, uint32_t *bip44path_out, uint16_t *status_out);
@@ -16,7 +16,7 @@
 
 #include <stddef.h>   // size_t
 #include <stdint.h>   // int*_t, uint*_t
-#include <string.h>   // strncpy, memcpy
+#include <string.h>   // strncpy, memcpy, memset, strlen
 #include <stdbool.h>  // bool
 
 #include "format.h"
@@ -133,29 +133,153 @@ bool format_fpu64(char *dst, size_t dst_len, const uint64_t value, uint8_t decim
     return true;
 }
 
-int format_hex(const uint8_t *in, size_t in_len, char *out, size_t out_len) {
-    if (out_len < 2 * in_len + 1) {
-        return -1;
+/**
+ * Decimal digits of 0 to 99, two by two.
+ */
+static const char DIGIT_PAIRS[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * Write the 'count' last decimal digits of 'value' with leading zeros, 'count' being even.
+ */
+static void format_u32_digits(char *out, uint32_t value, uint8_t count) {
+    while (count > 0) {
+        count -= 2;
+        memcpy(out + count, &DIGIT_PAIRS[2 * (value % 100)], 2);
+        value /= 100;
     }
+}
 
-    const char hex[] = "0123456789ABCDEF";
-    size_t i = 0;
-    int written = 0;
+#define AMOUNT_DIGITS 20  // decimal digits of UINT64_MAX
+#define AMOUNT_SPLIT  100000000u
 
-    while (i < in_len && (i * 2 + (2 + 1)) <= out_len) {
-        uint8_t high_nibble = (in[i] & 0xF0) >> 4;
-        *out = hex[high_nibble];
-        out++;
+/**
+ * Decimal 'index' of an amount, from its 'digits' ('start' being the first significant one) or a leading zero.
+ */
+static char amount_decimal(const char *digits, size_t start, uint8_t decimals, size_t index) {
+    size_t position = AMOUNT_DIGITS + index;
+    return (position < start + decimals) ? '0' : digits[position - decimals];
+}
 
-        uint8_t low_nibble = in[i] & 0x0F;
-        *out = hex[low_nibble];
-        out++;
+bool format_amount(char *dst,
+                   size_t dst_len,
+                   const char *ticker,
+                   uint64_t value,
+                   uint8_t decimals,
+                   bool trim_zeros) {
+    char digits[AMOUNT_DIGITS];
+
+    // Split in 32-bit parts of 8 digits, the high one is only needed past 10^16
+    uint64_t high = value / AMOUNT_SPLIT;
+    format_u32_digits(digits + 12, (uint32_t) (value - high * AMOUNT_SPLIT), 8);
+    if (high < AMOUNT_SPLIT) {
+        format_u32_digits(digits + 4, (uint32_t) high, 8);
+        memset(digits, '0', 4);
+    } else {
+        uint32_t top = (uint32_t) (high / AMOUNT_SPLIT);
+        format_u32_digits(digits + 4, (uint32_t) (high - (uint64_t) top * AMOUNT_SPLIT), 8);
+        format_u32_digits(digits, top, 4);
+    }
 
-        i++;
-        written += 2;
+    // first significant digit, keeping a single 0 for value 0
+    size_t start = 0;
+    while (start < AMOUNT_DIGITS - 1 && digits[start] == '0') {
+        start++;
+    }
+
+    // a single 0 before the separator when all digits are decimals, a single 0 after it without decimals
+    bool has_integer = AMOUNT_DIGITS - start > decimals;
+    size_t integer_len = has_integer ? AMOUNT_DIGITS - start - decimals : 1;
+    size_t fraction_len = (decimals == 0) ? 1 : decimals;
+    if (trim_zeros && decimals > 0) {
+        while (fraction_len > 1 && amount_decimal(digits, start, decimals, fraction_len - 1) == '0') {
+            fraction_len--;
+        }
+    }
+
+    size_t ticker_len = (ticker == NULL) ? 0 : strlen(ticker) + 1;
+    if (dst_len <= ticker_len + integer_len + 1 + fraction_len) {
+        return false;
+    }
+
+    if (ticker != NULL) {
+        memcpy(dst, ticker, ticker_len - 1);
+        dst[ticker_len - 1] = ' ';
+        dst += ticker_len;
+    }
+    if (has_integer) {
+        memcpy(dst, digits + start, integer_len);
+    } else {
+        *dst = '0';
     }
+    dst += integer_len;
+    *dst++ = '.';
+    if (decimals == 0) {
+        *dst++ = '0';
+    } else {
+        for (size_t i = 0; i < fraction_len; i++) {
+            *dst++ = amount_decimal(digits, start, decimals, i);
+        }
+    }
+    *dst = '\0';
 
+    return true;
+}
+
+/**
+ * Uppercase hexadecimal digits of 0x00 to 0xFF, two by two.
+ */
+static const char HEX_PAIRS[512] =
+    "000102030405060708090A0B0C0D0E0F"
+    "101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F"
+    "303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F"
+    "505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F"
+    "707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F"
+    "909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+    "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+    "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+    "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+int format_hex(const uint8_t *in, size_t in_len, char *out, size_t out_len) {
+    return format_hex_grouped(in, in_len, 0, out, out_len);
+}
+
+int format_hex_grouped(const uint8_t *in, size_t in_len, size_t group_len, char *out, size_t out_len) {
+    size_t spaces = (group_len == 0 || in_len == 0) ? 0 : (in_len - 1) / group_len;
+    if (out_len < 2 * in_len + spaces + 1) {
+        return -1;
+    }
+
+    char *start = out;
+    const uint8_t *end = in + in_len;
+    while (in < end) {
+        // a group at a time, the last one possibly shorter
+        const uint8_t *group_end = (spaces == 0 || (size_t) (end - in) <= group_len) ? end : in + group_len;
+        while (in < group_end) {
+            memcpy(out, &HEX_PAIRS[2 * *in++], 2);
+            out += 2;
+        }
+        if (in < end) {
+            *out++ = ' ';
+        }
+    }
     *out = '\0';
 
-    return written + 1;
+    return (int) (out - start) + 1;
 }
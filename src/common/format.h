@@ -51,6 +51,35 @@ bool format_u64(char *dst, size_t dst_len, uint64_t value);
  */
 bool format_fpu64(char *dst, size_t dst_len, const uint64_t value, uint8_t decimals);
 
+/**
+ * Format 64-bit unsigned integer as string with decimals, preceded by a ticker.
+ *
+ * Same output as format_fpu64() after the ticker and a space, but the digits are produced two at a time from a
+ * lookup table, on 32-bit halves split once by 10^8, and written straight to the output.
+ *
+ * @param[out] dst
+ *   Pointer to output string.
+ * @param[in]  dst_len
+ *   Length of output string.
+ * @param[in]  ticker
+ *   Ticker written before the amount, or NULL for none.
+ * @param[in]  value
+ *   64-bit unsigned integer to format.
+ * @param[in]  decimals
+ *   Number of digits after decimal separator.
+ * @param[in]  trim_zeros
+ *   Drop the trailing zeros of the decimals, keeping at least one digit after the separator.
+ *
+ * @return true if success, false otherwise.
+ *
+ */
+bool format_amount(char *dst,
+                   size_t dst_len,
+                   const char *ticker,
+                   uint64_t value,
+                   uint8_t decimals,
+                   bool trim_zeros);
+
 /**
  * Format byte buffer to uppercase hexadecimal string.
  *
@@ -67,3 +96,25 @@ bool format_fpu64(char *dst, size_t dst_len, const uint64_t value, uint8_t decim
  *
  */
 int format_hex(const uint8_t *in, size_t in_len, char *out, size_t out_len);
+
+/**
+ * Format byte buffer to uppercase hexadecimal string, with a space between groups of bytes.
+ *
+ * Meant to write straight into the buffers of the review items: two characters are copied per byte from a lookup
+ * table and the output isn't written at all when it doesn't fit.
+ *
+ * @param[in]  in
+ *   Pointer to input byte buffer.
+ * @param[in]  in_len
+ *   Length of input byte buffer.
+ * @param[in]  group_len
+ *   Number of bytes between spaces, 0 for no space.
+ * @param[out] out
+ *   Pointer to output string.
+ * @param[in]  out_len
+ *   Length of output string.
+ *
+ * @return number of bytes written if success, -1 otherwise.
+ *
+ */
+int format_hex_grouped(const uint8_t *in, size_t in_len, size_t group_len, char *out, size_t out_len);
@@ -0,0 +1,52 @@
+#include <stddef.h>  // size_t
+#include <string.h>  // memcmp, memcpy, memmove, memset
+
+#include "pubkey_cache.h"
+
+typedef struct {
+    uint32_t bip44_path[BIP44_PATH_LEN];
+    uint8_t raw_public_key[64];
+    uint8_t script_hash[UINT160_LEN];
+} pubkey_cache_entry_t;
+
+// entries from the most to the least recently used
+static pubkey_cache_entry_t G_pubkey_cache[PUBKEY_CACHE_SIZE];
+static uint8_t G_pubkey_cache_size;
+
+bool pubkey_cache_get(const uint32_t *bip44_path, uint8_t raw_public_key[static 64], uint8_t *script_hash) {
+    for (uint8_t i = 0; i < G_pubkey_cache_size; i++) {
+        if (memcmp(G_pubkey_cache[i].bip44_path, bip44_path, sizeof(G_pubkey_cache[i].bip44_path)) != 0) {
+            continue;
+        }
+
+        pubkey_cache_entry_t entry = G_pubkey_cache[i];
+        memmove(&G_pubkey_cache[1], &G_pubkey_cache[0], i * sizeof(pubkey_cache_entry_t));
+        G_pubkey_cache[0] = entry;
+
+        memcpy(raw_public_key, entry.raw_public_key, sizeof(entry.raw_public_key));
+        if (script_hash != NULL) {
+            memcpy(script_hash, entry.script_hash, sizeof(entry.script_hash));
+        }
+        return true;
+    }
+    return false;
+}
+
+void pubkey_cache_put(const uint32_t *bip44_path,
+                      const uint8_t raw_public_key[static 64],
+                      const uint8_t script_hash[static UINT160_LEN]) {
+    if (G_pubkey_cache_size < PUBKEY_CACHE_SIZE) {
+        G_pubkey_cache_size++;
+    }
+    // the least recently used entry falls off the end
+    memmove(&G_pubkey_cache[1], &G_pubkey_cache[0], (G_pubkey_cache_size - 1) * sizeof(pubkey_cache_entry_t));
+
+    memcpy(G_pubkey_cache[0].bip44_path, bip44_path, sizeof(G_pubkey_cache[0].bip44_path));
+    memcpy(G_pubkey_cache[0].raw_public_key, raw_public_key, sizeof(G_pubkey_cache[0].raw_public_key));
+    memcpy(G_pubkey_cache[0].script_hash, script_hash, sizeof(G_pubkey_cache[0].script_hash));
+}
+
+void pubkey_cache_flush(void) {
+    memset(G_pubkey_cache, 0, sizeof(G_pubkey_cache));
+    G_pubkey_cache_size = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "constants.h"
+#include "transaction/transaction_types.h"
+
+/**
+ * Look up the public key of a BIP44 path among the recently derived ones, making it the most recently used.
+ *
+ * @param[in]  bip44_path
+ *   BIP44 path of BIP44_PATH_LEN levels.
+ * @param[out] raw_public_key
+ *   Pointer to 64 bytes buffer receiving the raw public key (x || y).
+ * @param[out] script_hash
+ *   Pointer to buffer receiving the script hash of the account of the public key, or NULL if not needed.
+ *
+ * @return true if the public key is cached, false otherwise.
+ */
+bool pubkey_cache_get(const uint32_t *bip44_path, uint8_t raw_public_key[static 64], uint8_t *script_hash);
+
+/**
+ * Cache the public key of a BIP44 path, replacing the least recently used entry when full.
+ *
+ * @param[in] bip44_path
+ *   BIP44 path of BIP44_PATH_LEN levels.
+ * @param[in] raw_public_key
+ *   Raw public key (x || y) derived from the path.
+ * @param[in] script_hash
+ *   Script hash of the account of the public key.
+ */
+void pubkey_cache_put(const uint32_t *bip44_path,
+                      const uint8_t raw_public_key[static 64],
+                      const uint8_t script_hash[static UINT160_LEN]);
+
+/**
+ * Forget every cached public key, e.g. once the device is locked.
+ */
+void pubkey_cache_flush(void);
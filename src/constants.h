@@ -21,15 +21,26 @@
 #define MAX_APPNAME_LEN 64
 
 /**
- * Maximum transaction length (bytes).
+ * Size of the store of the transaction fields the review refers to: signer accounts, allowed contracts and groups,
+ * script (bytes). The transaction itself has no maximum length.
  */
-#define MAX_TRANSACTION_LEN 1024
+#define TRANSACTION_STORE_LEN 1024
 
 /**
  * Maximum signature length (bytes).
  */
 #define MAX_DER_SIG_LEN 72
 
+/**
+ * Length of a signature as r || s, each left padded to 32 bytes.
+ */
+#define SIG_RS_LEN 64
+
+/**
+ * Length of the invocation script of a single signature: PUSHDATA1 64 r || s.
+ */
+#define INVOCATION_SCRIPT_LEN (2 + SIG_RS_LEN)
+
 /**
  * Exponent used to convert mBOL to BOL unit (N BOL = N * 10^3 mBOL).
  */
@@ -44,6 +55,21 @@
 /** Length of BIP44 path, in bytes */
 #define BIP44_BYTE_LENGTH (BIP44_PATH_LEN * sizeof(unsigned int))
 
+/**
+ * Length of the account level of a BIP44 path
+ * m / purpose' / coin_type' / account'
+ * */
+#define BIP44_ACCOUNT_PATH_LEN 3
+
+/** Length of the account level of a BIP44 path, in bytes */
+#define BIP44_ACCOUNT_BYTE_LENGTH (BIP44_ACCOUNT_PATH_LEN * sizeof(unsigned int))
+
+/** Length of a BIP32 chain code */
+#define CHAIN_CODE_LEN 32
+
+/** Upper bound (excluded) of the BIP44 address index */
+#define BIP44_MAX_ADDRESS_INDEX 5000
+
 /**
  * Coin type 888 as described in
  * https://github.com/satoshilabs/slips/blob/master/slip-0044.md
@@ -53,6 +79,31 @@
 /** BIP44 purpose 44' */
 #define BIP44_PURPOSE 0x8000002C
 
+/**
+ * Maximum number of public keys exported by a single GET_PUBLIC_KEYS command.
+ */
+#define MAX_PUBLIC_KEYS_COUNT 100
+
+/**
+ * Number of uncompressed public keys fitting in one GET_PUBLIC_KEYS response, after the count byte.
+ */
+#define PUBLIC_KEYS_PER_PAGE 3
+
+/**
+ * Number of recently derived public keys kept in RAM, see common/pubkey_cache.h.
+ */
+#define PUBKEY_CACHE_SIZE 4
+
+/**
+ * Maximum number of tokens a batch of transactions may transfer.
+ */
+#define MAX_BATCH_TOKENS 4
+
+/**
+ * Maximum number of destination accounts of a batch of transactions.
+ */
+#define MAX_BATCH_DESTINATIONS 8
+
 /** NEO Main network magic */
 #define NETWORK_MAINNET 860833102
 
@@ -23,8 +23,13 @@
 
 #include "globals.h"
 #include "sw.h"
+#include "common/pubkey_cache.h"
+#include "ui/utils.h"
 
-int crypto_derive_private_key(cx_ecfp_private_key_t *private_key, const uint32_t *bip32_path, uint8_t bip32_path_len) {
+int crypto_derive_private_key(cx_ecfp_private_key_t *private_key,
+                              uint8_t *chain_code,
+                              const uint32_t *bip32_path,
+                              uint8_t bip32_path_len) {
     cx_err_t error = CX_OK;
     uint8_t raw_private_key[64] = {0};
 
@@ -33,7 +38,7 @@ int crypto_derive_private_key(cx_ecfp_private_key_t *private_key, const uint32_t
                                                 bip32_path,
                                                 bip32_path_len,
                                                 raw_private_key,
-                                                NULL,
+                                                chain_code,
                                                 NULL,
                                                 0));
 
@@ -68,26 +73,53 @@ end:
     return 0;
 }
 
+int crypto_get_public_key(const uint32_t *bip44_path, uint8_t raw_public_key[static 64], uint8_t *script_hash) {
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+    uint8_t account_script_hash[UINT160_LEN];
+
+    if (pubkey_cache_get(bip44_path, raw_public_key, script_hash)) {
+        return 0;
+    }
+
+    int error = crypto_derive_private_key(&private_key, NULL, bip44_path, BIP44_PATH_LEN);
+    if (error == 0) {
+        error = crypto_init_public_key(&private_key, &public_key, raw_public_key);
+    }
+    explicit_bzero(&private_key, sizeof(private_key));
+    if (error != 0 || !script_hash_from_pubkey(raw_public_key, account_script_hash)) {
+        return -1;
+    }
+
+    pubkey_cache_put(bip44_path, raw_public_key, account_script_hash);
+    if (script_hash != NULL) {
+        memcpy(script_hash, account_script_hash, sizeof(account_script_hash));
+    }
+    return 0;
+}
+
 int crypto_sign_tx() {
     size_t sig_len = sizeof(G_context.tx_info.signature);
     cx_err_t error = CX_OK;
 
     // derive private key according to BIP44 path
     cx_ecfp_private_key_t private_key = {0};
-    crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+    crypto_derive_private_key(&private_key, NULL, G_context.bip44_path, BIP44_PATH_LEN);
 
     // The data we need to hash is the network magic (uint32_t) + sha256(signed data portion of TX)
     // the latter is stored in tx_info.hash
-    memcpy(G_context.tx_info.raw_tx, (void *) &G_context.network_magic, 4);
-    memcpy(G_context.tx_info.raw_tx + 4, G_context.tx_info.hash, 32);
-
-    // Hash the data before signing
     cx_sha256_t msg_hash;
     cx_sha256_init(&msg_hash);
+    CX_CHECK(cx_hash_no_throw((cx_hash_t *) &msg_hash,
+                              0 /*mode*/,
+                              (uint8_t *) &G_context.network_magic /* data in */,
+                              sizeof(G_context.network_magic) /* data in len */,
+                              NULL /* hash out*/,
+                              0 /* hash out len */));
     CX_CHECK(cx_hash_no_throw((cx_hash_t *) &msg_hash,
                               CX_LAST /*mode*/,
-                              G_context.tx_info.raw_tx /* data in */,
-                              sizeof(G_context.network_magic) + sizeof(G_context.tx_info.hash) /* data in len */,
+                              G_context.tx_info.hash /* data in */,
+                              sizeof(G_context.tx_info.hash) /* data in len */,
                               G_context.tx_info.hash /* hash out*/,
                               sizeof(G_context.tx_info.hash) /* hash out len */));
 
@@ -113,3 +145,32 @@ end:
 
     return 0;
 }
+
+/**
+ * Copy a big endian integer of the DER signature to a 32 bytes field, without its leading zeros.
+ */
+static bool copy_sig_integer(const uint8_t *value, size_t len, uint8_t out[static 32]) {
+    while (len > 0 && *value == 0) {
+        value++;
+        len--;
+    }
+    if (len > 32) {
+        return false;
+    }
+    memset(out, 0, 32 - len);
+    memcpy(out + 32 - len, value, len);
+    return true;
+}
+
+int crypto_sig_to_rs(const uint8_t *der, size_t der_len, uint8_t rs[static 64]) {
+    const uint8_t *r = NULL;
+    const uint8_t *s = NULL;
+    size_t r_len = 0;
+    size_t s_len = 0;
+
+    if (cx_ecfp_decode_sig_der(der, der_len, 33, &r, &r_len, &s, &s_len) != 1 ||
+        !copy_sig_integer(r, r_len, rs) || !copy_sig_integer(s, s_len, rs + 32)) {
+        return -1;
+    }
+    return 0;
+}
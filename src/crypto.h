@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>  // size_t
 #include <stdint.h>  // uint*_t
 
 #include "os.h"
@@ -10,6 +11,8 @@
  *
  * @param[out] private_key
  *   Pointer to private key.
+ * @param[out] chain_code
+ *   Pointer to 32 bytes buffer receiving the chain code, or NULL if not needed.
  * @param[in]  bip32_path
  *   Pointer to buffer with BIP32 path.
  * @param[in]  bip32_path_len
@@ -20,7 +23,10 @@
  * @throw INVALID_PARAMETER
  *
  */
-int crypto_derive_private_key(cx_ecfp_private_key_t *private_key, const uint32_t *bip32_path, uint8_t bip32_path_len);
+int crypto_derive_private_key(cx_ecfp_private_key_t *private_key,
+                              uint8_t *chain_code,
+                              const uint32_t *bip32_path,
+                              uint8_t bip32_path_len);
 
 /**
  * Initialize public key given private key.
@@ -41,6 +47,22 @@ int crypto_init_public_key(cx_ecfp_private_key_t *private_key,
                            cx_ecfp_public_key_t *public_key,
                            uint8_t raw_public_key[static 64]);
 
+/**
+ * Get the public key of a BIP44 path, and the script hash of its account. The public keys derived recently
+ * are kept in a cache, so that the requests following each other on the same path derive it only once.
+ *
+ * @param[in]  bip44_path
+ *   BIP44 path of BIP44_PATH_LEN levels.
+ * @param[out] raw_public_key
+ *   Pointer to 64 bytes buffer receiving the raw public key (x || y).
+ * @param[out] script_hash
+ *   Pointer to 20 bytes buffer receiving the script hash of the account, or NULL if not needed.
+ *
+ * @return 0 if success, -1 otherwise.
+ *
+ */
+int crypto_get_public_key(const uint32_t *bip44_path, uint8_t raw_public_key[static 64], uint8_t *script_hash);
+
 /**
  * Sign network magic + message hash in global context.
  *
@@ -52,4 +74,19 @@ int crypto_init_public_key(cx_ecfp_private_key_t *private_key,
  * @throw INVALID_PARAMETER
  *
  */
-int crypto_sign_tx(void);
\ No newline at end of file
+int crypto_sign_tx(void);
+
+/**
+ * Convert an ASN1.DER encoded signature to r || s, each left padded to 32 bytes.
+ *
+ * @param[in]  der
+ *   Pointer to the DER encoded signature, as returned by cx_ecdsa_sign_no_throw().
+ * @param[in]  der_len
+ *   Length of the DER encoded signature.
+ * @param[out] rs
+ *   Pointer to 64 bytes buffer receiving r || s.
+ *
+ * @return 0 if success, -1 otherwise.
+ *
+ */
+int crypto_sig_to_rs(const uint8_t *der, size_t der_len, uint8_t rs[static 64]);
\ No newline at end of file
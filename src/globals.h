@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "ux.h"
+#include "cx.h"
 
 #include "io.h"
 #include "types.h"
@@ -37,3 +38,14 @@ extern io_state_e G_io_state;
  * Global context for user requests.
  */
 extern global_ctx_t G_context;
+
+/**
+ * Running hash of the signed data portion of the transaction being received by SIGN_TX, which is never held whole:
+ * it may be of any length.
+ */
+extern cx_sha256_t G_tx_hash;
+
+/**
+ * Running hash of the script of the transaction being received by SIGN_TX.
+ */
+extern cx_sha256_t G_script_hash;
@@ -0,0 +1,73 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <string.h>   // memcpy, explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "get_address.h"
+#include "globals.h"
+#include "types.h"
+#include "io.h"
+#include "sw.h"
+#include "crypto.h"
+#include "common/buffer.h"
+#include "common/bip44.h"
+#include "helper/send_response.h"
+#include "ui/utils.h"
+
+int handler_get_address(buffer_t *cdata, bool with_script_hash, bool with_public_key) {
+    explicit_bzero(&G_context, sizeof(G_context));
+    G_context.req_type = CONFIRM_ADDRESS;
+    G_context.state = STATE_NONE;
+
+    uint16_t status;
+    if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) return io_send_sw(status);
+
+    // Response: address (34) || script hash (20, optional) || uncompressed public key (65, optional)
+    uint8_t resp[ADDRESS_LEN + UINT160_LEN + 1 + PUBKEY_LEN] = {0};
+    uint8_t script_hash[UINT160_LEN] = {0};
+    char address[ADDRESS_LEN + 1];
+    size_t offset = 0;
+
+    // Derive public key according to BIP44 path, unless it was recently
+    if (crypto_get_public_key(G_context.bip44_path, G_context.raw_public_key, script_hash) < 0) {
+        return io_send_sw(SW_CONVERT_TO_ADDRESS_FAIL);
+    }
+    if (!script_hash_to_address(address, sizeof(address), script_hash)) {
+        return io_send_sw(SW_CONVERT_TO_ADDRESS_FAIL);
+    }
+    memcpy(resp, address, ADDRESS_LEN);  // without the '\0'
+    offset += ADDRESS_LEN;
+
+    if (with_script_hash) {
+        memcpy(resp + offset, script_hash, UINT160_LEN);
+        offset += UINT160_LEN;
+    }
+    if (with_public_key) {
+        resp[offset++] = 0x04;
+        memcpy(resp + offset, G_context.raw_public_key, PUBKEY_LEN);
+        offset += PUBKEY_LEN;
+    }
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = offset, .offset = 0}, SW_OK);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+#include <stdint.h>   // uint*_t
+
+#include "types.h"
+#include "common/buffer.h"
+
+/**
+ * Handler for GET_ADDRESS command. If the BIP44 path is parsed successfully, derive
+ * the public key and send the base58check encoded address of its standard account
+ * in the APDU response, so that the host doesn't have to build it from the public key.
+ *
+ * @see G_context.bip44_path, G_context.raw_public_key
+ *
+ * @param[in,out] cdata
+ *   Command data with BIP44 path.
+ * @param[in]     with_script_hash
+ *   Whether the script hash of the account follows the address in the response.
+ * @param[in]     with_public_key
+ *   Whether the uncompressed public key follows the address (and script hash) in the response.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_address(buffer_t *cdata, bool with_script_hash, bool with_public_key);
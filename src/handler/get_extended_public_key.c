@@ -0,0 +1,66 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <string.h>   // memset, explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "get_extended_public_key.h"
+#include "globals.h"
+#include "types.h"
+#include "io.h"
+#include "sw.h"
+#include "crypto.h"
+#include "common/buffer.h"
+#include "common/bip44.h"
+#include "helper/send_response.h"
+
+int handler_get_extended_public_key(buffer_t *cdata) {
+    explicit_bzero(&G_context, sizeof(G_context));
+    G_context.state = STATE_NONE;
+
+    uint16_t status;
+    if (!buffer_read_and_validate_bip44_account(cdata, G_context.bip44_path, &status)) return io_send_sw(status);
+
+    // Response: uncompressed public key (65) || chain code (32)
+    uint8_t resp[1 + PUBKEY_LEN + CHAIN_CODE_LEN] = {0};
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+
+    // Derive private key and chain code according to the account path
+    int error = crypto_derive_private_key(&private_key,
+                                          resp + 1 + PUBKEY_LEN,
+                                          G_context.bip44_path,
+                                          BIP44_ACCOUNT_PATH_LEN);
+    // Generate corresponding public key
+    if (error == 0) {
+        error = crypto_init_public_key(&private_key, &public_key, resp + 1);
+    }
+    // Clear private key
+    explicit_bzero(&private_key, sizeof(private_key));
+    if (error != 0) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    resp[0] = 0x04;
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = sizeof(resp), .offset = 0}, SW_OK);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+#include <stdint.h>   // uint*_t
+
+#include "types.h"
+#include "common/buffer.h"
+
+/**
+ * Handler for GET_EXTENDED_PUBLIC_KEY command. If the account level of the BIP44 path
+ * (m/44'/888'/account') is parsed successfully, derive the public key and chain code of
+ * the account and send APDU response, so that the host can derive the non-hardened change
+ * and address index levels itself.
+ *
+ * @see G_context.bip44_path
+ *
+ * @param[in,out] cdata
+ *   Command data with the account level of the BIP44 path.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_extended_public_key(buffer_t *cdata);
@@ -35,23 +35,19 @@
 #include "helper/send_response.h"
 #include "ui_get_public_key.h"
 
-int handler_get_public_key(buffer_t *cdata, bool show_on_screen) {
+int handler_get_public_key(buffer_t *cdata, bool show_on_screen, bool compressed) {
     explicit_bzero(&G_context, sizeof(G_context));
     G_context.req_type = CONFIRM_ADDRESS;
     G_context.state = STATE_NONE;
+    G_context.compressed_public_key = compressed;
 
     uint16_t status;
     if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) return io_send_sw(status);
 
-    cx_ecfp_private_key_t private_key = {0};
-    cx_ecfp_public_key_t public_key = {0};
-
-    // Derive private key according to BIP44 path
-    crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
-    // Generate corresponding public key
-    crypto_init_public_key(&private_key, &public_key, G_context.raw_public_key);
-    // Clear private key
-    explicit_bzero(&private_key, sizeof(private_key));
+    // Derive public key according to BIP44 path, unless it was recently
+    if (crypto_get_public_key(G_context.bip44_path, G_context.raw_public_key, NULL) < 0) {
+        return io_send_sw(SW_BAD_STATE);
+    }
 
     if (show_on_screen) {
         return ui_display_address();
@@ -17,8 +17,10 @@
  *   Command data with BIP44 path.
  * @param[in]     show_on_screen
  *   Whether to display address on screen or not.
+ * @param[in]     compressed
+ *   Whether to send the compressed public key (33 bytes) instead of the uncompressed one (65 bytes).
  *
  * @return zero or positive integer if success, negative integer otherwise.
  *
  */
-int handler_get_public_key(buffer_t *cdata, bool show_on_screen);
+int handler_get_public_key(buffer_t *cdata, bool show_on_screen, bool compressed);
@@ -0,0 +1,111 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <string.h>   // memset, explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "get_public_keys.h"
+#include "globals.h"
+#include "types.h"
+#include "io.h"
+#include "sw.h"
+#include "crypto.h"
+#include "common/buffer.h"
+#include "common/bip44.h"
+#include "helper/send_response.h"
+
+/**
+ * Derive the next page of public keys and send it.
+ * Response: count (1) || uncompressed public key (65) * count
+ */
+static int send_public_keys_page(void) {
+    uint8_t resp[1 + PUBLIC_KEYS_PER_PAGE * (1 + PUBKEY_LEN)] = {0};
+    size_t offset = 1;
+    uint8_t count = G_context.pubkeys.remaining;
+
+    if (count > PUBLIC_KEYS_PER_PAGE) {
+        count = PUBLIC_KEYS_PER_PAGE;
+    }
+
+    resp[0] = count;
+    for (uint8_t i = 0; i < count; i++) {
+        cx_ecfp_private_key_t private_key = {0};
+        cx_ecfp_public_key_t public_key = {0};
+
+        G_context.bip44_path[BIP44_PATH_LEN - 1] = G_context.pubkeys.next_index++;
+
+        // Derive private key according to BIP44 path, then the corresponding public key
+        int error = crypto_derive_private_key(&private_key, NULL, G_context.bip44_path, BIP44_PATH_LEN);
+        if (error == 0) {
+            error = crypto_init_public_key(&private_key, &public_key, resp + offset + 1);
+        }
+        // Clear private key
+        explicit_bzero(&private_key, sizeof(private_key));
+        if (error != 0) {
+            explicit_bzero(&G_context, sizeof(G_context));
+            return io_send_sw(SW_BAD_STATE);
+        }
+
+        resp[offset] = 0x04;
+        offset += 1 + PUBKEY_LEN;
+    }
+
+    G_context.pubkeys.remaining -= count;
+    if (G_context.pubkeys.remaining == 0) {
+        G_context.state = STATE_NONE;
+    }
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = offset, .offset = 0}, SW_OK);
+}
+
+int handler_get_public_keys(buffer_t *cdata, bool first) {
+    if (!first) {
+        if (G_context.req_type != EXPORT_PUBLIC_KEYS || G_context.state != STATE_BIP44_OK) {
+            return io_send_sw(SW_BAD_STATE);
+        }
+        return send_public_keys_page();
+    }
+
+    explicit_bzero(&G_context, sizeof(G_context));
+    G_context.req_type = EXPORT_PUBLIC_KEYS;
+    G_context.state = STATE_NONE;
+
+    uint16_t status;
+    if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) return io_send_sw(status);
+
+    uint8_t count;
+    if (!buffer_read_u8(cdata, &count) || count == 0 || count > MAX_PUBLIC_KEYS_COUNT ||
+        cdata->offset != cdata->size) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+    // the last address index of the range must be valid as well
+    if (G_context.bip44_path[BIP44_PATH_LEN - 1] + count > BIP44_MAX_ADDRESS_INDEX) {
+        return io_send_sw(SW_BIP44_BAD_ADDRESS);
+    }
+
+    G_context.pubkeys.next_index = G_context.bip44_path[BIP44_PATH_LEN - 1];
+    G_context.pubkeys.remaining = count;
+    G_context.state = STATE_BIP44_OK;
+
+    return send_public_keys_page();
+}
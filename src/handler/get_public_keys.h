@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+#include <stdint.h>   // uint*_t
+
+#include "types.h"
+#include "common/buffer.h"
+
+/**
+ * Handler for GET_PUBLIC_KEYS command. Export the public keys of 'count' consecutive
+ * address indexes, starting at the address index of the BIP44 path, PUBLIC_KEYS_PER_PAGE
+ * keys per APDU response.
+ *
+ * @see G_context.bip44_path and G_context.pubkeys
+ *
+ * @param[in,out] cdata
+ *   Command data with BIP44 path and count for the first APDU, empty for the following ones.
+ * @param[in]     first
+ *   Whether this is the first APDU of the export or a request for the next page.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_public_keys(buffer_t *cdata, bool first);
@@ -33,101 +33,144 @@
 #include "transaction/transaction_types.h"
 #include "transaction/deserialize.h"
 
-int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more) {
+void sign_tx_start_transaction(void) {
+    explicit_bzero(&G_context.tx_info, sizeof(G_context.tx_info));
+
+    // Start the parser, fed by every transaction chunk that follows. It also runs the hash of the signed data
+    // and the hash of the script, so both are known as soon as the last chunk is parsed
+    cx_sha256_init(&G_tx_hash);
+    cx_sha256_init(&G_script_hash);
+    transaction_parser_init(&G_context.tx_info.parser,
+                            G_context.tx_info.tx_data,
+                            sizeof(G_context.tx_info.tx_data),
+                            &G_tx_hash,
+                            &G_script_hash);
+}
 
-    if (chunk == 0) {  // First APDU, parse BIP44 path
-        explicit_bzero(&G_context, sizeof(G_context));
-        G_context.req_type = CONFIRM_TRANSACTION;
+/**
+ * Start a new SIGN_TX session: parse the BIP44 path and get the parser and the hashes ready for the transaction.
+ */
+static bool start_session(buffer_t *cdata, sig_format_e sig_format, uint16_t *status) {
+    explicit_bzero(&G_context, sizeof(G_context));
+    G_context.req_type = CONFIRM_TRANSACTION;
+    G_context.state = STATE_NONE;
+    G_context.sig_format = sig_format;
+
+    if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, status)) {
+        return false;
+    }
+
+    sign_tx_start_transaction();
+
+    G_context.state = STATE_BIP44_OK;
+    return true;
+}
+
+/**
+ * Parse the network magic following the BIP44 path.
+ */
+static bool read_network_magic(buffer_t *cdata, uint16_t *status) {
+    if (!buffer_read_u32(cdata, &G_context.network_magic, LE)) {
+        *status = SW_MAGIC_PARSING_FAIL;
+        return false;
+    }
+    G_context.state = STATE_MAGIC_OK;
+    return true;
+}
+
+int sign_tx_receive_transaction(buffer_t *cdata, bool more, int (*on_parsed)(void)) {
+    // Parse the chunk right away, so a malformed transaction is rejected without waiting for the remaining chunks.
+    // The transaction may be of any length, only the fields copied to the store are bounded by its size
+    parser_status_e status = transaction_parser_feed(&G_context.tx_info.parser,
+                                                     &G_context.tx_info.transaction,
+                                                     cdata,
+                                                     !more);
+    PRINTF("Parsing status: %d.\n", status);
+    if (status != PARSING_OK) {
         G_context.state = STATE_NONE;
+        char status_char[1] = {(uint8_t) status};
+        return io_send_response(&(const buffer_t){.ptr = (unsigned char *) status_char, .size = 1, .offset = 0},
+                                SW_TX_PARSING_FAIL);
+    }
+
+    if (more) {  // APDU with another transaction part
+        return io_send_sw(SW_OK);
+    }
+
+    // Last APDU, the transaction is parsed, let's sign
+    G_context.state = STATE_PARSED;
+
+    /**
+     * The parser fed every chunk to the running hash of the signed part of the transaction, so it only has to be
+     * finalized. This is _not_ the final hash used as input for ecdsa (see crypto_sign_tx())
+     * The final hash is: sha256(network magic + sha256(signed part of tx data)), but we don't hash this until
+     * we've approved among others the network magic
+     */
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &G_tx_hash,
+                               CX_LAST /*mode*/,
+                               NULL /* data in */,
+                               0 /* data in len */,
+                               G_context.tx_info.hash /* hash out*/,
+                               sizeof(G_context.tx_info.hash) /* hash out len */));
+    PRINTF("Hash: %.*H\n", sizeof(G_context.tx_info.hash), G_context.tx_info.hash);
+
+    // Likewise the script was hashed while it was parsed
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &G_script_hash,
+                               CX_LAST /*mode*/,
+                               NULL /* data in */,
+                               0 /* data in len */,
+                               G_context.tx_info.script_hash /* hash out*/,
+                               sizeof(G_context.tx_info.script_hash) /* hash out len */));
+
+    PRINTF("Hash: %.*H\n", sizeof(G_context.tx_info.script_hash), G_context.tx_info.script_hash);
+
+    return on_parsed();
+}
 
-        uint16_t status;
-        if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) {
+/**
+ * Review the parsed transaction, to sign it once approved.
+ */
+static int review_transaction(void) {
+    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_PARSED) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    return start_sign_tx();
+}
+
+int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more, bool open_session, sig_format_e sig_format) {
+    uint16_t status;
+
+    if (chunk == 0) {  // First APDU, parse BIP44 path
+        if (!start_session(cdata, sig_format, &status)) {
             return io_send_sw(status);
         }
+        if (!open_session) {
+            return io_send_sw(SW_OK);
+        }
 
-        G_context.state = STATE_BIP44_OK;
-        return io_send_sw(SW_OK);
+        // Combined first APDU: the network magic and the first transaction bytes follow the path
+        if (!read_network_magic(cdata, &status)) {
+            G_context.state = STATE_NONE;
+            return io_send_sw(status);
+        }
+        return sign_tx_receive_transaction(cdata, more, review_transaction);
     } else if (chunk == 1) {
-        if (G_context.req_type != CONFIRM_TRANSACTION && G_context.state != STATE_BIP44_OK) {
+        if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_BIP44_OK) {
             return io_send_sw(SW_BAD_STATE);
         }
 
-        if (!buffer_read_u32(cdata, &G_context.network_magic, LE)) {
-            return io_send_sw(SW_MAGIC_PARSING_FAIL);
+        if (!read_network_magic(cdata, &status)) {
+            return io_send_sw(status);
         }
-        G_context.state = STATE_MAGIC_OK;
         return io_send_sw(SW_OK);
     } else {  // Receive transaction
-        if (G_context.req_type != CONFIRM_TRANSACTION && G_context.state != STATE_MAGIC_OK) {
+        if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_MAGIC_OK) {
             return io_send_sw(SW_BAD_STATE);
         }
 
-        if (more) {  // APDU with another transaction part
-            if (G_context.tx_info.raw_tx_len + cdata->size > MAX_TRANSACTION_LEN ||
-                !buffer_move(cdata, G_context.tx_info.raw_tx + G_context.tx_info.raw_tx_len, cdata->size)) {
-                return io_send_sw(SW_WRONG_TX_LENGTH);
-            }
-
-            G_context.tx_info.raw_tx_len += cdata->size;
-
-            return io_send_sw(SW_OK);
-        } else {  // Last APDU, let's parse and sign
-            if (G_context.tx_info.raw_tx_len + cdata->size > MAX_TRANSACTION_LEN ||
-                !buffer_move(cdata, G_context.tx_info.raw_tx + G_context.tx_info.raw_tx_len, cdata->size)) {
-                return io_send_sw(SW_WRONG_TX_LENGTH);
-            }
-
-            G_context.tx_info.raw_tx_len += cdata->size;
-
-            buffer_t buf = {.ptr = G_context.tx_info.raw_tx, .size = G_context.tx_info.raw_tx_len, .offset = 0};
-
-            parser_status_e status = transaction_deserialize(&buf, &G_context.tx_info.transaction);
-            PRINTF("Parsing status: %d.\n", status);
-            if (status != PARSING_OK) {
-                char status_char[1] = {(uint8_t) status};
-                return io_send_response(&(const buffer_t){.ptr = (unsigned char *) status_char, .size = 1, .offset = 0},
-                                        SW_TX_PARSING_FAIL);
-            }
-
-            G_context.state = STATE_PARSED;
-
-            /**
-             * Here we hash the signed part of the transaction. This is _not_ the final hash used as input for ecdsa
-             * (see crypto_sign_tx()) The final hash is: sha256(network magic + sha256(signed part of tx data)), but we
-             * don't hash this until we've approved among others the network magic
-             */
-
-            cx_sha256_t tx_hash;
-            cx_sha256_init(&tx_hash);
-            CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &tx_hash,
-                             CX_LAST /*mode*/,
-                             G_context.tx_info.raw_tx /* data in */,
-                             G_context.tx_info.raw_tx_len /* data in len */,
-                             G_context.tx_info.hash /* hash out*/,
-                             sizeof(G_context.tx_info.hash) /* hash out len */));
-
-            PRINTF("Hash: %.*H\n", sizeof(G_context.tx_info.hash), G_context.tx_info.hash);
-
-            /**
-             * G_context.txinfo.raw_tx has been parsed in transaction_deserialize, and hashed as part of the signed data.
-             * Now that buffer can be re-used for storing the tx.script hash
-             */
-            cx_sha256_init(&tx_hash);
-            CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &tx_hash,
-                             CX_LAST /*mode*/,
-                             G_context.tx_info.transaction.script /* data in */,
-                             G_context.tx_info.transaction.script_size /* data in len */,
-                             G_context.tx_info.script_hash /* hash out*/,
-                             sizeof(G_context.tx_info.script_hash) /* hash out len */));
-
-            PRINTF("Hash: %.*H\n", sizeof(G_context.tx_info.script_hash), G_context.tx_info.script_hash);
-            if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_PARSED) {
-                G_context.state = STATE_NONE;
-                return io_send_sw(SW_BAD_STATE);
-            }
-
-            return start_sign_tx();
-        }
+        return sign_tx_receive_transaction(cdata, more, review_transaction);
     }
 
     return 0;
@@ -3,6 +3,7 @@
 #include <stdint.h>   // uint*_t
 #include <stdbool.h>  // bool
 
+#include "types.h"
 #include "common/buffer.h"
 
 /**
@@ -18,8 +19,35 @@
  *   Index number of the APDU chunk.
  * @param[in]       more
  *   Whether more chunks are expected to be received or not.
+ * @param[in]       open_session
+ *   Whether the first chunk also carries the network magic and the first transaction bytes.
+ * @param[in]       sig_format
+ *   Encoding of the signature to return, set by the first chunk.
  *
  * @return zero or positive integer if success, negative integer otherwise.
  *
  */
-int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more);
+int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more, bool open_session, sig_format_e sig_format);
+
+/**
+ * Reset the transaction context and get the parser and the hashes ready for a new transaction.
+ *
+ * @see G_context.tx_info
+ */
+void sign_tx_start_transaction(void);
+
+/**
+ * Parse the remaining bytes of 'cdata' as the next part of the transaction. Once the last part is
+ * parsed, finalize the transaction hashes and call 'on_parsed' to go on with the signature.
+ *
+ * @param[in,out] cdata
+ *   Command data with a part of the raw transaction.
+ * @param[in]     more
+ *   Whether more parts are expected to be received or not.
+ * @param[in]     on_parsed
+ *   Called after the last part, sends the APDU response.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int sign_tx_receive_transaction(buffer_t *cdata, bool more, int (*on_parsed)(void));
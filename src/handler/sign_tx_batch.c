@@ -0,0 +1,215 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <string.h>   // memcmp, memcpy, explicit_bzero
+
+#include "os.h"
+
+#include "sign_tx_batch.h"
+#include "sign_tx.h"
+#include "sign_tx_common.h"
+#include "sw.h"
+#include "globals.h"
+#include "crypto.h"
+#include "apdu/dispatcher.h"
+#include "common/buffer.h"
+#include "common/bip44.h"
+#include "helper/send_response.h"
+#include "transaction/transaction_types.h"
+#include "transaction/tokens.h"
+
+/**
+ * Parse the batch description: network magic (4) || transactions count (1) || max total fees (8) ||
+ * tokens count (1) || [token script hash (20) || total amount (8)] * tokens count ||
+ * destinations count (1) || destination script hash (20) * destinations count
+ */
+static bool parse_batch(buffer_t *cdata, batch_ctx_t *batch) {
+    uint64_t value;
+
+    if (!buffer_read_u32(cdata, &G_context.network_magic, LE) || !buffer_read_u8(cdata, &batch->count) ||
+        batch->count == 0 || !buffer_read_u64(cdata, &batch->max_fees, LE) || batch->max_fees > INT64_MAX) {
+        return false;
+    }
+
+    if (!buffer_read_u8(cdata, &batch->tokens_size) || batch->tokens_size == 0 ||
+        batch->tokens_size > MAX_BATCH_TOKENS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < batch->tokens_size; i++) {
+        if (!buffer_can_read(cdata, UINT160_LEN)) {
+            return false;
+        }
+        // only registered tokens, as their amounts must be displayed
+        batch->tokens[i].token = token_lookup(cdata->ptr + cdata->offset);
+        buffer_seek_cur(cdata, UINT160_LEN);
+        if (batch->tokens[i].token == NULL || !buffer_read_u64(cdata, &value, LE) || value > INT64_MAX) {
+            return false;
+        }
+        batch->tokens[i].total = value;
+        for (uint8_t j = 0; j < i; j++) {
+            if (batch->tokens[j].token == batch->tokens[i].token) {
+                return false;
+            }
+        }
+    }
+
+    if (!buffer_read_u8(cdata, &batch->destinations_size) || batch->destinations_size == 0 ||
+        batch->destinations_size > MAX_BATCH_DESTINATIONS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < batch->destinations_size; i++) {
+        if (!buffer_can_read(cdata, UINT160_LEN)) {
+            return false;
+        }
+        memcpy(batch->destinations[i], cdata->ptr + cdata->offset, UINT160_LEN);
+        buffer_seek_cur(cdata, UINT160_LEN);
+    }
+
+    return cdata->offset == cdata->size;
+}
+
+static batch_token_t *find_batch_token(batch_ctx_t *batch, const struct token_info_s *token) {
+    for (uint8_t i = 0; i < batch->tokens_size; i++) {
+        if (batch->tokens[i].token == token) {
+            return &batch->tokens[i];
+        }
+    }
+    return NULL;
+}
+
+static bool is_batch_destination(const batch_ctx_t *batch, const uint8_t *script_hash) {
+    for (uint8_t i = 0; i < batch->destinations_size; i++) {
+        if (memcmp(batch->destinations[i], script_hash, UINT160_LEN) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Check that the transaction keeps within the approved batch, and account for its fees and transfers if so.
+ * The transaction must only transfer the approved tokens to the approved destinations, and its signers may
+ * only use the CalledByEntry scope as the user didn't review them.
+ */
+static bool spend_batch_transaction(batch_ctx_t *batch, const transaction_t *tx) {
+    uint64_t spent[MAX_BATCH_TOKENS];
+
+    if (!tx->is_token_transfer) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < tx->signers_size; i++) {
+        if (tx->signers[i].scope != CALLED_BY_ENTRY) {
+            return false;
+        }
+    }
+
+    // fees can't be negative (as guarded by transaction_parser_feed())
+    uint64_t fees = (uint64_t) tx->system_fee + (uint64_t) tx->network_fee;
+    if (fees > batch->max_fees - batch->fees_spent) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < batch->tokens_size; i++) {
+        spent[i] = batch->tokens[i].spent;
+    }
+    for (uint8_t i = 0; i < tx->transfers_size; i++) {
+        const transfer_t *transfer = &tx->transfers[i];
+        batch_token_t *token = find_batch_token(batch, transfer->token);
+
+        if (token == NULL || transfer->amount < 0 || !is_batch_destination(batch, tx->script + transfer->destination)) {
+            return false;
+        }
+        uint8_t index = token - batch->tokens;
+        if ((uint64_t) transfer->amount > token->total - spent[index]) {
+            return false;
+        }
+        spent[index] += transfer->amount;
+    }
+
+    batch->fees_spent += fees;
+    for (uint8_t i = 0; i < batch->tokens_size; i++) {
+        batch->tokens[i].spent = spent[i];
+    }
+    return true;
+}
+
+/**
+ * Sign the transaction just parsed if it keeps within the batch. Any failure ends the batch.
+ */
+static int sign_batch_transaction(void) {
+    batch_ctx_t *batch = &G_context.batch;
+
+    batch->receiving = false;
+    if (G_context.req_type != CONFIRM_BATCH || G_context.state != STATE_PARSED) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    if (!spend_batch_transaction(batch, &G_context.tx_info.transaction)) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_TX_NOT_IN_BATCH);
+    }
+
+    if (crypto_sign_tx() < 0) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_SIGN_FAIL);
+    }
+
+    // the batch is over with its last transaction
+    batch->remaining--;
+    G_context.state = (batch->remaining > 0) ? STATE_APPROVED : STATE_NONE;
+
+    return helper_send_response_sig();
+}
+
+int handler_sign_tx_batch(buffer_t *cdata, uint8_t chunk, bool more, sig_format_e sig_format) {
+    if (chunk == P1_BATCH_START) {
+        explicit_bzero(&G_context, sizeof(G_context));
+        G_context.req_type = CONFIRM_BATCH;
+        G_context.state = STATE_NONE;
+        G_context.sig_format = sig_format;
+
+        uint16_t status;
+        if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) {
+            return io_send_sw(status);
+        }
+
+        if (!parse_batch(cdata, &G_context.batch)) {
+            explicit_bzero(&G_context.batch, sizeof(G_context.batch));
+            return io_send_sw(SW_BATCH_PARSING_FAIL);
+        }
+
+        G_context.state = STATE_PARSED;
+        return start_sign_batch();
+    }
+
+    // Transactions are only received once the batch is approved
+    if (G_context.req_type != CONFIRM_BATCH || G_context.state != STATE_APPROVED) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    if (!G_context.batch.receiving) {
+        sign_tx_start_transaction();
+        G_context.batch.receiving = true;
+    }
+
+    return sign_tx_receive_transaction(cdata, more, sign_batch_transaction);
+}
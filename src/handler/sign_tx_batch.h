@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "types.h"
+#include "common/buffer.h"
+
+/**
+ * Handler for SIGN_TX_BATCH command. The first APDU describes the batch, which the user
+ * reviews and approves once. Each transaction of the batch then follows in one or more
+ * APDUs, and is signed without further review if it keeps within the approved batch.
+ *
+ * @see G_context.batch, G_context.bip44_path, G_context.network_magic and G_context.tx_info
+ *
+ * @param[in,out] cdata
+ *   Command data with the batch description, or a part of a raw transaction.
+ * @param[in]     chunk
+ *   P1_BATCH_START for the batch description, P1_BATCH_TX for a part of a transaction.
+ * @param[in]     more
+ *   Whether more parts of the transaction are expected to be received or not.
+ * @param[in]     sig_format
+ *   Encoding of the signatures to return, set by the batch description.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_sign_tx_batch(buffer_t *cdata, uint8_t chunk, bool more, sig_format_e sig_format);
@@ -6,15 +6,46 @@
 #include "constants.h"
 #include "globals.h"
 #include "sw.h"
+#include "crypto.h"
 #include "common/buffer.h"
+#include "transaction/script.h"
+#include "ui/utils.h"
 
 int helper_send_response_pubkey() {
     uint8_t resp[1 + PUBKEY_LEN] = {0};
     size_t offset = 1;
 
+    if (G_context.compressed_public_key) {
+        compress_public_key(G_context.raw_public_key, resp);
+        return io_send_response(&(const buffer_t){.ptr = resp, .size = COMPRESSED_PUBKEY_LEN, .offset = 0}, SW_OK);
+    }
+
     resp[0] = 0x04;
     memcpy(resp + offset, G_context.raw_public_key, PUBKEY_LEN);
     offset += PUBKEY_LEN;
 
     return io_send_response(&(const buffer_t){.ptr = resp, .size = offset, .offset = 0}, SW_OK);
-}
\ No newline at end of file
+}
+
+int helper_send_response_sig() {
+    uint8_t resp[INVOCATION_SCRIPT_LEN] = {0};
+    size_t offset = 0;
+
+    if (G_context.sig_format == SIG_FORMAT_DER) {
+        return io_send_response(&(const buffer_t){.ptr = G_context.tx_info.signature,
+                                                  .size = G_context.tx_info.signature_len,
+                                                  .offset = 0},
+                                SW_OK);
+    }
+
+    if (G_context.sig_format == SIG_FORMAT_INVOCATION) {
+        resp[offset++] = OPCODE_PUSHDATA1;
+        resp[offset++] = SIG_RS_LEN;
+    }
+    if (crypto_sig_to_rs(G_context.tx_info.signature, G_context.tx_info.signature_len, resp + offset) < 0) {
+        return io_send_sw(SW_SIGN_FAIL);
+    }
+    offset += SIG_RS_LEN;
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = offset, .offset = 0}, SW_OK);
+}
@@ -9,4 +9,21 @@
  */
 #define PUBKEY_LEN 64
 
-int helper_send_response_pubkey(void);
\ No newline at end of file
+/**
+ * Length of compressed public key: parity of y (1) || x (32).
+ */
+#define COMPRESSED_PUBKEY_LEN 33
+
+/**
+ * Send the public key in G_context.raw_public_key, compressed if requested by G_context.compressed_public_key.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ */
+int helper_send_response_pubkey(void);
+
+/**
+ * Send the signature of the transaction in G_context.tx_info, encoded as requested by G_context.sig_format.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ */
+int helper_send_response_sig(void);
\ No newline at end of file
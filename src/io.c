@@ -25,6 +25,10 @@
 #include "sw.h"
 #include "common/buffer.h"
 #include "common/write.h"
+#include "common/pubkey_cache.h"
+#ifdef HAVE_APDU_TRACE
+#include "apdu/trace.h"
+#endif  // HAVE_APDU_TRACE
 
 uint32_t G_output_len = 0;
 
@@ -63,6 +67,10 @@ uint8_t io_event(uint8_t channel __attribute__((unused))) {
             break;
 #endif  // HAVE_NBGL
         case SEPROXYHAL_TAG_TICKER_EVENT:
+            // the cached public keys must not outlive the session of the user
+            if (os_global_pin_is_validated() != BOLOS_UX_OK) {
+                pubkey_cache_flush();
+            }
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {});
             break;
         default:
@@ -101,7 +109,7 @@ uint16_t io_exchange_al(uint8_t channel, uint16_t tx_len) {
 }
 
 int io_recv_command() {
-    int ret;
+    int ret = -1;
 
     switch (G_io_state) {
         case READY:
@@ -119,6 +127,12 @@ int io_recv_command() {
             break;
     }
 
+#ifdef HAVE_APDU_TRACE
+    if (ret >= 0) {
+        apdu_trace_command(G_io_apdu_buffer, (size_t) ret);
+    }
+#endif  // HAVE_APDU_TRACE
+
     return ret;
 }
 
@@ -140,6 +154,10 @@ int io_send_response(const buffer_t *rdata, uint16_t sw) {
     write_u16_be(G_io_apdu_buffer, G_output_len, sw);
     G_output_len += 2;
 
+#ifdef HAVE_APDU_TRACE
+    apdu_trace_response(G_io_apdu_buffer, G_output_len);
+#endif  // HAVE_APDU_TRACE
+
     switch (G_io_state) {
         case READY:
             ret = -1;
@@ -29,12 +29,15 @@
 #include "ui/menu.h"
 #include "apdu/parser.h"
 #include "apdu/dispatcher.h"
+#include "common/pubkey_cache.h"
 
 uint8_t G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
 io_state_e G_io_state;
 ux_state_t G_ux;
 bolos_ux_params_t G_ux_params;
 global_ctx_t G_context;
+cx_sha256_t G_tx_hash;
+cx_sha256_t G_script_hash;
 
 settings_strings_t strings;
 const internalStorage_t N_storage_real;
@@ -54,6 +57,7 @@ void app_main() {
 
     // Reset context
     explicit_bzero(&G_context, sizeof(G_context));
+    pubkey_cache_flush();
 
     for (;;) {
         BEGIN_TRY {
@@ -29,7 +29,7 @@
  */
 #define SW_WRONG_RESPONSE_LENGTH 0xB000
 /**
- * Status word for wrong transaction length.
+ * Status word for wrong transaction length, no longer sent: transactions have no maximum length.
  */
 #define SW_WRONG_TX_LENGTH 0xB001
 /**
@@ -48,6 +48,14 @@
  * Status word for signing failure.
  */
 #define SW_SIGN_FAIL 0xB005
+/**
+ * Status word for failing to parse a batch of transactions.
+ */
+#define SW_BATCH_PARSING_FAIL 0xB006
+/**
+ * Status word for a transaction that doesn't keep within the approved batch.
+ */
+#define SW_TX_NOT_IN_BATCH 0xB007
 /**
  * Status word for invalid BIP44 purpose field
  */
@@ -105,6 +113,12 @@
  */
 #define SW_DISPLAY_SCRIPT_HASH_FAIL 0xb10B
 
+/**
+ * Status word for a transaction with more signer properties
+ * than can be displayed on the device
+ */
+#define SW_DISPLAY_SIGNERS_FAIL 0xb10C
+
 /**
  * Status word for failing to convert public key to NEO address
  */
@@ -19,167 +19,460 @@
 #include "types.h"
 #include "constants.h"
 #include "common/buffer.h"
+#include "common/read.h"
+#include "common/varint.h"
 #include "tx_utils.h"
 
 #include <string.h>
 
-parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx) {
-    if (buf->size > MAX_TRANSACTION_LEN) {
-        return INVALID_LENGTH_ERROR;
+/**
+ * Gather a fixed size field which may be split over two chunks.
+ *
+ * @return pointer to the complete field, or NULL if the chunk ran out before the field was complete.
+ */
+static const uint8_t *parser_gather(tx_parser_t *parser, buffer_t *buf, size_t len) {
+    size_t available = buf->size - buf->offset;
+
+    if (parser->carry_len == 0 && available >= len) {
+        const uint8_t *field = buf->ptr + buf->offset;
+        buf->offset += len;
+        return field;
+    }
+
+    size_t n = len - parser->carry_len;
+    if (n > available) {
+        n = available;
+    }
+    memcpy(parser->carry + parser->carry_len, buf->ptr + buf->offset, n);
+    parser->carry_len += n;
+    buf->offset += n;
+
+    if (parser->carry_len < len) {
+        return NULL;
     }
+    parser->carry_len = 0;
+    return parser->carry;
+}
 
-    // This can actually never fail because 'buf' would contain the tx data send in the 3rd apdu.
-    // If the 3rd apdu has no data, it will fail in the dispatcher.
-    // Leaving it just in case code might change in the future. Better safe than sorrow
-    if (!buffer_read_u8(buf, &tx->version)) {
-        return VERSION_PARSING_ERROR;
+/**
+ * Gather a varint which may be split over two chunks.
+ *
+ * @return true if the varint is complete and stored in 'value', false if the chunk ran out first.
+ */
+static bool parser_gather_varint(tx_parser_t *parser, buffer_t *buf, uint64_t *value) {
+    uint8_t prefix;
+    if (parser->carry_len > 0) {
+        prefix = parser->carry[0];
+    } else if (buf->offset < buf->size) {
+        prefix = buf->ptr[buf->offset];
+    } else {
+        return false;
     }
 
-    if (tx->version > 0) {
-        return VERSION_VALUE_ERROR;
+    size_t len = (prefix == 0xFD) ? 3 : (prefix == 0xFE) ? 5 : (prefix == 0xFF) ? 9 : 1;
+    const uint8_t *field = parser_gather(parser, buf, len);
+    if (field == NULL) {
+        return false;
     }
+    varint_read(field, len, value);
+    return true;
+}
 
-    if (!buffer_read_u32(buf, &tx->nonce, LE)) {
-        return NONCE_PARSING_ERROR;
+/**
+ * Reserve 'len' bytes in the parser store for a field that is copied as it arrives.
+ * The field starts at the current 'store_len'.
+ *
+ * @return true if success, false if the store is too small.
+ */
+static bool parser_begin_blob(tx_parser_t *parser, size_t len) {
+    if (len > (size_t) (parser->store_size - parser->store_len)) {
+        return false;
     }
+    parser->blob_remaining = (uint16_t) len;
+    return true;
+}
 
-    if (!buffer_read_s64(buf, &tx->system_fee, LE)) {
-        return SYSTEM_FEE_PARSING_ERROR;
+/**
+ * Copy as much of the current field to the store as the chunk holds.
+ *
+ * @return true if the field is complete.
+ */
+static bool parser_copy_blob(tx_parser_t *parser, buffer_t *buf) {
+    size_t n = buf->size - buf->offset;
+    if (n > parser->blob_remaining) {
+        n = parser->blob_remaining;
+    }
+    if (!parser->blob_hashed_only) {
+        memcpy(parser->store + parser->store_len, buf->ptr + buf->offset, n);
+        parser->store_len += n;
     }
-    if (tx->system_fee < 0) {
-        return SYSTEM_FEE_VALUE_ERROR;
+    if (parser->step == TX_STEP_SCRIPT && parser->script_hash != NULL) {
+        tx_hash_update(parser->script_hash, buf->ptr + buf->offset, n);
     }
+    parser->blob_remaining -= n;
+    buf->offset += n;
+
+    return parser->blob_remaining == 0;
+}
 
-    if (!buffer_read_s64(buf, &tx->network_fee, LE)) {
-        return NETWORK_FEE_PARSING_ERROR;
+static parser_status_e parser_begin_account(tx_parser_t *parser, transaction_t *tx) {
+    if (!parser_begin_blob(parser, UINT160_LEN)) {
+        return INVALID_LENGTH_ERROR;
     }
+    tx->signers[parser->signer_index].account = parser->store_len;
+    parser->step = TX_STEP_SIGNER_ACCOUNT;
+    return PARSING_OK;
+}
 
-    if (tx->network_fee < 0) {
-        return NETWORK_FEE_VALUE_ERROR;
+/**
+ * Move on to the next signer, or to the attributes once all signers are parsed.
+ */
+static parser_status_e parser_next_signer(tx_parser_t *parser, transaction_t *tx) {
+    parser->signer_index++;
+    if (parser->signer_index < tx->signers_size) {
+        return parser_begin_account(parser, tx);
     }
+    parser->step = TX_STEP_ATTRIBUTES_LENGTH;
+    return PARSING_OK;
+}
 
-    if (!buffer_read_u32(buf, &tx->valid_until_block, LE)) {
-        return VALID_UNTIL_BLOCK_PARSING_ERROR;
+/**
+ * Move on to the allowed groups of the current signer if its scope has them, else to the next signer.
+ */
+static parser_status_e parser_after_contracts(tx_parser_t *parser, transaction_t *tx) {
+    if ((tx->signers[parser->signer_index].scope & CUSTOM_GROUPS) == CUSTOM_GROUPS) {
+        parser->step = TX_STEP_GROUPS_LENGTH;
+        return PARSING_OK;
     }
+    return parser_next_signer(parser, tx);
+}
 
-    // Parse (Co)Signers
-    uint64_t signer_length;
-    if (!buffer_read_varint(buf, &signer_length)) {
-        return SIGNER_LENGTH_PARSING_ERROR;
+static parser_status_e parser_begin_contract(tx_parser_t *parser, transaction_t *tx) {
+    if (!parser_begin_blob(parser, UINT160_LEN)) {
+        return INVALID_LENGTH_ERROR;
     }
-    if (signer_length < MIN_TX_SIGNERS || signer_length > MAX_TX_SIGNERS) {
-        return SIGNER_LENGTH_VALUE_ERROR;
+    // allowed contracts are copied back to back, only the first one's offset is needed
+    if (parser->item_index == 0) {
+        tx->signers[parser->signer_index].allowed_contracts = parser->store_len;
     }
+    parser->step = TX_STEP_CONTRACT;
+    return PARSING_OK;
+}
 
-    tx->signers_size = (uint8_t) signer_length;
-    for (int i = 0; i < tx->signers_size; i++) {
-        tx->signers[i].account = (uint8_t *) (buf->ptr + buf->offset);
-        if (!buffer_seek_cur(buf, UINT160_LEN)) {
-            return SIGNER_ACCOUNT_PARSING_ERROR;
-        }
+static parser_status_e parser_begin_group(tx_parser_t *parser, transaction_t *tx) {
+    if (!parser_begin_blob(parser, ECPOINT_LEN)) {
+        return INVALID_LENGTH_ERROR;
+    }
+    // allowed groups are copied back to back, only the first one's offset is needed
+    if (parser->item_index == 0) {
+        tx->signers[parser->signer_index].allowed_groups = parser->store_len;
+    }
+    parser->step = TX_STEP_GROUP;
+    return PARSING_OK;
+}
+
+/**
+ * Run the current step of the parser on the chunk.
+ * Returns PARSING_OK both when the step completed and when the chunk ran out in the middle of it.
+ */
+static parser_status_e parser_step(tx_parser_t *parser, transaction_t *tx, buffer_t *buf) {
+    const uint8_t *field;
+    uint64_t length;
+    signer_t *signer = &tx->signers[parser->signer_index];
 
-        // Check that the signer is unique by comparing its account property vs existing accounts
-        // 'i' determines how many signers (and thus accounts) have been added so far.
-        for (int s = 0; s < i; s++) {
-            if (!memcmp(tx->signers[s].account, tx->signers[i].account, UINT160_LEN)) {
-                return SIGNER_ACCOUNT_DUPLICATE_ERROR;
+    switch (parser->step) {
+        case TX_STEP_VERSION:
+            if ((field = parser_gather(parser, buf, 1)) == NULL) {
+                return PARSING_OK;
             }
-        }
+            tx->version = field[0];
+            if (tx->version > 0) {
+                return VERSION_VALUE_ERROR;
+            }
+            parser->step = TX_STEP_NONCE;
+            return PARSING_OK;
 
-        uint8_t value;
-        if (!buffer_read_u8(buf, &value)) {
-            return SIGNER_SCOPE_PARSING_ERROR;
-        }
-        tx->signers[i].scope = (witness_scope_e) value;
+        case TX_STEP_NONCE:
+            if ((field = parser_gather(parser, buf, 4)) == NULL) {
+                return PARSING_OK;
+            }
+            tx->nonce = read_u32_le(field, 0);
+            parser->step = TX_STEP_SYSTEM_FEE;
+            return PARSING_OK;
 
-        // Scope GLOBAL is not allowed to have other flags
-        if ((((witness_scope_e) value & GLOBAL) == GLOBAL) && ((witness_scope_e) value != GLOBAL)) {
-            return SIGNER_SCOPE_VALUE_ERROR_GLOBAL_FLAG;
-        }
+        case TX_STEP_SYSTEM_FEE:
+            if ((field = parser_gather(parser, buf, 8)) == NULL) {
+                return PARSING_OK;
+            }
+            tx->system_fee = read_s64_le(field, 0);
+            if (tx->system_fee < 0) {
+                return SYSTEM_FEE_VALUE_ERROR;
+            }
+            parser->step = TX_STEP_NETWORK_FEE;
+            return PARSING_OK;
 
-        uint64_t var_int_length;
-        if (((witness_scope_e) value & CUSTOM_CONTRACTS) == CUSTOM_CONTRACTS) {
-            if (!buffer_read_varint(buf, &var_int_length)) {
-                return SIGNER_ALLOWED_CONTRACTS_LENGTH_PARSING_ERROR;
+        case TX_STEP_NETWORK_FEE:
+            if ((field = parser_gather(parser, buf, 8)) == NULL) {
+                return PARSING_OK;
             }
-            if (var_int_length > MAX_SIGNER_ALLOWED_CONTRACTS) {
-                return SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR;
+            tx->network_fee = read_s64_le(field, 0);
+            if (tx->network_fee < 0) {
+                return NETWORK_FEE_VALUE_ERROR;
+            }
+            parser->step = TX_STEP_VALID_UNTIL_BLOCK;
+            return PARSING_OK;
+
+        case TX_STEP_VALID_UNTIL_BLOCK:
+            if ((field = parser_gather(parser, buf, 4)) == NULL) {
+                return PARSING_OK;
+            }
+            tx->valid_until_block = read_u32_le(field, 0);
+            parser->step = TX_STEP_SIGNERS_LENGTH;
+            return PARSING_OK;
+
+        // Parse (Co)Signers
+        case TX_STEP_SIGNERS_LENGTH:
+            if (!parser_gather_varint(parser, buf, &length)) {
+                return PARSING_OK;
             }
-            tx->signers[i].allowed_contracts_size = var_int_length;
-            for (size_t j = 0; j < var_int_length; j++) {
-                tx->signers[i].allowed_contracts[j] = (uint8_t *) (buf->ptr + buf->offset);
-                if (!buffer_seek_cur(buf, UINT160_LEN)) {
-                    return SIGNER_ALLOWED_CONTRACT_PARSING_ERROR;
+            if (length < MIN_TX_SIGNERS || length > MAX_TX_SIGNERS) {
+                return SIGNER_LENGTH_VALUE_ERROR;
+            }
+            tx->data = parser->store;
+            tx->signers_size = (uint8_t) length;
+            parser->signer_index = 0;
+            return parser_begin_account(parser, tx);
+
+        case TX_STEP_SIGNER_ACCOUNT:
+            if (!parser_copy_blob(parser, buf)) {
+                return PARSING_OK;
+            }
+            // Check that the signer is unique by comparing its account property vs existing accounts
+            for (int s = 0; s < parser->signer_index; s++) {
+                if (!memcmp(parser->store + tx->signers[s].account, parser->store + signer->account, UINT160_LEN)) {
+                    return SIGNER_ACCOUNT_DUPLICATE_ERROR;
                 }
             }
-        }
+            parser->step = TX_STEP_SIGNER_SCOPE;
+            return PARSING_OK;
 
-        var_int_length = 0;
-        if (((witness_scope_e) value & CUSTOM_GROUPS) == CUSTOM_GROUPS) {
-            if (!buffer_read_varint(buf, &var_int_length)) {
-                return SIGNER_ALLOWED_GROUPS_LENGTH_PARSING_ERROR;
+        case TX_STEP_SIGNER_SCOPE:
+            if ((field = parser_gather(parser, buf, 1)) == NULL) {
+                return PARSING_OK;
             }
-            if (var_int_length > MAX_SIGNER_ALLOWED_GROUPS) {
+            signer->scope = field[0];
+
+            // Scope GLOBAL is not allowed to have other flags
+            if (((signer->scope & GLOBAL) == GLOBAL) && (signer->scope != GLOBAL)) {
+                return SIGNER_SCOPE_VALUE_ERROR_GLOBAL_FLAG;
+            }
+
+            if ((signer->scope & CUSTOM_CONTRACTS) == CUSTOM_CONTRACTS) {
+                parser->step = TX_STEP_CONTRACTS_LENGTH;
+                return PARSING_OK;
+            }
+            return parser_after_contracts(parser, tx);
+
+        case TX_STEP_CONTRACTS_LENGTH:
+            if (!parser_gather_varint(parser, buf, &length)) {
+                return PARSING_OK;
+            }
+            if (length > MAX_SIGNER_ALLOWED_CONTRACTS) {
+                return SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR;
+            }
+            signer->allowed_contracts_size = (uint8_t) length;
+            parser->item_index = 0;
+            if (length == 0) {
+                return parser_after_contracts(parser, tx);
+            }
+            return parser_begin_contract(parser, tx);
+
+        case TX_STEP_CONTRACT:
+            if (!parser_copy_blob(parser, buf)) {
+                return PARSING_OK;
+            }
+            parser->item_index++;
+            if (parser->item_index < signer->allowed_contracts_size) {
+                return parser_begin_contract(parser, tx);
+            }
+            return parser_after_contracts(parser, tx);
+
+        case TX_STEP_GROUPS_LENGTH:
+            if (!parser_gather_varint(parser, buf, &length)) {
+                return PARSING_OK;
+            }
+            if (length > MAX_SIGNER_ALLOWED_GROUPS) {
                 return SIGNER_ALLOWED_GROUPS_LENGTH_VALUE_ERROR;
             }
-            tx->signers[i].allowed_groups_size = var_int_length;
-            for (size_t j = 0; j < var_int_length; j++) {
-                tx->signers[i].allowed_groups[j] = (uint8_t *) (buf->ptr + buf->offset);
-                if (!buffer_seek_cur(buf, ECPOINT_LEN)) {
-                    return SIGNER_ALLOWED_CONTRACT_PARSING_ERROR;
-                }
+            signer->allowed_groups_size = (uint8_t) length;
+            parser->item_index = 0;
+            if (length == 0) {
+                return parser_next_signer(parser, tx);
             }
-        }
-    }
+            return parser_begin_group(parser, tx);
 
-    // Parse transaction attributes
-    uint64_t attributes_length;
-    if (!buffer_read_varint(buf, &attributes_length)) {
-        return ATTRIBUTES_LENGTH_PARSING_ERROR;
-    }
-    // The actual network does (MAX_TX_SIGNERS (16) - signer length) but due to memory constraints we lowered the
-    // MAX_ATTRIBUTES and hardcode the attributes limit to 2
-    if (attributes_length > MAX_ATTRIBUTES || attributes_length > 2) {
-        return ATTRIBUTES_LENGTH_VALUE_ERROR;
-    }
-    tx->attributes_size = (uint8_t) attributes_length;
+        case TX_STEP_GROUP:
+            if (!parser_copy_blob(parser, buf)) {
+                return PARSING_OK;
+            }
+            parser->item_index++;
+            if (parser->item_index < signer->allowed_groups_size) {
+                return parser_begin_group(parser, tx);
+            }
+            return parser_next_signer(parser, tx);
+
+        // Parse transaction attributes
+        case TX_STEP_ATTRIBUTES_LENGTH:
+            if (!parser_gather_varint(parser, buf, &length)) {
+                return PARSING_OK;
+            }
+            // The actual network does (MAX_TX_SIGNERS (16) - signer length) but due to memory constraints we lowered
+            // the MAX_ATTRIBUTES and hardcode the attributes limit to 2
+            if (length > MAX_ATTRIBUTES || length > 2) {
+                return ATTRIBUTES_LENGTH_VALUE_ERROR;
+            }
+            tx->attributes_size = (uint8_t) length;
+            parser->item_index = 0;
+            parser->step = (length == 0) ? TX_STEP_SCRIPT_LENGTH : TX_STEP_ATTRIBUTE;
+            return PARSING_OK;
 
-    if (tx->attributes_size > 0) {
-        for (int i = 0; i < tx->attributes_size; i++) {
-            uint8_t attribute_type;
-            if (!buffer_read_u8(buf, &attribute_type) || attribute_type != HIGH_PRIORITY) {
+        case TX_STEP_ATTRIBUTE:
+            if ((field = parser_gather(parser, buf, 1)) == NULL) {
+                return PARSING_OK;
+            }
+            if (field[0] != HIGH_PRIORITY) {
                 return ATTRIBUTES_UNSUPPORTED_TYPE;
             }
             // check for duplicates
-            for (int j = 0; j < tx->attributes_size; j++) {
-                if (tx->attributes[j].type == attribute_type) {
+            for (int j = 0; j < parser->item_index; j++) {
+                if (tx->attributes[j].type == field[0]) {
                     return ATTRIBUTES_DUPLICATE_TYPE;
                 }
             }
-            tx->attributes[i] = (attribute_t){.type = attribute_type};
-        }
+            tx->attributes[parser->item_index] = (attribute_t){.type = field[0]};
+            parser->item_index++;
+            if (parser->item_index == tx->attributes_size) {
+                parser->step = TX_STEP_SCRIPT_LENGTH;
+            }
+            return PARSING_OK;
+
+        // Parse out script
+        case TX_STEP_SCRIPT_LENGTH:
+            if (!parser_gather_varint(parser, buf, &length)) {
+                return PARSING_OK;
+            }
+            if (length > 0xFFFF || length == 0) {
+                return SCRIPT_LENGTH_VALUE_ERROR;
+            }
+            // A script too long for the store is hashed without being kept: it is longer than any transfer or vote
+            // the app recognizes, so it is reviewed as an arbitrary script, by its hash
+            if (parser_begin_blob(parser, length)) {
+                tx->script = parser->store + parser->store_len;
+            } else {
+                parser->blob_remaining = (uint16_t) length;
+                parser->blob_hashed_only = true;
+                tx->script = NULL;
+            }
+            tx->script_size = (uint16_t) length;
+            parser->step = TX_STEP_SCRIPT;
+            return PARSING_OK;
+
+        case TX_STEP_SCRIPT:
+            if (!parser_copy_blob(parser, buf)) {
+                return PARSING_OK;
+            }
+
+            // test if script is a NEO or GAS transfer, or a vote
+            if (tx->script != NULL) {
+                try_parse_script(tx);
+            }
+            parser->step = TX_STEP_DONE;
+            return PARSING_OK;
+
+        case TX_STEP_DONE:
+        default:
+            return INVALID_LENGTH_ERROR;
     }
+}
 
-    // Parse out script
-    uint64_t script_length;
-    if (!buffer_read_varint(buf, &script_length)) {
-        return SCRIPT_LENGTH_PARSING_ERROR;
+/**
+ * Error to report when the transaction ends while the parser is still at 'step'.
+ */
+static parser_status_e parser_truncated_error(tx_parser_step_e step) {
+    switch (step) {
+        case TX_STEP_VERSION:
+            return VERSION_PARSING_ERROR;
+        case TX_STEP_NONCE:
+            return NONCE_PARSING_ERROR;
+        case TX_STEP_SYSTEM_FEE:
+            return SYSTEM_FEE_PARSING_ERROR;
+        case TX_STEP_NETWORK_FEE:
+            return NETWORK_FEE_PARSING_ERROR;
+        case TX_STEP_VALID_UNTIL_BLOCK:
+            return VALID_UNTIL_BLOCK_PARSING_ERROR;
+        case TX_STEP_SIGNERS_LENGTH:
+            return SIGNER_LENGTH_PARSING_ERROR;
+        case TX_STEP_SIGNER_ACCOUNT:
+            return SIGNER_ACCOUNT_PARSING_ERROR;
+        case TX_STEP_SIGNER_SCOPE:
+            return SIGNER_SCOPE_PARSING_ERROR;
+        case TX_STEP_CONTRACTS_LENGTH:
+            return SIGNER_ALLOWED_CONTRACTS_LENGTH_PARSING_ERROR;
+        case TX_STEP_CONTRACT:
+            return SIGNER_ALLOWED_CONTRACT_PARSING_ERROR;
+        case TX_STEP_GROUPS_LENGTH:
+            return SIGNER_ALLOWED_GROUPS_LENGTH_PARSING_ERROR;
+        case TX_STEP_GROUP:
+            // kept as reported by the original single buffer parser
+            return SIGNER_ALLOWED_CONTRACT_PARSING_ERROR;
+        case TX_STEP_ATTRIBUTES_LENGTH:
+            return ATTRIBUTES_LENGTH_PARSING_ERROR;
+        case TX_STEP_ATTRIBUTE:
+            return ATTRIBUTES_UNSUPPORTED_TYPE;
+        case TX_STEP_SCRIPT_LENGTH:
+            return SCRIPT_LENGTH_PARSING_ERROR;
+        case TX_STEP_SCRIPT:
+            return SCRIPT_LENGTH_VALUE_ERROR;
+        case TX_STEP_DONE:
+        default:
+            return PARSING_OK;
     }
+}
+
+void transaction_parser_init(tx_parser_t *parser,
+                             uint8_t *store,
+                             size_t store_size,
+                             struct cx_sha256_s *tx_hash,
+                             struct cx_sha256_s *script_hash) {
+    memset(parser, 0, sizeof(*parser));
+    parser->step = TX_STEP_VERSION;
+    parser->store = store;
+    parser->store_size = (uint16_t) store_size;
+    parser->tx_hash = tx_hash;
+    parser->script_hash = script_hash;
+}
 
-    tx->script = (uint8_t *) (buf->ptr + buf->offset);
-    if (script_length > 0xFFFF || script_length == 0 || !buffer_seek_cur(buf, script_length)) {
-        return SCRIPT_LENGTH_VALUE_ERROR;
+parser_status_e transaction_parser_feed(tx_parser_t *parser, transaction_t *tx, buffer_t *buf, bool last) {
+    size_t start = buf->offset;
+
+    while (buf->offset < buf->size) {
+        parser_status_e status = parser_step(parser, tx, buf);
+        if (status != PARSING_OK) {
+            return status;
+        }
     }
-    tx->script_size = (uint16_t) script_length;
 
-    // test if script is NEO or GAS transfer
-    buffer_t scriptBuf = {.ptr = tx->script, .size = script_length, .offset = 0};
-    try_parse_transfer_script(&scriptBuf, tx);
-    if (!tx->is_system_asset_transfer) {
-        // reset offset to start script dissection from the start
-        scriptBuf.offset = 0;
-        try_parse_vote_script(&scriptBuf, tx);
+    // The whole chunk is parsed, add it to the transaction hash in one go
+    if (parser->tx_hash != NULL) {
+        tx_hash_update(parser->tx_hash, buf->ptr + start, buf->offset - start);
     }
 
-    return (buf->offset == buf->size) ? PARSING_OK : INVALID_LENGTH_ERROR;
+    return last ? parser_truncated_error(parser->step) : PARSING_OK;
+}
+
+parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx, uint8_t *store, size_t store_size) {
+    tx_parser_t parser;
+    transaction_parser_init(&parser, store, store_size, NULL, NULL);
+
+    return transaction_parser_feed(&parser, tx, buf, true);
 }
@@ -1,8 +1,56 @@
 #pragma once
 
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+
 #include "types.h"
 #include "common/buffer.h"
 
+/**
+ * Initialize the resumable transaction parser.
+ *
+ * @param[out] parser
+ *   Pointer to parser state.
+ * @param[in]  store
+ *   Buffer receiving the transaction fields that are referenced by transaction_t
+ *   (signer accounts, allowed contracts and groups, script).
+ * @param[in]  store_size
+ *   Size of the store. It bounds the signers of the transaction, not its length: a script that doesn't fit is only
+ *   hashed, and transaction_t.script is NULL.
+ * @param[in]  tx_hash
+ *   Initialized SHA-256 context, updated with every parsed byte of the transaction. May be NULL.
+ * @param[in]  script_hash
+ *   Initialized SHA-256 context, updated with the script of the transaction as it is parsed. May be NULL.
+ *
+ */
+void transaction_parser_init(tx_parser_t *parser,
+                             uint8_t *store,
+                             size_t store_size,
+                             struct cx_sha256_s *tx_hash,
+                             struct cx_sha256_s *script_hash);
+
+/**
+ * Feed the next chunk of a serialized transaction to the parser.
+ *
+ * Fields may be split over any number of chunks. A malformed field is reported by the chunk it completes in,
+ * without waiting for the rest of the transaction. The hash contexts given to transaction_parser_init() are
+ * updated along the way, they only need to be finalized after the last chunk.
+ *
+ * @param[in, out] parser
+ *   Pointer to parser state, initialized by transaction_parser_init().
+ * @param[out]     tx
+ *   Pointer to transaction structure, zeroed before the first chunk.
+ * @param[in, out] buf
+ *   Pointer to buffer with the chunk. It is fully consumed unless an error is returned.
+ * @param[in]      last
+ *   Whether this is the last chunk of the transaction.
+ *
+ * @return PARSING_OK if the chunk is valid (and for the last chunk, the transaction is complete),
+ * error status otherwise.
+ *
+ */
+parser_status_e transaction_parser_feed(tx_parser_t *parser, transaction_t *tx, buffer_t *buf, bool last);
+
 /**
  * Deserialize raw transaction in structure.
  *
@@ -10,8 +58,12 @@
  *   Pointer to buffer with serialized transaction.
  * @param[out]     tx
  *   Pointer to transaction structure.
+ * @param[in]      store
+ *   Buffer receiving the transaction fields referenced by 'tx', see transaction_parser_init().
+ * @param[in]      store_size
+ *   Size of the store.
  *
  * @return PARSING_OK if success, error status otherwise.
  *
  */
-parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx);
+parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx, uint8_t *store, size_t store_size);
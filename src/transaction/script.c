@@ -0,0 +1,202 @@
+#include "script.h"
+#include "common/read.h"
+
+#include <string.h>
+
+const uint8_t SYSCALL_CONTRACT_CALL[SYSCALL_ID_LEN] = {0x62, 0x7d, 0x5b, 0x52};  // id 'System.Contract.Call'
+
+bool vm_decode(buffer_t *script, vm_instruction_t *ins) {
+    if (!buffer_read_u8(script, &ins->opcode)) {
+        return false;
+    }
+
+    uint32_t len = 0;
+    switch (ins->opcode) {
+        case OPCODE_PUSHINT8:
+            len = 1;
+            break;
+        case OPCODE_PUSHINT16:
+            len = 2;
+            break;
+        case OPCODE_PUSHINT32:
+        case OPCODE_PUSHA:
+        case OPCODE_SYSCALL:
+            len = 4;
+            break;
+        case OPCODE_PUSHINT64:
+            len = 8;
+            break;
+        case OPCODE_PUSHINT128:
+            len = 16;
+            break;
+        case OPCODE_PUSHINT256:
+            len = 32;
+            break;
+        case OPCODE_PUSHDATA1: {
+            uint8_t data_len;
+            if (!buffer_read_u8(script, &data_len)) {
+                return false;
+            }
+            len = data_len;
+            break;
+        }
+        case OPCODE_PUSHDATA2: {
+            uint16_t data_len;
+            if (!buffer_read_u16(script, &data_len, LE)) {
+                return false;
+            }
+            len = data_len;
+            break;
+        }
+        case OPCODE_PUSHDATA4:
+            if (!buffer_read_u32(script, &len, LE)) {
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (!buffer_can_read(script, len)) {
+        return false;
+    }
+    ins->operand = script->ptr + script->offset;
+    ins->operand_len = len;
+    buffer_seek_cur(script, len);
+
+    return true;
+}
+
+/**
+ * Integer value of an instruction pushing an integer of at most 64 bits.
+ *
+ * @return true if success, false if the instruction is not such a push.
+ */
+static bool vm_integer_value(const vm_instruction_t *ins, int64_t *value) {
+    if (ins->opcode >= OPCODE_PUSH0 && ins->opcode <= OPCODE_PUSH16) {
+        *value = ins->opcode - OPCODE_PUSH0;
+        return true;
+    }
+
+    switch (ins->opcode) {
+        case OPCODE_PUSHINT8:
+            *value = (int8_t) ins->operand[0];
+            return true;
+        case OPCODE_PUSHINT16:
+            *value = read_s16_le(ins->operand, 0);
+            return true;
+        case OPCODE_PUSHINT32:
+            *value = read_s32_le(ins->operand, 0);
+            return true;
+        case OPCODE_PUSHINT64:
+            *value = read_s64_le(ins->operand, 0);
+            return true;
+        default:  // we do not support INT128 and INT256 values on Ledger
+            return false;
+    }
+}
+
+static bool script_match_step(const script_step_t *step, const vm_instruction_t *ins, script_capture_t *captures) {
+    int64_t value = 0;
+
+    switch (step->match) {
+        case MATCH_OPCODE:
+            if (ins->opcode != step->opcode) {
+                return false;
+            }
+            break;
+        case MATCH_BYTES:
+            if (ins->opcode != step->opcode || ins->operand_len != step->operand_len ||
+                memcmp(ins->operand, step->operand, step->operand_len) != 0) {
+                return false;
+            }
+            break;
+        case MATCH_DATA:
+            if (ins->opcode != step->opcode || ins->operand_len != step->operand_len) {
+                return false;
+            }
+            break;
+        case MATCH_INTEGER:
+            if (!vm_integer_value(ins, &value)) {
+                return false;
+            }
+            break;
+        case MATCH_NULL_OR_POINT:
+            if (ins->opcode == OPCODE_PUSHNULL) {
+                break;
+            }
+            // compressed public keys must start with 0x02 or 0x03
+            if (ins->opcode != OPCODE_PUSHDATA1 || ins->operand_len != 33 ||
+                (ins->operand[0] != 0x02 && ins->operand[0] != 0x03)) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    if (step->capture != CAPTURE_NONE) {
+        captures[step->capture].data = (ins->opcode == OPCODE_PUSHNULL) ? NULL : ins->operand;
+        captures[step->capture].len = ins->operand_len;
+        captures[step->capture].value = value;
+    }
+    return true;
+}
+
+int script_match(const uint8_t *script,
+                 size_t script_len,
+                 const script_template_t *templates,
+                 uint8_t templates_count,
+                 script_capture_t *captures,
+                 script_pass_cb_t on_pass,
+                 void *ctx) {
+    uint8_t position[MAX_SCRIPT_TEMPLATES] = {0};  // next step of each template
+    uint8_t passes[MAX_SCRIPT_TEMPLATES] = {0};    // complete passes of each template
+    uint8_t alive = 0;                             // bit set of the templates still matching
+
+    if (templates_count > MAX_SCRIPT_TEMPLATES) {
+        return -1;
+    }
+    for (uint8_t t = 0; t < templates_count; t++) {
+        alive |= 1 << t;
+    }
+
+    buffer_t buf = {.ptr = script, .size = script_len, .offset = 0};
+    vm_instruction_t ins;
+    while (alive != 0 && buf.offset < buf.size) {
+        if (!vm_decode(&buf, &ins)) {
+            return -1;
+        }
+
+        for (uint8_t t = 0; t < templates_count; t++) {
+            if ((alive & (1 << t)) == 0) {
+                continue;
+            }
+            // a template that is already complete doesn't allow extra code after it
+            if (position[t] == templates[t].steps_count ||
+                !script_match_step(&templates[t].steps[position[t]], &ins, captures)) {
+                alive &= ~(1 << t);
+                continue;
+            }
+            if (++position[t] < templates[t].steps_count) {
+                continue;
+            }
+            if (on_pass != NULL && !on_pass(t, passes[t], captures, ctx)) {
+                alive &= ~(1 << t);
+                continue;
+            }
+            // start over when another pass is allowed, stay complete otherwise
+            if (++passes[t] < templates[t].max_passes) {
+                position[t] = 0;
+            }
+        }
+    }
+
+    for (uint8_t t = 0; t < templates_count; t++) {
+        if ((alive & (1 << t)) != 0 && passes[t] > 0 &&
+            (position[t] == 0 || position[t] == templates[t].steps_count)) {
+            return t;
+        }
+    }
+    return -1;
+}
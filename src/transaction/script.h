@@ -0,0 +1,156 @@
+#pragma once
+
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "common/buffer.h"
+
+/**
+ * NeoVM opcodes used by the script templates.
+ */
+typedef enum {
+    OPCODE_PUSHINT8 = 0x00,
+    OPCODE_PUSHINT16 = 0x01,
+    OPCODE_PUSHINT32 = 0x02,
+    OPCODE_PUSHINT64 = 0x03,
+    OPCODE_PUSHINT128 = 0x04,
+    OPCODE_PUSHINT256 = 0x05,
+    OPCODE_PUSHA = 0x0A,
+    OPCODE_PUSHNULL = 0x0B,
+    OPCODE_PUSHDATA1 = 0x0C,
+    OPCODE_PUSHDATA2 = 0x0D,
+    OPCODE_PUSHDATA4 = 0x0E,
+    OPCODE_PUSHM1 = 0x0F,
+    OPCODE_PUSH0 = 0x10,
+    OPCODE_PUSH2 = 0x12,
+    OPCODE_PUSH4 = 0x14,
+    OPCODE_PUSH15 = 0x1F,
+    OPCODE_PUSH16 = 0x20,
+    OPCODE_SYSCALL = 0x41,
+    OPCODE_PACK = 0xC0
+} vm_opcode_e;
+
+/**
+ * Length of the interop service id operand of SYSCALL.
+ */
+#define SYSCALL_ID_LEN 4
+
+/**
+ * Interop service id of System.Contract.Call, the SYSCALL of contract calls.
+ */
+extern const uint8_t SYSCALL_CONTRACT_CALL[SYSCALL_ID_LEN];
+
+/**
+ * A decoded NeoVM instruction.
+ */
+typedef struct {
+    uint8_t opcode;
+    const uint8_t *operand;  // PUSHINT value, PUSHDATA data (without length prefix) or SYSCALL id
+    uint32_t operand_len;
+} vm_instruction_t;
+
+/**
+ * How a template step compares an instruction.
+ */
+typedef enum {
+    MATCH_OPCODE,         /// opcode only
+    MATCH_BYTES,          /// opcode and operand equal to 'operand'
+    MATCH_DATA,           /// opcode with an operand of 'operand_len' bytes
+    MATCH_INTEGER,        /// any push of an integer up to 64 bits (PUSH0-PUSH16, PUSHINT8-PUSHINT64)
+    MATCH_NULL_OR_POINT,  /// PUSHNULL, or PUSHDATA1 of a compressed ECPoint
+} script_match_e;
+
+/**
+ * Capture slot value for steps that don't capture.
+ */
+#define CAPTURE_NONE 0xFF
+
+/**
+ * Maximum number of templates matched together.
+ */
+#define MAX_SCRIPT_TEMPLATES 8
+
+/**
+ * One instruction of a script template.
+ */
+typedef struct {
+    uint8_t opcode;          // expected opcode, unused by MATCH_INTEGER and MATCH_NULL_OR_POINT
+    uint8_t match;           // script_match_e
+    uint8_t capture;         // capture slot receiving the operand, or CAPTURE_NONE
+    uint8_t operand_len;     // expected operand length for MATCH_BYTES and MATCH_DATA
+    const uint8_t *operand;  // expected operand for MATCH_BYTES
+} script_step_t;
+
+/**
+ * Operand captured by a template step.
+ * 'data' is NULL for a PUSHNULL matched by MATCH_NULL_OR_POINT.
+ */
+typedef struct {
+    const uint8_t *data;
+    uint32_t len;
+    int64_t value;  // integer value for MATCH_INTEGER
+} script_capture_t;
+
+/**
+ * A script template: the exact sequence of instructions a script must consist of, possibly repeated back to back.
+ * The capture slots are shared by all templates matched together, each template must use its own slots.
+ */
+typedef struct {
+    const script_step_t *steps;
+    uint8_t steps_count;
+    uint8_t max_passes;  // maximum number of times the steps may be repeated, 0 is the same as 1
+} script_template_t;
+
+/**
+ * Called each time a template has matched a full pass of its steps.
+ * The captures of the template are overwritten by the next pass, so they must be used right away.
+ *
+ * @return true to go on matching the template, false to reject it.
+ */
+typedef bool (*script_pass_cb_t)(uint8_t template_index, uint8_t pass, const script_capture_t *captures, void *ctx);
+
+/**
+ * Decode the next instruction of a script.
+ *
+ * Operand sizes are only known for the push instructions and SYSCALL, the only ones with operands the templates use.
+ * Other opcodes are decoded as having no operand, which is harmless as no template step accepts them.
+ *
+ * @param[in, out] script
+ *   Pointer to script buffer, advanced past the instruction.
+ * @param[out]     ins
+ *   Pointer to the decoded instruction.
+ *
+ * @return true if success, false if the script ends within the instruction.
+ *
+ */
+bool vm_decode(buffer_t *script, vm_instruction_t *ins);
+
+/**
+ * Match a script against templates, decoding the script once and advancing all templates in lockstep.
+ *
+ * @param[in]  script
+ *   Pointer to the script.
+ * @param[in]  script_len
+ *   Length of the script.
+ * @param[in]  templates
+ *   Templates to match, the first one matching wins.
+ * @param[in]  templates_count
+ *   Number of templates, at most MAX_SCRIPT_TEMPLATES.
+ * @param[out] captures
+ *   Capture slots, filled in for the matching template.
+ * @param[in]  on_pass
+ *   Callback for each complete pass of a template, or NULL.
+ * @param[in]  ctx
+ *   Context passed to 'on_pass'.
+ *
+ * @return index of the matching template, or -1 if none matches.
+ *
+ */
+int script_match(const uint8_t *script,
+                 size_t script_len,
+                 const script_template_t *templates,
+                 uint8_t templates_count,
+                 script_capture_t *captures,
+                 script_pass_cb_t on_pass,
+                 void *ctx);
@@ -0,0 +1,48 @@
+#include "tokens.h"
+
+#include <string.h>
+
+// clang-format off
+// NEO 0xef4073a0f2b305a38ec4050e4d3d28bc40ea63f5
+#define NEO_SCRIPT_HASH_BYTES \
+    {0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05, 0xc4, 0x8e, 0xa3, 0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef}
+
+const uint8_t NEO_SCRIPT_HASH[UINT160_LEN] = NEO_SCRIPT_HASH_BYTES;
+
+const token_info_t TOKENS[] = {
+    // fUSDT 0xcd48b160c1bbc9d74997b803b9a7ad50a4bef020
+    {{0x20, 0xf0, 0xbe, 0xa4, 0x50, 0xad, 0xa7, 0xb9, 0x03, 0xb8, 0x97, 0x49, 0xd7, 0xc9, 0xbb, 0xc1, 0x60, 0xb1, 0x48, 0xcd},
+     "fUSDT", 6},
+    // FLM 0xf0151f528127558851b39c2cd8aa47da7418ab28
+    {{0x28, 0xab, 0x18, 0x74, 0xda, 0x47, 0xaa, 0xd8, 0x2c, 0x9c, 0xb3, 0x51, 0x88, 0x55, 0x27, 0x81, 0x52, 0x1f, 0x15, 0xf0},
+     "FLM", 8},
+    // bNEO 0x48c40d4666f93408be1bef038b6722404d9a4c2a
+    {{0x2a, 0x4c, 0x9a, 0x4d, 0x40, 0x22, 0x67, 0x8b, 0x03, 0xef, 0x1b, 0xbe, 0x08, 0x34, 0xf9, 0x66, 0x46, 0x0d, 0xc4, 0x48},
+     "bNEO", 8},
+    // GAS 0xd2a4cff31913016155e38e474a2c06d08be276cf
+    {{0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e, 0xe3, 0x55, 0x61, 0x01, 0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2},
+     "GAS", 8},
+    {NEO_SCRIPT_HASH_BYTES, "NEO", 0},
+};
+// clang-format on
+
+const size_t TOKENS_COUNT = sizeof(TOKENS) / sizeof(token_info_t);
+
+const token_info_t *token_lookup(const uint8_t *script_hash) {
+    size_t low = 0;
+    size_t high = TOKENS_COUNT;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        int cmp = memcmp(script_hash, TOKENS[mid].script_hash, UINT160_LEN);
+        if (cmp == 0) {
+            return &TOKENS[mid];
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return NULL;
+}
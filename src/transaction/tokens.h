@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint*_t
+
+#include "transaction_types.h"
+
+/**
+ * Maximum length of a token ticker, including the terminating null byte.
+ */
+#define MAX_TICKER_LEN 8
+
+/**
+ * A NEP-17 token known to the app.
+ */
+typedef struct token_info_s {
+    uint8_t script_hash[UINT160_LEN];  // contract script hash, in script byte order (reversed from the 0x... notation)
+    char ticker[MAX_TICKER_LEN];
+    uint8_t decimals;
+} token_info_t;
+
+/**
+ * Script hash of the NEO contract, in script byte order, the one of its entry in the registry.
+ */
+extern const uint8_t NEO_SCRIPT_HASH[UINT160_LEN];
+
+/**
+ * The token registry, sorted by script hash as compared by memcmp.
+ */
+extern const token_info_t TOKENS[];
+extern const size_t TOKENS_COUNT;
+
+/**
+ * Find a token of the registry by its script hash.
+ *
+ * @param[in] script_hash
+ *   Pointer to the contract script hash (UINT160_LEN bytes), in script byte order.
+ *
+ * @return pointer to the registry entry, or NULL if the token is not registered.
+ *
+ */
+const token_info_t *token_lookup(const uint8_t *script_hash);
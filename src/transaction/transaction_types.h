@@ -10,19 +10,17 @@
 
 /**
  * Maximum signer_t count in a transaction.
- * Actual network value is 16, we limit it because we run out of SRAM
  * The individual signers must be unique as compared by the account field.
  */
-#define MAX_TX_SIGNERS 2
+#define MAX_TX_SIGNERS 16
 /**
  * The minimum number of signers. First signer is always the sender of the tx
  */
 #define MIN_TX_SIGNERS 1
 /**
  * Limits the maximum 'allowed_groups' of a signer_t
- * Actual network value is 16, we limit it because we run out of SRAM
  */
-#define MAX_SIGNER_ALLOWED_GROUPS 2
+#define MAX_SIGNER_ALLOWED_GROUPS 16
 
 /**
  * Limits the maximum 'allowed_contracts' of a signer_t
@@ -34,8 +32,6 @@
  * The NEO network actually limits the attributes to (16 - signers count).
  * However, there currently only exist 2 attribute types, both can only be attached once
  * thus we limit the size to 2.
- *
- * The 16 magic is also reduced to 8 (see @MAX_TX_SIGNERS) due to SRAM limitation being reached.
  */
 #define MAX_ATTRIBUTES 2
 
@@ -81,13 +77,18 @@ typedef enum {
     GLOBAL = 0x80
 } witness_scope_e;
 
+/**
+ * A transaction signer. To keep the signer array small enough for the network limits, the account, allowed contracts
+ * and allowed groups are referenced by their offset in the transaction store (see transaction_t.data) instead of by
+ * pointer. The allowed contracts and the allowed groups of a signer are each stored back to back.
+ */
 typedef struct {
-    uint8_t *account;  // UInt160, 20 bytes
-    witness_scope_e scope;
-    uint8_t *allowed_contracts[MAX_SIGNER_ALLOWED_CONTRACTS];  // array of UInt160s
+    uint16_t account;            // offset of the UInt160, 20 bytes
+    uint16_t allowed_contracts;  // offset of the first UInt160 in the array of allowed contracts
+    uint16_t allowed_groups;     // offset of the first ECPoint (compressed format, 33 bytes) of allowed groups
     uint8_t allowed_contracts_size;
-    uint8_t *allowed_groups[MAX_SIGNER_ALLOWED_GROUPS];  // array of ECPoints in compressed format, 33 bytes
     uint8_t allowed_groups_size;
+    uint8_t scope;  // witness_scope_e
 } signer_t;
 
 typedef enum {
@@ -100,7 +101,25 @@ typedef struct {
     // might expand this later if new attributes are introduced to have data beyond a type
 } attribute_t;
 
+/**
+ * Maximum number of NEP-17 transfers recognized in a single script.
+ */
+#define MAX_TX_TRANSFERS 16
+
+struct token_info_s;
+
+/**
+ * A NEP-17 transfer call of the script.
+ * The destination is formatted as an address only when displayed.
+ */
 typedef struct {
+    const struct token_info_s *token;  // the registered token 'transfer' is called on (see tokens.h)
+    int64_t amount;                    // transfer amount
+    uint16_t destination;              // offset in 'script' of the destination script hash
+} transfer_t;
+
+typedef struct {
+    const uint8_t *data;  // transaction store the signer offsets refer to
     uint8_t version;
     uint32_t nonce;
     int64_t system_fee;
@@ -110,13 +129,65 @@ typedef struct {
     uint8_t signers_size;  // the actual signers count after parsing
     attribute_t attributes[MAX_ATTRIBUTES];
     uint8_t attributes_size;  // the actual attributes count after parsing
-    uint8_t *script;          // VM opcodes
+    uint8_t *script;          // VM opcodes, NULL if the script was too long for the store
     uint16_t script_size;
-    bool is_system_asset_transfer;  // indicates if the instructions in `script` match a standard GAS or NEO transfer
-    bool is_neo;                    // indicates if 'transfer' is called on the NEO contract. False means GAS contract
-    int64_t amount;                 // transfer amount
-    uint8_t dst_address[ADDRESS_LEN];
+    bool is_token_transfer;  // indicates if the instructions in `script` are only standard NEP-17 transfers
+    transfer_t transfers[MAX_TX_TRANSFERS];
+    uint8_t transfers_size;  // the actual transfers count after parsing
     bool is_vote_script;
     bool is_remove_vote;
     uint8_t vote_to[ECPOINT_LEN];
 } transaction_t;
+
+/**
+ * Position of the transaction parser, in the order the fields appear in the serialized transaction.
+ */
+typedef enum {
+    TX_STEP_VERSION,
+    TX_STEP_NONCE,
+    TX_STEP_SYSTEM_FEE,
+    TX_STEP_NETWORK_FEE,
+    TX_STEP_VALID_UNTIL_BLOCK,
+    TX_STEP_SIGNERS_LENGTH,
+    TX_STEP_SIGNER_ACCOUNT,
+    TX_STEP_SIGNER_SCOPE,
+    TX_STEP_CONTRACTS_LENGTH,
+    TX_STEP_CONTRACT,
+    TX_STEP_GROUPS_LENGTH,
+    TX_STEP_GROUP,
+    TX_STEP_ATTRIBUTES_LENGTH,
+    TX_STEP_ATTRIBUTE,
+    TX_STEP_SCRIPT_LENGTH,
+    TX_STEP_SCRIPT,
+    TX_STEP_DONE
+} tx_parser_step_e;
+
+/**
+ * Largest fixed size field that can be split over two chunks (a varint with 0xFF prefix).
+ */
+#define TX_PARSER_CARRY_LEN 9
+
+struct cx_sha256_s;
+
+/**
+ * State of the resumable transaction parser, kept across the APDU chunks of a transaction.
+ *
+ * Fixed size fields (version, nonce, fees, scope, varints) that straddle a chunk boundary are gathered in 'carry'.
+ * Variable data that must outlive the chunk it arrived in (accounts, allowed contracts and groups, script) is copied
+ * to 'store', which transaction_t refers to, except a script too long for it, which is only hashed.
+ * The optional hash contexts are updated with the transaction and script bytes as they are parsed.
+ */
+typedef struct {
+    tx_parser_step_e step;
+    uint8_t signer_index;     // signer currently being parsed
+    uint8_t item_index;       // allowed contract, allowed group or attribute currently being parsed
+    uint16_t blob_remaining;  // bytes still to copy to 'store' for the current account, contract, group or script
+    bool blob_hashed_only;    // the script is too long for 'store', it is only hashed
+    uint8_t carry[TX_PARSER_CARRY_LEN];
+    uint8_t carry_len;
+    uint8_t *store;
+    uint16_t store_size;
+    uint16_t store_len;
+    struct cx_sha256_s *tx_hash;      // hash of the signed data portion of the transaction, or NULL
+    struct cx_sha256_s *script_hash;  // hash of the script, or NULL
+} tx_parser_t;
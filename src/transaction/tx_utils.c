@@ -1,176 +1,138 @@
+#include "cx.h"
+
 #include "tx_utils.h"
-#include "ui/utils.h"
+#include "script.h"
+#include "tokens.h"
 
 #include <string.h>
 
-typedef union {
-    uint8_t u8;
-    int8_t s8;
-    uint16_t u16;
-    int16_t s16;
-    int32_t s32;
-    int64_t s64;
-} data;
-data s;
-
-void try_parse_transfer_script(buffer_t *script, transaction_t *tx) {
-    if (!buffer_read_u8(script, &s.u8)) return;
-
-    // first byte should be 0xb (OpCode.PUSHNULL), indicating no data for the Nep17.transfer() 'data' argument
-    if (s.u8 != 0xB) return;
-
-    if (!buffer_read_u8(script, &s.u8)) return;
-
-    // OpCode.PUSH0 - OpCode.PUSH16
-    if (s.u8 >= 0x10 && s.u8 <= 0x20) {
-        tx->amount = (int64_t) s.u8 - 0x10;
-    } else if (s.u8 == 0x00) {  // OpCode.PUSHINT8
-        if (!buffer_read_s8(script, &s.s8)) return;
-        tx->amount = (int64_t) s.u8;
-    } else if (s.u8 == 0x01) {  // OpCode.PUSHINT16
-        if (!buffer_read_s16(script, &s.s16, LE)) return;
-        tx->amount = (int64_t) s.s16;
-    } else if (s.u8 == 0x2) {  // OpCode.PUSHINT32
-        if (!buffer_read_s32(script, &s.s32, LE)) return;
-        tx->amount = (int64_t) s.s32;
-    } else if (s.u8 == 0x3) {  // OpCode.PUSHINT64
-        if (!buffer_read_s64(script, &s.s64, LE)) return;
-        tx->amount = s.s64;
-    } else {  // we do not support INT128 and INT256 values on Ledger
-        return;
+// clang-format off
+static const uint8_t METHOD_TRANSFER[] = {'t', 'r', 'a', 'n', 's', 'f', 'e', 'r'};
+static const uint8_t METHOD_VOTE[] = {'v', 'o', 't', 'e'};
+// clang-format on
+
+/**
+ * Capture slots of the templates, each template has its own.
+ */
+enum {
+    CAPTURE_TRANSFER_AMOUNT,
+    CAPTURE_TRANSFER_TO,
+    CAPTURE_TRANSFER_CONTRACT,
+    CAPTURE_VOTE_TO,
+    CAPTURES_COUNT
+};
+
+#define STEP_OPCODE(op) {.opcode = (op), .match = MATCH_OPCODE, .capture = CAPTURE_NONE}
+#define STEP_BYTES(op, bytes) \
+    {.opcode = (op), .match = MATCH_BYTES, .capture = CAPTURE_NONE, .operand_len = sizeof(bytes), .operand = (bytes)}
+#define STEP_DATA(op, len, slot) {.opcode = (op), .match = MATCH_DATA, .capture = (slot), .operand_len = (len)}
+
+/**
+ * NEP-17 transfer(from, to, amount, data), with no data, repeated for batches of transfers
+ */
+static const script_step_t TRANSFER_STEPS[] = {
+    STEP_OPCODE(OPCODE_PUSHNULL),                                           // 'data' argument
+    {.match = MATCH_INTEGER, .capture = CAPTURE_TRANSFER_AMOUNT},           // amount
+    STEP_DATA(OPCODE_PUSHDATA1, UINT160_LEN, CAPTURE_TRANSFER_TO),          // destination script hash
+    STEP_DATA(OPCODE_PUSHDATA1, UINT160_LEN, CAPTURE_NONE),                 // source script hash
+    STEP_OPCODE(OPCODE_PUSH4),                                              // we pack the 4 arguments
+    STEP_OPCODE(OPCODE_PACK),                                               //
+    STEP_OPCODE(OPCODE_PUSH15),                                             // CallFlags
+    STEP_BYTES(OPCODE_PUSHDATA1, METHOD_TRANSFER),                          // contract method name
+    STEP_DATA(OPCODE_PUSHDATA1, UINT160_LEN, CAPTURE_TRANSFER_CONTRACT),    // contract script hash
+    STEP_BYTES(OPCODE_SYSCALL, SYSCALL_CONTRACT_CALL),
+};
+
+/**
+ * NEO vote(account, vote_to), where a null 'vote_to' removes the vote
+ */
+static const script_step_t VOTE_STEPS[] = {
+    {.match = MATCH_NULL_OR_POINT, .capture = CAPTURE_VOTE_TO},  // candidate public key
+    STEP_DATA(OPCODE_PUSHDATA1, UINT160_LEN, CAPTURE_NONE),      // account script hash
+    STEP_OPCODE(OPCODE_PUSH2),                                   // we pack the 2 arguments
+    STEP_OPCODE(OPCODE_PACK),                                    //
+    STEP_OPCODE(OPCODE_PUSH15),                                  // CallFlags
+    STEP_BYTES(OPCODE_PUSHDATA1, METHOD_VOTE),                   // contract method name
+    STEP_BYTES(OPCODE_PUSHDATA1, NEO_SCRIPT_HASH),               // contract script hash
+    STEP_BYTES(OPCODE_SYSCALL, SYSCALL_CONTRACT_CALL),
+};
+
+enum { TEMPLATE_TRANSFER, TEMPLATE_VOTE };
+
+static const script_template_t SCRIPT_TEMPLATES[] = {
+    [TEMPLATE_TRANSFER] = {.steps = TRANSFER_STEPS,
+                           .steps_count = sizeof(TRANSFER_STEPS) / sizeof(script_step_t),
+                           .max_passes = MAX_TX_TRANSFERS},
+    [TEMPLATE_VOTE] = {.steps = VOTE_STEPS, .steps_count = sizeof(VOTE_STEPS) / sizeof(script_step_t)},
+};
+
+static bool record_transfer(uint8_t template_index, uint8_t pass, const script_capture_t *captures, void *ctx) {
+    transaction_t *tx = (transaction_t *) ctx;
+
+    if (template_index != TEMPLATE_TRANSFER) {
+        return true;
     }
 
-    // check for destination script hash
-    if (!buffer_read_u16(script, &s.u16, BE)) return;
-    if (s.u16 != 0x0C14) return;  // PUSHDATA1 , 20 bytes length for destination script hash
-
-    uint8_t *script_hash;
-    script_hash = (uint8_t *) (script->ptr + script->offset);
-    if (!buffer_seek_cur(script, UINT160_LEN)) return;
-
-    // parse and store destination address
-    script_hash_to_address((char *) tx->dst_address, sizeof(tx->dst_address), script_hash);
-
-    // check for source script hash
-    if (!buffer_read_u16(script, &s.u16, BE)) return;
-    if (s.u16 != 0x0C14) return;  // PUSHDATA1 , 20 bytes length for destination script hash
-    if (!buffer_seek_cur(script, UINT160_LEN)) return;
-
-    // clang-format off
-    uint8_t sequence[] = {
-        0x14,  // OpCode.PUSH4
-        0xC0,  // OpCode.PACK - we pack the 4 arguments to the transfer() method
-        0x1F,  // OpCode.PUSH15 - CallFlags
-        0x0C, 0x08,  // OpCode.PUSHDATA1, length 8 - contract method name
-        0x74, 0x72, 0x61, 0x6e, 0x73, 0x66, 0x65, 0x72,  // 'transfer'
-        0x0C, 0x14,  // OpCode.PUSHDATA1, length 20 - contract script hash
-    };
-
-    // we expect the above fixed sequence next
-    if (!buffer_can_read(script, sizeof(sequence))) return;
-    if (memcmp(script->ptr + script->offset, sequence, sizeof(sequence))) return;
-    buffer_seek_cur(script, sizeof(sequence));
-
-    // read contract script hash
-    // script_hash = (uint8_t *) (script->ptr + script->offset);
-    uint8_t neo_script_hash[] = {0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05,
-                                 0xc4, 0x8e, 0xa3, 0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef};
-    uint8_t gas_script_hash[] = {0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e,
-                                 0xe3, 0x55, 0x61, 0x01, 0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2};
-
-    if (!buffer_can_read(script, UINT160_LEN)) return;
-    if (!memcmp(script->ptr + script->offset, neo_script_hash, UINT160_LEN)) {
-        tx->is_neo = true;
-    } else if (memcmp(script->ptr + script->offset, gas_script_hash, UINT160_LEN)) {
-        // neither NEO or GAS, abort
-        return;
+    const token_info_t *token = token_lookup(captures[CAPTURE_TRANSFER_CONTRACT].data);
+    if (token == NULL) {
+        // not a registered token, we wouldn't know how to display the amount
+        return false;
     }
-    buffer_seek_cur(script, UINT160_LEN);
-
-    // finally make sure we end with a contract syscall
-
-    // clang-format off
-    uint8_t sequence2[] = {
-        0x41,  // OpCode.SYSCALL
-        0x62, 0x7d, 0x5b, 0x52  // id 'System.Contract.Call'
-    };
-
-    if (!buffer_can_read(script, sizeof(sequence2))) return;
-    if (memcmp(script->ptr + script->offset, sequence2, sizeof(sequence2)) != 0) return;
-    buffer_seek_cur(script, sizeof(sequence2));
-
-    // make sure there is no extra code after the transfer script
-    if (script->offset != tx->script_size) return;
 
-    // everything looks like a standard contract transfer for NEO/GAS and we were able to parse the amount + dst address
-    tx->is_system_asset_transfer = true;
+    transfer_t *transfer = &tx->transfers[pass];
+    transfer->token = token;
+    transfer->amount = captures[CAPTURE_TRANSFER_AMOUNT].value;
+    transfer->destination = captures[CAPTURE_TRANSFER_TO].data - tx->script;
+    tx->transfers_size = pass + 1;
+    return true;
 }
 
-void try_parse_vote_script(buffer_t *script, transaction_t *tx) {
-    if (!buffer_read_u8(script, &s.u8)) return;
-
-    // first byte should be 0xb (OpCode.PUSHNULL) when removing a vote, or 0x0C (OpCode.PUSHDATA1) followed by 0x21 (Length 33)
-    // indicating a 'vote_to' public key
-    if (s.u8 != 0xB && s.u8 != 0x0C) return;
-    
-    if (s.u8 == 0x0B) { // remove vote
+static void accept_vote(const script_capture_t *captures, transaction_t *tx) {
+    if (captures[CAPTURE_VOTE_TO].data == NULL) {
         tx->is_remove_vote = true;
-    } else { // add vote
-        if (!buffer_read_u8(script, &s.u8)) return;
-        if (s.u8 != 0x21) return; // PUSHDATA1 must be followed by 33 bytes of data for the compressed public key
-
-        uint8_t *public_key;
-        public_key = (uint8_t *) (script->ptr + script->offset);
-        if (!buffer_seek_cur(script, ECPOINT_LEN)) return;
-
-        // compressed public keys must start with 0x02 or 0x03
-        if (public_key[0] != 0x02 && public_key[0] != 0x03) return;
-        memcpy(tx->vote_to, public_key, ECPOINT_LEN);
+    } else {
+        memcpy(tx->vote_to, captures[CAPTURE_VOTE_TO].data, ECPOINT_LEN);
         tx->is_remove_vote = false;
     }
+    tx->is_vote_script = true;
+}
+
+void try_parse_script(transaction_t *tx) {
+    script_capture_t captures[CAPTURES_COUNT];
+
+    switch (script_match(tx->script,
+                         tx->script_size,
+                         SCRIPT_TEMPLATES,
+                         sizeof(SCRIPT_TEMPLATES) / sizeof(script_template_t),
+                         captures,
+                         record_transfer,
+                         tx)) {
+        case TEMPLATE_TRANSFER:
+            // every call of the script is a transfer of a registered token
+            tx->is_token_transfer = true;
+            break;
+        case TEMPLATE_VOTE:
+            accept_vote(captures, tx);
+            tx->transfers_size = 0;
+            break;
+        default:
+            tx->transfers_size = 0;
+            break;
+    }
+}
 
-    // check for source script hash
-    if (!buffer_read_u16(script, &s.u16, BE)) return;
-    if (s.u16 != 0x0C14) return;  // PUSHDATA1 , 20 bytes length for destination script hash
-    if (!buffer_seek_cur(script, UINT160_LEN)) return;
-
-    // clang-format off
-    uint8_t sequence[] = {
-        0x12,  // OpCode.PUSH2
-        0xC0,  // OpCode.PACK - we pack the 2 arguments to the vote() method
-        0x1F,  // OpCode.PUSH15 - CallFlags
-        0x0C, 0x04,  // OpCode.PUSHDATA1, length 4 - contract method name
-        0x76, 0x6f, 0x74, 0x65,  // 'vote'
-        0x0C, 0x14,  // OpCode.PUSHDATA1, length 20 - contract script hash
-    };
-
-    // we expect the above fixed sequence next
-    if (!buffer_can_read(script, sizeof(sequence))) return;
-    if (memcmp(script->ptr + script->offset, sequence, sizeof(sequence))) return;
-    buffer_seek_cur(script, sizeof(sequence));
-
-    // read contract script hash
-    uint8_t neo_script_hash[] = {0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05,
-                                 0xc4, 0x8e, 0xa3, 0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef};
-
-    if (!buffer_can_read(script, UINT160_LEN)) return;
-    if (memcmp(script->ptr + script->offset, neo_script_hash, UINT160_LEN)) return;
-    buffer_seek_cur(script, UINT160_LEN);
-
-    // finally make sure we end with a contract syscall
-
-    // clang-format off
-    uint8_t sequence2[] = {
-        0x41,  // OpCode.SYSCALL
-        0x62, 0x7d, 0x5b, 0x52  // id 'System.Contract.Call'
-    };
-
-    if (!buffer_can_read(script, sizeof(sequence2))) return;
-    if (memcmp(script->ptr + script->offset, sequence2, sizeof(sequence2)) != 0) return;
-    buffer_seek_cur(script, sizeof(sequence2));
-
-    // make sure there is no extra code after the vote script
-    if (script->offset != tx->script_size) return;
+void tx_hash_update(struct cx_sha256_s *hash, const uint8_t *data, size_t len) {
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) hash, 0 /*mode*/, data, len, NULL /* hash out*/, 0 /* hash out len */));
+}
 
-    tx->is_vote_script = true;
-}
\ No newline at end of file
+const uint8_t *signer_account(const transaction_t *tx, const signer_t *signer) {
+    return tx->data + signer->account;
+}
+
+const uint8_t *signer_allowed_contract(const transaction_t *tx, const signer_t *signer, uint8_t index) {
+    return tx->data + signer->allowed_contracts + index * UINT160_LEN;
+}
+
+const uint8_t *signer_allowed_group(const transaction_t *tx, const signer_t *signer, uint8_t index) {
+    return tx->data + signer->allowed_groups + index * ECPOINT_LEN;
+}
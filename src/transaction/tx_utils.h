@@ -1,6 +1,28 @@
 #include "common/buffer.h"
 #include "types.h"
 
-void try_parse_transfer_script(buffer_t *script, transaction_t *tx);
+/**
+ * Recognize the script of 'tx' as transfers of registered NEP-17 tokens or a NEO vote, and fill in the
+ * corresponding fields of 'tx'. Other scripts leave 'tx' untouched.
+ */
+void try_parse_script(transaction_t *tx);
 
-void try_parse_vote_script(buffer_t *script, transaction_t *tx);
\ No newline at end of file
+/**
+ * Add 'len' bytes of 'data' to a running SHA-256.
+ */
+void tx_hash_update(struct cx_sha256_s *hash, const uint8_t *data, size_t len);
+
+/**
+ * Account (UInt160) of a signer of 'tx'.
+ */
+const uint8_t *signer_account(const transaction_t *tx, const signer_t *signer);
+
+/**
+ * Allowed contract (UInt160) 'index' of a signer of 'tx'.
+ */
+const uint8_t *signer_allowed_contract(const transaction_t *tx, const signer_t *signer, uint8_t index);
+
+/**
+ * Allowed group (ECPoint in compressed format) 'index' of a signer of 'tx'.
+ */
+const uint8_t *signer_allowed_group(const transaction_t *tx, const signer_t *signer, uint8_t index);
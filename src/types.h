@@ -19,10 +19,14 @@ typedef enum {
  * Enumeration with expected INS of APDU commands.
  */
 typedef enum {
-    GET_APP_NAME = 0x0,    /// name of the application
-    GET_VERSION = 0x01,    /// version of the application
-    SIGN_TX = 0x02,        /// sign transaction with BIP44 path and return signature
-    GET_PUBLIC_KEY = 0x04  /// public key of corresponding BIP44 path and return uncompressed public key
+    GET_APP_NAME = 0x0,              /// name of the application
+    GET_VERSION = 0x01,              /// version of the application
+    SIGN_TX = 0x02,                  /// sign transaction with BIP44 path and return signature
+    GET_PUBLIC_KEY = 0x04,           /// public key of corresponding BIP44 path and return uncompressed public key
+    GET_PUBLIC_KEYS = 0x05,          /// public keys of a range of address indexes, returned page by page
+    GET_EXTENDED_PUBLIC_KEY = 0x06,  /// public key and chain code of corresponding BIP44 account
+    SIGN_TX_BATCH = 0x07,            /// sign the transactions of a batch approved once and return their signatures
+    GET_ADDRESS = 0x08               /// address of corresponding BIP44 path, optionally with script hash and public key
 } command_e;
 
 /**
@@ -48,24 +52,33 @@ typedef enum {
     STATE_APPROVED   /// Transaction data approved
 } state_e;
 
+/**
+ * Enumeration with the encodings of the signatures returned by SIGN_TX and SIGN_TX_BATCH.
+ */
+typedef enum {
+    SIG_FORMAT_DER,        /// ASN1.DER encoded signature
+    SIG_FORMAT_RS,         /// r || s, 64 bytes
+    SIG_FORMAT_INVOCATION  /// invocation script of the witness: PUSHDATA1 64 r || s
+} sig_format_e;
+
 /**
  * Enumeration with user request type.
  */
 typedef enum {
     CONFIRM_ADDRESS,     /// Confirm address derived from public key
-    CONFIRM_TRANSACTION  /// Confirm transaction information
+    CONFIRM_TRANSACTION,  /// Confirm transaction information
+    EXPORT_PUBLIC_KEYS,   /// Export the public keys of a range of address indexes
+    CONFIRM_BATCH         /// Confirm a batch of transactions, then sign them
 } request_type_e;
 
 /**
  * Structure for transaction information context.
  */
 typedef struct {
-    union {
-        uint8_t raw_tx[MAX_TRANSACTION_LEN];  /// Raw transaction serialized
-        uint8_t script_hash[32];
-    };
-    size_t raw_tx_len;                    /// Length of raw transaction
-    transaction_t transaction;            /// Structured transaction
+    uint8_t tx_data[TRANSACTION_STORE_LEN];  /// Transaction fields referenced by 'transaction', filled by 'parser'
+    tx_parser_t parser;                      /// Resumable parser, fed with each transaction chunk
+    transaction_t transaction;               /// Structured transaction
+    uint8_t script_hash[32];                 /// Hash of the transaction script
 
     /// Transaction hash digest
     /// This is just the hash of the tx signed data portion
@@ -75,6 +88,31 @@ typedef struct {
     uint8_t signature_len;               /// Length of transaction signature
 } transaction_ctx_t;
 
+/**
+ * Token of an approved batch, with the total amount the batch may transfer.
+ */
+typedef struct {
+    const struct token_info_s *token;  /// Registered token (see transaction/tokens.h)
+    uint64_t total;                    /// Approved total amount
+    uint64_t spent;                    /// Amount transferred by the transactions signed so far
+} batch_token_t;
+
+/**
+ * Structure for the context of a batch of transactions approved at once.
+ * Each transaction of the batch is signed only if it keeps within what the user approved.
+ */
+typedef struct {
+    uint8_t remaining;                                          /// Transactions left to sign
+    bool receiving;                                             /// A transaction is being received
+    uint8_t count;                                              /// Transactions count of the batch
+    uint64_t max_fees;                                          /// Approved total of the fees
+    uint64_t fees_spent;                                        /// Fees of the transactions signed so far
+    batch_token_t tokens[MAX_BATCH_TOKENS];                     /// Tokens the transactions may transfer
+    uint8_t tokens_size;                                        /// Number of tokens
+    uint8_t destinations[MAX_BATCH_DESTINATIONS][UINT160_LEN];  /// Accounts the transactions may transfer to
+    uint8_t destinations_size;                                  /// Number of destinations
+} batch_ctx_t;
+
 /**
  * Structure for global context.
  */
@@ -83,8 +121,15 @@ typedef struct {
     union {
         uint8_t raw_public_key[64];  /// x-coordinate (32), y-coodinate (32)
         transaction_ctx_t tx_info;   /// Transaction context
+        struct {
+            uint32_t next_index;  /// Address index of the next public key to export
+            uint8_t remaining;    /// Number of public keys left to export
+        } pubkeys;                /// Public keys export context
     };
     uint32_t network_magic;
     request_type_e req_type;              /// User request
     uint32_t bip44_path[BIP44_PATH_LEN];  /// BIP44 path
+    batch_ctx_t batch;                    /// Batch context, kept while its transactions are received
+    sig_format_e sig_format;              /// Encoding of the signatures to return
+    bool compressed_public_key;           /// Return the public key compressed (GET_PUBLIC_KEY)
 } global_ctx_t;
@@ -45,10 +45,7 @@ void ui_action_validate_transaction(bool approved, bool go_back_to_menu) {
             G_context.state = STATE_NONE;
             io_send_sw(SW_SIGN_FAIL);
         } else {
-            io_send_response(&(const buffer_t){.ptr = G_context.tx_info.signature,
-                                               .size = G_context.tx_info.signature_len,
-                                               .offset = 0},
-                             SW_OK);
+            helper_send_response_sig();
         }
     } else {
         G_context.state = STATE_NONE;
@@ -59,3 +56,18 @@ void ui_action_validate_transaction(bool approved, bool go_back_to_menu) {
         ui_menu_main();
     }
 }
+
+void ui_action_validate_batch(bool approved, bool go_back_to_menu) {
+    if (approved) {
+        G_context.state = STATE_APPROVED;
+        G_context.batch.remaining = G_context.batch.count;
+        io_send_sw(SW_OK);
+    } else {
+        G_context.state = STATE_NONE;
+        io_send_sw(SW_DENY);
+    }
+
+    if (go_back_to_menu) {
+        ui_menu_main();
+    }
+}
@@ -23,3 +23,15 @@ void ui_action_validate_pubkey(bool approved, bool go_back_to_menu);
  *
  */
 void ui_action_validate_transaction(bool approved, bool go_back_to_menu);
+
+/**
+ * Action for batch of transactions validation, the transactions of an approved batch are then signed as
+ * they are received.
+ *
+ * @param[in] approved
+ *   User approved or rejected.
+ * @param[in] go_back_to_menu
+ *   If the function must explicitly go back to the menu
+ *
+ */
+void ui_action_validate_batch(bool approved, bool go_back_to_menu);
@@ -30,37 +30,48 @@ enum e_state {
 };
 
 /**
- * Hold state around displaying Signers and their properties
+ * Parts of the flow made of dynamic screens, each between its own delimiters.
+ */
+enum e_section {
+    SECTION_TRANSFERS,    // transfers and their properties, see format_transfer_item()
+    SECTION_TRANSACTION,  // properties of the transaction itself, see format_tx_item()
+    SECTION_SIGNERS,      // signers and their properties, see format_signer_item()
+    SECTION_BATCH,        // batch description, see format_batch_item()
+    SECTIONS_COUNT,
+};
+
+/**
+ * Hold state around displaying Transfers, Signers and their properties
  */
 typedef struct display_ctx_s {
     enum e_state current_state;  // screen state
-    int8_t s_index;              // track which signer is to be displayed
-    uint8_t p_index;             // track which signer property is displayed (see also: e_signer_state)
-    int8_t c_index;              // track which signer.contract is to be displayed
-    int8_t g_index;              // track which signer.group is to be displayed
+    // Position in the properties of each section: 0 is before the first one,
+    // 1 to N are the N properties and N + 1 is past the last one
+    uint16_t item_index[SECTIONS_COUNT];
 } display_ctx_t;
 
 static display_ctx_t display_ctx;
 
-static void reset_signer_display_state() {
+/**
+ * Properties of the transaction displayed in SECTION_TRANSACTION, depending on the transaction and the settings
+ */
+static tx_item_e tx_items[TX_ITEM_SCRIPT_HASH + 1];
+static uint8_t tx_items_count;
+
+static void reset_display_state() {
     display_ctx.current_state = STATIC_SCREEN;
-    display_ctx.s_index = 0;
-    display_ctx.g_index = -1;
-    display_ctx.c_index = -1;
-    display_ctx.p_index = 0;
+    memset(display_ctx.item_index, 0, sizeof(display_ctx.item_index));
 }
 
 /**
- * Hold current dynamic content around displaying Signers and their properties
+ * Hold current dynamic content around displaying Transfers, Signers and their properties
  */
 static char g_title[64];
-static char g_text[64];
+static char g_text[ITEM_TEXT_MAX_SIZE];
 
 enum e_direction { DIRECTION_FORWARD, DIRECTION_BACKWARD };
 
-enum e_signer_state { START = 0, INDEX = 1, ACCOUNT = 2, SCOPE = 3, CONTRACTS = 4, GROUPS = 5, END = 6 };
-
-static enum e_signer_state signer_property[7] = {START, INDEX, ACCOUNT, SCOPE, CONTRACTS, GROUPS, END};
+enum e_dynamic_data { DYNAMIC_DATA_NONE, DYNAMIC_DATA_FOUND, DYNAMIC_DATA_ABORTED };
 
 const ux_flow_step_t *ux_display_transaction_flow[MAX_NUM_STEPS + 1];
 
@@ -73,151 +84,77 @@ static void bnnn_paging_edgecase(void) {
     ux_flow_relayout();
 }
 
-static void next_prop(void) {
-    uint8_t *idx = &display_ctx.p_index;
-    signer_t signer = G_context.tx_info.transaction.signers[display_ctx.s_index];
-
-    if (*idx < (uint8_t) CONTRACTS) (*idx)++;
-
-    if (signer_property[*idx] == CONTRACTS) {
-        // we start at -1
-        if (display_ctx.c_index + 1 < signer.allowed_contracts_size) {
-            display_ctx.c_index++;
-            return;  // let it display the contract
-        }
-        display_ctx.c_index++;
-        (*idx)++;  // advance state to GROUPS
-    }
-    if (signer_property[*idx] == GROUPS) {
-        // we start at -1
-        if (display_ctx.g_index + 1 < signer.allowed_groups_size) {
-            display_ctx.g_index++;
-            return;  // let it display the group
-        }
-        display_ctx.g_index++;
-        (*idx)++;  // advance state to END
+static enum e_dynamic_data get_next_data(enum e_section section, enum e_direction direction) {
+    uint16_t *item_index = &display_ctx.item_index[section];
+    uint16_t items_count;
+
+    switch (section) {
+        case SECTION_TRANSFERS:
+            items_count = get_transfer_items_count();
+            break;
+        case SECTION_TRANSACTION:
+            items_count = tx_items_count;
+            break;
+        case SECTION_SIGNERS:
+            items_count = get_signer_items_count();
+            break;
+        default:
+            items_count = get_batch_items_count();
+            break;
     }
 
-    // if we displayed all properties of the current signer
-    if (signer_property[*idx] == END) {
-        // are there more signers?
-        if (display_ctx.s_index + 1 == G_context.tx_info.transaction.signers_size) {
-            // no more signers
-            return;
-        } else {
-            // more signers, advance signer index and reset some properties
-            display_ctx.s_index++;
-            display_ctx.c_index = -1;
-            display_ctx.g_index = -1;
-            *idx = (uint8_t) START;
-            next_prop();
+    if (direction == DIRECTION_FORWARD) {
+        if (*item_index <= items_count) {
+            (*item_index)++;
         }
-    }
-}
-
-static void prev_prop(void) {
-    uint8_t *idx = &display_ctx.p_index;
-    signer_t signer;
-
-    // from first dynamic screen, go back to first static
-    if (display_ctx.s_index == 0 && signer_property[*idx] == INDEX) {
-        *idx = (uint8_t) START;
-        return;
-    }
-
-    // from static screen below lower_delimiter screen, go to last dynamic
-    if (signer_property[*idx] == END) {
-        (*idx)--;  // reverse to GROUPS
-    }
-
-    if (signer_property[*idx] == GROUPS) {
-        if (display_ctx.g_index > 0) {
-            display_ctx.g_index--;
-            return;  // let it display the group
+    } else {
+        if (*item_index > 0) {
+            (*item_index)--;
         }
-        display_ctx.g_index--;  // make sure we end up at -1 as that is what next_prop() expects
-                                // when going forward
-        (*idx)--;               // advance state to CONTRACTS
     }
 
-    if (signer_property[*idx] == CONTRACTS) {
-        if (display_ctx.c_index > 0) {
-            display_ctx.c_index--;
-            return;  // let it display the contract
-        }
-        display_ctx.c_index--;  // make sure we end up at -1 as that is what next_prop() expects
-                                // when going forward
-        // no need to reverse state to SCOPE, will be done on the next line
-    }
-    (*idx)--;
-
-    // we've exhausted all properties, check if there are more signers
-    if (signer_property[*idx] == START) {
-        if (display_ctx.s_index > 0) {
-            display_ctx.s_index--;
-            signer = G_context.tx_info.transaction.signers[display_ctx.s_index];
-            *idx = (uint8_t) END;  // set property index to end
-            display_ctx.g_index = signer.allowed_groups_size;
-            display_ctx.c_index = signer.allowed_contracts_size;
-            prev_prop();
-        }
+    if (*item_index == 0 || *item_index > items_count) {
+        return DYNAMIC_DATA_NONE;
     }
-}
 
-static bool get_next_data(enum e_direction direction) {
-    if (direction == DIRECTION_FORWARD) {
-        next_prop();
-    } else {
-        prev_prop();
+    bool formatted;
+    switch (section) {
+        case SECTION_TRANSFERS:
+            formatted = format_transfer_item(*item_index - 1, g_title, sizeof(g_title), g_text, sizeof(g_text));
+            break;
+        case SECTION_TRANSACTION:
+            formatted = format_tx_item(tx_items[*item_index - 1], g_title, sizeof(g_title), g_text, sizeof(g_text));
+            break;
+        case SECTION_SIGNERS:
+            formatted = format_signer_item(*item_index - 1, g_title, sizeof(g_title), g_text, sizeof(g_text));
+            break;
+        default:
+            formatted = format_batch_item(*item_index - 1, g_title, sizeof(g_title), g_text, sizeof(g_text));
+            break;
     }
-
-    signer_t s = G_context.tx_info.transaction.signers[display_ctx.s_index];
-    enum e_signer_state display = signer_property[display_ctx.p_index];
-
-    if (display_ctx.s_index == G_context.tx_info.transaction.signers_size &&
-        signer_property[display_ctx.p_index] == END) {
-        return false;
+    if (formatted) {
+        return DYNAMIC_DATA_FOUND;
     }
 
-    switch (display) {
-        case START: {
-            return false;
-        }
-        case INDEX: {
-            format_signer(display_ctx.s_index, g_title, sizeof(g_title), g_text, sizeof(g_text));
-            return true;
-        }
-        case ACCOUNT: {
-            format_account(&s, g_title, sizeof(g_title), g_text, sizeof(g_text));
-            return true;
-        }
-        case SCOPE: {
-            format_scope(&s, g_title, sizeof(g_title), g_text, sizeof(g_text));
-            return true;
-        }
-        case CONTRACTS: {
-            s = G_context.tx_info.transaction.signers[display_ctx.s_index];
-            format_contract(&s, display_ctx.c_index, g_title, sizeof(g_title), g_text, sizeof(g_text));
-            return true;
-        }
-        case GROUPS: {
-            s = G_context.tx_info.transaction.signers[display_ctx.s_index];
-            format_group(&s, display_ctx.g_index, g_title, sizeof(g_title), g_text, sizeof(g_text));
-            return true;
-        }
-        case END: {
-            return false;
-        }
+    // Every item was formatted before the review, one that is not displayable anymore rejects it
+    if (section == SECTION_BATCH) {
+        ui_action_validate_batch(false, true);
+    } else {
+        ui_action_validate_transaction(false, true);
     }
+    return DYNAMIC_DATA_ABORTED;
 }
 
 // Taken from Ledger's advanced display management docs
-static void display_next_state(bool is_upper_delimiter) {
+static void display_next_state(enum e_section section, bool is_upper_delimiter) {
     if (is_upper_delimiter) {  // We're called from the upper delimiter.
         if (display_ctx.current_state == STATIC_SCREEN) {
             // Fetch new data.
-            bool dynamic_data = get_next_data(DIRECTION_FORWARD);
-            if (dynamic_data) {
+            enum e_dynamic_data data = get_next_data(section, DIRECTION_FORWARD);
+            if (data == DYNAMIC_DATA_ABORTED) {
+                return;
+            }
+            if (data == DYNAMIC_DATA_FOUND) {
                 // We found some data to display so we now enter in dynamic mode.
                 display_ctx.current_state = DYNAMIC_SCREEN;
             }
@@ -228,8 +165,11 @@ static void display_next_state(bool is_upper_delimiter) {
             // The previous screen was NOT a static screen, so we were already in a dynamic screen.
 
             // Fetch new data.
-            bool dynamic_data = get_next_data(DIRECTION_BACKWARD);
-            if (dynamic_data) {
+            enum e_dynamic_data data = get_next_data(section, DIRECTION_BACKWARD);
+            if (data == DYNAMIC_DATA_ABORTED) {
+                return;
+            }
+            if (data == DYNAMIC_DATA_FOUND) {
                 // We found some data so simply display it.
                 ux_flow_next();
             } else {
@@ -245,8 +185,11 @@ static void display_next_state(bool is_upper_delimiter) {
         // We're called from the lower delimiter.
         if (display_ctx.current_state == STATIC_SCREEN) {
             // Fetch new data.
-            bool dynamic_data = get_next_data(DIRECTION_BACKWARD);
-            if (dynamic_data) {
+            enum e_dynamic_data data = get_next_data(section, DIRECTION_BACKWARD);
+            if (data == DYNAMIC_DATA_ABORTED) {
+                return;
+            }
+            if (data == DYNAMIC_DATA_FOUND) {
                 // We found some data to display so enter in dynamic mode.
                 display_ctx.current_state = DYNAMIC_SCREEN;
             }
@@ -257,8 +200,11 @@ static void display_next_state(bool is_upper_delimiter) {
             // We're being called from a dynamic screen, so the user was already browsing the array.
 
             // Fetch new data.
-            bool dynamic_data = get_next_data(DIRECTION_FORWARD);
-            if (dynamic_data) {
+            enum e_dynamic_data data = get_next_data(section, DIRECTION_FORWARD);
+            if (data == DYNAMIC_DATA_ABORTED) {
+                return;
+            }
+            if (data == DYNAMIC_DATA_FOUND) {
                 // We found some data, so display it.
                 // Similar to `ux_flow_prev()` but updates layout to account for `bnnn_paging`'s
                 // weird behaviour.
@@ -282,63 +228,6 @@ UX_STEP_NOCB(ux_display_review_step,
                  "Transaction",
              });
 
-UX_STEP_NOCB(ux_display_dst_address_step,
-             bnnn_paging,
-             {
-                 .title = "Destination addr",
-                 .text = G_tx.dst_address,
-             });
-
-UX_STEP_NOCB(ux_display_token_amount_step,
-             bnnn_paging,
-             {
-                 .title = "Token amount",
-                 .text = G_tx.token_amount,
-             });
-
-UX_STEP_NOCB(ux_display_systemfee_step,
-             bnnn_paging,
-             {
-                 .title = "System fee",
-                 .text = G_tx.system_fee,
-             });
-
-UX_STEP_NOCB(ux_display_network_step,
-             bnnn_paging,
-             {
-                 .title = "Target network",
-                 .text = G_tx.network,
-             });
-
-UX_STEP_NOCB(ux_display_networkfee_step,
-             bnnn_paging,
-             {
-                 .title = "Network fee",
-                 .text = G_tx.network_fee,
-             });
-
-UX_STEP_NOCB(ux_display_total_fee,
-             bnnn_paging,
-             {
-                 .title = "Total fees",
-                 .text = G_tx.total_fees,
-             });
-
-UX_STEP_NOCB(ux_display_validuntilblock_step,
-             bnnn_paging,
-             {
-                 .title = "Valid until height",
-                 .text = G_tx.valid_until_block,
-             });
-
-UX_STEP_NOCB(ux_display_script_step,
-             bnnn_paging,
-             {
-                .title = "Script hash",
-                .text = G_tx.script_hash,
-             }
-);
-
 UX_STEP_NOCB(
     ux_display_no_arbitrary_script_step,
     bnnn_paging,
@@ -355,17 +244,34 @@ UX_STEP_CB(ux_display_abort_step,
                "Understood, abort..",
            });
 
-UX_STEP_NOCB(ux_display_vote_to_step,
+UX_STEP_NOCB(ux_display_vote_retract_step, nn, {"Retracting vote", ""});
+
+// 3 special steps for runtime dynamic screen generation, used to display transfers and their properties
+UX_STEP_INIT(ux_transfers_upper_delimiter, NULL, NULL, { display_next_state(SECTION_TRANSFERS, true); });
+
+UX_STEP_NOCB(ux_display_transfers_generic,
              bnnn_paging,
              {
-                 .title = "Casting vote for",
-                 .text = G_tx.vote_to,
+                 .title = g_title,
+                 .text = g_text,
              });
 
-UX_STEP_NOCB(ux_display_vote_retract_step, nn, {"Retracting vote", ""});
+UX_STEP_INIT(ux_transfers_lower_delimiter, NULL, NULL, { display_next_state(SECTION_TRANSFERS, false); });
+
+// 3 special steps for runtime dynamic screen generation, used to display the properties of the transaction
+UX_STEP_INIT(ux_transaction_upper_delimiter, NULL, NULL, { display_next_state(SECTION_TRANSACTION, true); });
+
+UX_STEP_NOCB(ux_display_transaction_generic,
+             bnnn_paging,
+             {
+                 .title = g_title,
+                 .text = g_text,
+             });
+
+UX_STEP_INIT(ux_transaction_lower_delimiter, NULL, NULL, { display_next_state(SECTION_TRANSACTION, false); });
 
 // 3 special steps for runtime dynamic screen generation, used to display attached signers and their properties
-UX_STEP_INIT(ux_upper_delimiter, NULL, NULL, { display_next_state(true); });
+UX_STEP_INIT(ux_upper_delimiter, NULL, NULL, { display_next_state(SECTION_SIGNERS, true); });
 
 UX_STEP_NOCB(ux_display_generic,
              bnnn_paging,
@@ -374,7 +280,7 @@ UX_STEP_NOCB(ux_display_generic,
                  .text = g_text,
              });
 
-UX_STEP_INIT(ux_lower_delimiter, NULL, NULL, { display_next_state(false); });
+UX_STEP_INIT(ux_lower_delimiter, NULL, NULL, { display_next_state(SECTION_SIGNERS, false); });
 
 // Step with approve button
 UX_STEP_CB(ux_display_approve_step,
@@ -397,9 +303,9 @@ UX_STEP_CB(ux_display_reject_step,
 static void create_transaction_flow(void) {
     uint8_t index = 0;
 
-    reset_signer_display_state();
+    reset_display_state();
 
-    if (!G_context.tx_info.transaction.is_system_asset_transfer && !G_context.tx_info.transaction.is_vote_script &&
+    if (!G_context.tx_info.transaction.is_token_transfer && !G_context.tx_info.transaction.is_vote_script &&
         !N_storage.scriptsAllowed) {
         ux_display_transaction_flow[index++] = &ux_display_no_arbitrary_script_step;
         ux_display_transaction_flow[index++] = &ux_display_abort_step;
@@ -407,28 +313,34 @@ static void create_transaction_flow(void) {
         return;
     }
 
+    tx_items_count = 0;
     ux_display_transaction_flow[index++] = &ux_display_review_step;
 
     if (G_context.tx_info.transaction.is_vote_script) {
         if (G_context.tx_info.transaction.is_remove_vote) {
             ux_display_transaction_flow[index++] = &ux_display_vote_retract_step;
         } else {
-            ux_display_transaction_flow[index++] = &ux_display_vote_to_step;
+            tx_items[tx_items_count++] = TX_ITEM_VOTE_TO;
         }
-    } else if (G_context.tx_info.transaction.is_system_asset_transfer) {
-        ux_display_transaction_flow[index++] = &ux_display_dst_address_step;
-        ux_display_transaction_flow[index++] = &ux_display_token_amount_step;
+    } else if (G_context.tx_info.transaction.is_token_transfer) {
+        // will be used to dynamically display the destination and amount of each transfer
+        ux_display_transaction_flow[index++] = &ux_transfers_upper_delimiter;
+        ux_display_transaction_flow[index++] = &ux_display_transfers_generic;
+        ux_display_transaction_flow[index++] = &ux_transfers_lower_delimiter;
     }
 
-    ux_display_transaction_flow[index++] = &ux_display_network_step;
-    ux_display_transaction_flow[index++] = &ux_display_systemfee_step;
-    ux_display_transaction_flow[index++] = &ux_display_networkfee_step;
-    ux_display_transaction_flow[index++] = &ux_display_total_fee;
-    ux_display_transaction_flow[index++] = &ux_display_validuntilblock_step;
+    // will be used to dynamically display the properties of the transaction, formatted only when shown
+    tx_items[tx_items_count++] = TX_ITEM_NETWORK;
+    tx_items[tx_items_count++] = TX_ITEM_SYSTEM_FEE;
+    tx_items[tx_items_count++] = TX_ITEM_NETWORK_FEE;
+    tx_items[tx_items_count++] = TX_ITEM_TOTAL_FEES;
+    tx_items[tx_items_count++] = TX_ITEM_VALID_UNTIL;
     if (N_storage.showScriptHash) {
-        ux_display_transaction_flow[index++] = &ux_display_script_step;
+        tx_items[tx_items_count++] = TX_ITEM_SCRIPT_HASH;
     }
-
+    ux_display_transaction_flow[index++] = &ux_transaction_upper_delimiter;
+    ux_display_transaction_flow[index++] = &ux_display_transaction_generic;
+    ux_display_transaction_flow[index++] = &ux_transaction_lower_delimiter;
 
     // special step that won't be shown, but used for runtime displaying
     // dynamics screens when applicable
@@ -444,11 +356,64 @@ static void create_transaction_flow(void) {
     ux_display_transaction_flow[index++] = FLOW_END_STEP;
 }
 
-void start_sign_tx_ui(void) {
+// Review of a batch of transactions, its whole description is displayed dynamically
+UX_STEP_NOCB(ux_display_review_batch_step,
+             pnn,
+             {
+                 &C_icon_eye,
+                 "Review",
+                 "Batch",
+             });
+
+UX_STEP_INIT(ux_batch_upper_delimiter, NULL, NULL, { display_next_state(SECTION_BATCH, true); });
+
+UX_STEP_NOCB(ux_display_batch_generic,
+             bnnn_paging,
+             {
+                 .title = g_title,
+                 .text = g_text,
+             });
+
+UX_STEP_INIT(ux_batch_lower_delimiter, NULL, NULL, { display_next_state(SECTION_BATCH, false); });
+
+UX_STEP_CB(ux_display_approve_batch_step,
+           pb,
+           ui_action_validate_batch(true, true),
+           {
+               &C_icon_validate_14,
+               "Approve",
+           });
+
+UX_STEP_CB(ux_display_reject_batch_step,
+           pb,
+           ui_action_validate_batch(false, true),
+           {
+               &C_icon_crossmark,
+               "Reject",
+           });
+
+UX_FLOW(ux_display_batch_flow,
+        &ux_display_review_batch_step,
+        &ux_batch_upper_delimiter,
+        &ux_display_batch_generic,
+        &ux_batch_lower_delimiter,
+        &ux_display_approve_batch_step,
+        &ux_display_reject_batch_step);
+
+int start_sign_batch_ui(void) {
+    reset_display_state();
+    ux_flow_init(0, ux_display_batch_flow, NULL);
+
+    return 0;
+}
+
+int start_sign_tx_ui(void) {
     // Prepare steps
     create_transaction_flow();
     // start display
     ux_flow_init(0, ux_display_transaction_flow, NULL);
+
+    return 0;
 }
 
 #endif
@@ -11,14 +11,14 @@
 #include "sw.h"
 #include "action/validate.h"
 #include "transaction/transaction_types.h"
+#include "transaction/tx_utils.h"
+#include "transaction/tokens.h"
 #include "common/format.h"
 #include "utils.h"
 #include "menu.h"
 #include "shared_context.h"
 #include "sign_tx_common.h"
 
-global_item_storage_t G_tx;
-
 void format_signer(uint8_t signer_idx,
                    char *dest_title,
                    size_t dest_title_size,
@@ -34,7 +34,7 @@ void format_account(const signer_t *s,
                     char *dest_text,
                     size_t dest_text_size) {
     strlcpy(dest_title, "Account", dest_title_size);
-    format_hex(s->account, 20, dest_text, dest_text_size);
+    format_hex(signer_account(&G_context.tx_info.transaction, s), UINT160_LEN, dest_text, dest_text_size);
 }
 
 static void strlcat_with_comma(char *dest, const char *text, size_t dest_size, bool *is_first) {
@@ -73,7 +73,10 @@ void format_contract(const signer_t *s,
                      char *dest_text,
                      size_t dest_text_size) {
     snprintf(dest_title, dest_title_size, "Contract %d of %d", contract_index + 1, s->allowed_contracts_size);
-    format_hex(s->allowed_contracts[contract_index], UINT160_LEN, dest_text, dest_text_size);
+    format_hex(signer_allowed_contract(&G_context.tx_info.transaction, s, contract_index),
+               UINT160_LEN,
+               dest_text,
+               dest_text_size);
 }
 
 void format_group(const signer_t *s,
@@ -83,89 +86,292 @@ void format_group(const signer_t *s,
                   char *dest_text,
                   size_t dest_text_size) {
     snprintf(dest_title, dest_title_size, "Group %d of %d", group_index + 1, s->allowed_groups_size);
-    format_hex(s->allowed_groups[group_index], ECPOINT_LEN, dest_text, dest_text_size);
+    format_hex(signer_allowed_group(&G_context.tx_info.transaction, s, group_index),
+               ECPOINT_LEN,
+               dest_text,
+               dest_text_size);
 }
 
-int start_sign_tx(void) {
-    if (G_context.tx_info.transaction.is_system_asset_transfer) {
-        memset(G_tx.dst_address, 0, sizeof(G_tx.dst_address));
-        snprintf(G_tx.dst_address, sizeof(G_tx.dst_address), "%s", G_context.tx_info.transaction.dst_address);
-        PRINTF("Destination address: %s\n", G_tx.dst_address);
-
-        memset(G_tx.token_amount, 0, sizeof(G_tx.token_amount));
-        char token_amount[sizeof(G_tx.token_amount)] = {0};
-        if (!format_fpu64(token_amount,
-                          sizeof(token_amount),
-                          (uint64_t) G_context.tx_info.transaction.amount,
-                          G_context.tx_info.transaction.is_neo ? 0 : 8)) {
-            return io_send_sw(SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
-        }
-        snprintf(G_tx.token_amount,
-                 sizeof(G_tx.token_amount),
-                 "%s %.*s",
-                 G_context.tx_info.transaction.is_neo ? "NEO" : "GAS",
-                 sizeof(token_amount),
-                 token_amount);
+/**
+ * Number of properties displayed for a signer: its index, account, scope, allowed contracts and allowed groups.
+ */
+static uint16_t signer_items_count(const signer_t *s) {
+    return 3 + s->allowed_contracts_size + s->allowed_groups_size;
+}
+
+uint16_t get_signer_items_count(void) {
+    uint16_t count = 0;
+    for (uint8_t i = 0; i < G_context.tx_info.transaction.signers_size; i++) {
+        count += signer_items_count(&G_context.tx_info.transaction.signers[i]);
+    }
+    return count;
+}
+
+bool format_signer_item(uint16_t index,
+                        char *dest_title,
+                        size_t dest_title_size,
+                        char *dest_text,
+                        size_t dest_text_size) {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+
+    // Locate the signer the item belongs to, then the property of that signer
+    uint8_t signer_idx = 0;
+    while (signer_idx < tx->signers_size && index >= signer_items_count(&tx->signers[signer_idx])) {
+        index -= signer_items_count(&tx->signers[signer_idx]);
+        signer_idx++;
+    }
+    if (signer_idx == tx->signers_size) {
+        return false;
     }
 
-    if (G_context.tx_info.transaction.is_vote_script && !G_context.tx_info.transaction.is_remove_vote) {
-        memset(G_tx.vote_to, 0, sizeof(G_tx.vote_to));
-        format_hex(G_context.tx_info.transaction.vote_to, ECPOINT_LEN, G_tx.vote_to, sizeof(G_tx.vote_to));
+    const signer_t *s = &tx->signers[signer_idx];
+    if (index == 0) {
+        format_signer(signer_idx, dest_title, dest_title_size, dest_text, dest_text_size);
+    } else if (index == 1) {
+        format_account(s, dest_title, dest_title_size, dest_text, dest_text_size);
+    } else if (index == 2) {
+        format_scope(s, dest_title, dest_title_size, dest_text, dest_text_size);
+    } else if (index - 3 < s->allowed_contracts_size) {
+        format_contract(s, index - 3, dest_title, dest_title_size, dest_text, dest_text_size);
+    } else {
+        format_group(s, index - 3 - s->allowed_contracts_size, dest_title, dest_title_size, dest_text, dest_text_size);
     }
+    return true;
+}
 
+void format_network_name(char *dest, size_t dest_size) {
     // We'll try to give more user friendly names for known networks
     if (G_context.network_magic == NETWORK_MAINNET) {
-        strcpy(G_tx.network, "MainNet");
+        strlcpy(dest, "MainNet", dest_size);
     } else if (G_context.network_magic == NETWORK_TESTNET) {
-        strcpy(G_tx.network, "TestNet");
+        strlcpy(dest, "TestNet", dest_size);
     } else {
-        snprintf(G_tx.network, sizeof(G_tx.network), "%d", G_context.network_magic);
-    }
-    PRINTF("Target network: %s\n", G_tx.network);
-
-    // System fee is a value multiplied by 100_000_000 to create 8 decimals stored in an int.
-    // It is not allowed to be negative so we can safely cast it to uint64_t
-    memset(G_tx.system_fee, 0, sizeof(G_tx.system_fee));
-    char system_fee[sizeof(G_tx.system_fee)] = {0};
-    if (!format_fpu64(system_fee, sizeof(system_fee), (uint64_t) G_context.tx_info.transaction.system_fee, 8)) {
-        return io_send_sw(SW_DISPLAY_SYSTEM_FEE_FAIL);
-    }
-    snprintf(G_tx.system_fee, sizeof(G_tx.system_fee), "GAS %.*s", sizeof(system_fee), system_fee);
-    PRINTF("System fee: %s GAS\n", system_fee);
-
-    // Network fee is stored in a similar fashion as system fee above
-    memset(G_tx.network_fee, 0, sizeof(G_tx.network_fee));
-    char network_fee[sizeof(G_tx.network_fee)] = {0};
-    if (!format_fpu64(network_fee, sizeof(network_fee), (uint64_t) G_context.tx_info.transaction.network_fee, 8)) {
-        return io_send_sw(SW_DISPLAY_NETWORK_FEE_FAIL);
-    }
-    snprintf(G_tx.network_fee, sizeof(G_tx.network_fee), "GAS %.*s", sizeof(network_fee), network_fee);
-    PRINTF("Network fee: %s GAS\n", network_fee);
-
-    memset(G_tx.total_fees, 0, sizeof(G_tx.total_fees));
-    char total_fee[sizeof(G_tx.total_fees)] = {0};
-    // Note that network_fee and system_fee are actually int64 and can't be less than 0 (as guarded by
-    // transaction_deserialize())
-    if (!format_fpu64(total_fee,
-                      sizeof(total_fee),
-                      (uint64_t) G_context.tx_info.transaction.network_fee + G_context.tx_info.transaction.system_fee,
-                      8)) {
-        return io_send_sw(SW_DISPLAY_TOTAL_FEE_FAIL);
+        snprintf(dest, dest_size, "%d", G_context.network_magic);
     }
-    snprintf(G_tx.total_fees, sizeof(G_tx.total_fees), "GAS %.*s", sizeof(total_fee), total_fee);
+}
 
-    snprintf(G_tx.valid_until_block,
-             sizeof(G_tx.valid_until_block),
-             "%d",
-             G_context.tx_info.transaction.valid_until_block);
-    PRINTF("Valid until: %s\n", G_tx.valid_until_block);
+#ifdef HAVE_BAGL
+#define TRANSFER_DESTINATION_TITLE "Destination addr"
+#else
+#define TRANSFER_DESTINATION_TITLE "To"
+#endif
+
+static bool format_transfer_amount(const transfer_t *transfer, char *dest, size_t dest_size) {
+    return format_amount(dest,
+                         dest_size,
+                         transfer->token->ticker,
+                         (uint64_t) transfer->amount,
+                         transfer->token->decimals,
+                         false);
+}
+
+uint16_t get_transfer_items_count(void) {
+    if (!G_context.tx_info.transaction.is_token_transfer) {
+        return 0;
+    }
+    return 2 * G_context.tx_info.transaction.transfers_size;
+}
 
-    memset(G_tx.script_hash, 0, sizeof(G_tx.script_hash));
-    if(format_hex(G_context.tx_info.script_hash, 32, G_tx.script_hash, sizeof(G_tx.script_hash)) == -1) {
-        return io_send_sw(SW_DISPLAY_SCRIPT_HASH_FAIL);
+bool format_transfer_item(uint16_t index,
+                          char *dest_title,
+                          size_t dest_title_size,
+                          char *dest_text,
+                          size_t dest_text_size) {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+
+    if (index >= get_transfer_items_count()) {
+        return false;
+    }
+    const transfer_t *transfer = &tx->transfers[index / 2];
+    const char *title = (index % 2 == 0) ? TRANSFER_DESTINATION_TITLE : "Token amount";
+
+    // Number the transfers of a batch, a single transfer is displayed as it always was
+    if (tx->transfers_size == 1) {
+        strlcpy(dest_title, title, dest_title_size);
+    } else {
+        snprintf(dest_title, dest_title_size, "%s %d/%d", title, index / 2 + 1, tx->transfers_size);
+    }
+
+    if (index % 2 == 0) {
+        return script_hash_to_address(dest_text, dest_text_size, tx->script + transfer->destination);
+    }
+    return format_transfer_amount(transfer, dest_text, dest_text_size);
+}
+
+bool format_tx_item(tx_item_e item,
+                    char *dest_title,
+                    size_t dest_title_size,
+                    char *dest_text,
+                    size_t dest_text_size) {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+
+    switch (item) {
+        case TX_ITEM_VOTE_TO:
+            strlcpy(dest_title, "Casting vote for", dest_title_size);
+            return format_hex(tx->vote_to, ECPOINT_LEN, dest_text, dest_text_size) != -1;
+        case TX_ITEM_NETWORK:
+            strlcpy(dest_title, "Target network", dest_title_size);
+            format_network_name(dest_text, dest_text_size);
+            return true;
+        // Fees are values multiplied by 100_000_000 to create 8 decimals stored in an int.
+        // They are not allowed to be negative (as guarded by transaction_parser_feed()) so we can safely cast them
+        // to uint64_t, their sum included
+        case TX_ITEM_SYSTEM_FEE:
+            strlcpy(dest_title, "System fee", dest_title_size);
+            return format_amount(dest_text, dest_text_size, "GAS", (uint64_t) tx->system_fee, 8, false);
+        case TX_ITEM_NETWORK_FEE:
+            strlcpy(dest_title, "Network fee", dest_title_size);
+            return format_amount(dest_text, dest_text_size, "GAS", (uint64_t) tx->network_fee, 8, false);
+        case TX_ITEM_TOTAL_FEES:
+            strlcpy(dest_title, "Total fees", dest_title_size);
+            return format_amount(dest_text,
+                                 dest_text_size,
+                                 "GAS",
+                                 (uint64_t) tx->network_fee + (uint64_t) tx->system_fee,
+                                 8,
+                                 false);
+        case TX_ITEM_VALID_UNTIL:
+            strlcpy(dest_title, "Valid until height", dest_title_size);
+            snprintf(dest_text, dest_text_size, "%d", tx->valid_until_block);
+            return true;
+        case TX_ITEM_SCRIPT_HASH:
+            strlcpy(dest_title, "Script hash", dest_title_size);
+            return format_hex(G_context.tx_info.script_hash,
+                              sizeof(G_context.tx_info.script_hash),
+                              dest_text,
+                              dest_text_size) != -1;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Status word of a transaction property that cannot be displayed.
+ */
+static uint16_t tx_item_fail_sw(tx_item_e item) {
+    switch (item) {
+        case TX_ITEM_SYSTEM_FEE:
+            return SW_DISPLAY_SYSTEM_FEE_FAIL;
+        case TX_ITEM_NETWORK_FEE:
+            return SW_DISPLAY_NETWORK_FEE_FAIL;
+        case TX_ITEM_TOTAL_FEES:
+            return SW_DISPLAY_TOTAL_FEE_FAIL;
+        default:
+            // The network and the height always format, the vote is read from the script like its hash
+            return SW_DISPLAY_SCRIPT_HASH_FAIL;
+    }
+}
+
+int start_sign_tx(void) {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+    char title[64];
+    char text[ITEM_TEXT_MAX_SIZE];
+
+    // Every item is formatted again when displayed, make sure now that none will fail there
+    for (uint16_t i = 0; i < get_transfer_items_count(); i++) {
+        if (!format_transfer_item(i, title, sizeof(title), text, sizeof(text))) {
+            G_context.state = STATE_NONE;
+            return io_send_sw((i % 2 == 0) ? SW_CONVERT_TO_ADDRESS_FAIL : SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
+        }
+    }
+    for (tx_item_e item = TX_ITEM_VOTE_TO; item <= TX_ITEM_SCRIPT_HASH; item++) {
+        if (item == TX_ITEM_VOTE_TO && (!tx->is_vote_script || tx->is_remove_vote)) {
+            continue;
+        }
+        if (!format_tx_item(item, title, sizeof(title), text, sizeof(text))) {
+            G_context.state = STATE_NONE;
+            return io_send_sw(tx_item_fail_sw(item));
+        }
+    }
+    for (uint16_t i = 0; i < get_signer_items_count(); i++) {
+        if (!format_signer_item(i, title, sizeof(title), text, sizeof(text))) {
+            G_context.state = STATE_NONE;
+            return io_send_sw(SW_DISPLAY_SIGNERS_FAIL);
+        }
+    }
+
+    return start_sign_tx_ui();
+}
+
+/**
+ * Items of the batch review before its tokens and destinations: transactions count, network and max total fees.
+ */
+#define BATCH_HEADER_ITEMS 3
+
+static bool format_batch_amount(const batch_token_t *token, char *dest, size_t dest_size) {
+    return format_amount(dest, dest_size, token->token->ticker, token->total, token->token->decimals, false);
+}
+
+uint16_t get_batch_items_count(void) {
+    return BATCH_HEADER_ITEMS + G_context.batch.tokens_size + G_context.batch.destinations_size;
+}
+
+bool format_batch_item(uint16_t index,
+                       char *dest_title,
+                       size_t dest_title_size,
+                       char *dest_text,
+                       size_t dest_text_size) {
+    const batch_ctx_t *batch = &G_context.batch;
+
+    if (index == 0) {
+        strlcpy(dest_title, "Transactions", dest_title_size);
+        snprintf(dest_text, dest_text_size, "%d", batch->count);
+        return true;
+    }
+    if (index == 1) {
+        strlcpy(dest_title, "Target network", dest_title_size);
+        format_network_name(dest_text, dest_text_size);
+        return true;
+    }
+    if (index == 2) {
+        strlcpy(dest_title, "Max total fees", dest_title_size);
+        return format_amount(dest_text, dest_text_size, "GAS", batch->max_fees, 8, false);
+    }
+
+    index -= BATCH_HEADER_ITEMS;
+    if (index < batch->tokens_size) {
+        if (batch->tokens_size == 1) {
+            strlcpy(dest_title, "Max total amount", dest_title_size);
+        } else {
+            snprintf(dest_title, dest_title_size, "Max total amount %d/%d", index + 1, batch->tokens_size);
+        }
+        return format_batch_amount(&batch->tokens[index], dest_text, dest_text_size);
+    }
+
+    index -= batch->tokens_size;
+    if (index < batch->destinations_size) {
+        if (batch->destinations_size == 1) {
+            strlcpy(dest_title, "Destination", dest_title_size);
+        } else {
+            snprintf(dest_title, dest_title_size, "Destination %d/%d", index + 1, batch->destinations_size);
+        }
+        return script_hash_to_address(dest_text, dest_text_size, batch->destinations[index]);
+    }
+    return false;
+}
+
+int start_sign_batch(void) {
+    char amount[AMOUNTS_MAX_SIZE];
+
+    // Make sure now that every amount and destination can be displayed, they are formatted when displayed
+    for (uint8_t i = 0; i < G_context.batch.tokens_size; i++) {
+        if (!format_batch_amount(&G_context.batch.tokens[i], amount, sizeof(amount))) {
+            G_context.state = STATE_NONE;
+            return io_send_sw(SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
+        }
+    }
+    if (!format_amount(amount, sizeof(amount), "GAS", G_context.batch.max_fees, 8, false)) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_DISPLAY_TOTAL_FEE_FAIL);
+    }
+
+    char address[ADDRESS_LEN + 1];
+    for (uint8_t i = 0; i < G_context.batch.destinations_size; i++) {
+        if (!script_hash_to_address(address, sizeof(address), G_context.batch.destinations[i])) {
+            G_context.state = STATE_NONE;
+            return io_send_sw(SW_CONVERT_TO_ADDRESS_FAIL);
+        }
     }
-    PRINTF("Script hash: %s\n", G_tx.script_hash);
-    start_sign_tx_ui();
 
-    return 0;
+    return start_sign_batch_ui();
 }
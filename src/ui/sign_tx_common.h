@@ -1,37 +1,29 @@
 #pragma once
 
 #include "types.h"
+#include "transaction/tokens.h"
 
 // number of steps in create_transaction_flow() for BAGL
-#define MAX_NUM_STEPS 14
-
-// uint32 (=max 10 chars) + \0
-#define UINT32_STRING_SIZE 11
-
-// Target network the tx in tended for ("MainNet", "TestNet" or uint32 network number for private nets)
-#define NETWORK_NAME_MAX_SIZE 11
-
-// ticker + uint64 (=max 20 chars) + \0
-#define AMOUNTS_MAX_SIZE 30
-
-// 33 bytes public key as hex + \0
-#define VOTE_TO_SIZE (ECPOINT_LEN * 2 + 1)
-
-#define SHA256_SIZE (32 * 2 + 1)
-
-typedef struct global_item_storage_s {
-    char dst_address[ADDRESS_LEN + 1];
-    char system_fee[AMOUNTS_MAX_SIZE];
-    char network_fee[AMOUNTS_MAX_SIZE];
-    char total_fees[AMOUNTS_MAX_SIZE];
-    char token_amount[AMOUNTS_MAX_SIZE];
-    char vote_to[VOTE_TO_SIZE];
-    char network[NETWORK_NAME_MAX_SIZE];
-    char valid_until_block[UINT32_STRING_SIZE];
-    char script_hash[SHA256_SIZE];
-} global_item_storage_t;
-
-extern global_item_storage_t G_tx;
+#define MAX_NUM_STEPS 15
+
+// ticker + space + uint64 with decimal separator (=max 22 chars, "X.0" without decimals) + \0
+#define AMOUNTS_MAX_SIZE (MAX_TICKER_LEN + 23)
+
+// text of the items formatted on demand, the longest being a 33 bytes public key as hex + \0
+#define ITEM_TEXT_MAX_SIZE (ECPOINT_LEN * 2 + 1)
+
+/**
+ * Properties of the transaction itself, each UI displays its own selection of them.
+ */
+typedef enum {
+    TX_ITEM_VOTE_TO,      // public key the vote is cast for
+    TX_ITEM_NETWORK,      // target network
+    TX_ITEM_SYSTEM_FEE,   // system fee in GAS
+    TX_ITEM_NETWORK_FEE,  // network fee in GAS
+    TX_ITEM_TOTAL_FEES,   // sum of both fees in GAS
+    TX_ITEM_VALID_UNTIL,  // valid until block height
+    TX_ITEM_SCRIPT_HASH,  // hash of the script
+} tx_item_e;
 
 void format_signer(uint8_t signer_idx,
                    char *dest_title,
@@ -61,6 +53,82 @@ void format_group(const signer_t *s,
                   char *dest_text,
                   size_t dest_text_size);
 
+/**
+ * Number of signer properties to review, over all signers.
+ */
+uint16_t get_signer_items_count(void);
+
+/**
+ * Format signer property 'index' of the review, going through the signers in order
+ * and for each its index, account, scope, allowed contracts and allowed groups.
+ *
+ * @return true if success, false if 'index' is past the last property.
+ */
+bool format_signer_item(uint16_t index,
+                        char *dest_title,
+                        size_t dest_title_size,
+                        char *dest_text,
+                        size_t dest_text_size);
+
+/**
+ * Number of transfer properties to review, the destination and the amount of each transfer.
+ */
+uint16_t get_transfer_items_count(void);
+
+/**
+ * Format transfer property 'index' of the review, going through the transfers in order
+ * and for each its destination address and amount.
+ *
+ * @return true if success, false if 'index' is past the last property or the amount can't be formatted.
+ */
+bool format_transfer_item(uint16_t index,
+                          char *dest_title,
+                          size_t dest_title_size,
+                          char *dest_text,
+                          size_t dest_text_size);
+
+/**
+ * Format transaction property 'item' of the review, when it is displayed, so none has to be kept around in the
+ * meantime.
+ *
+ * @return true if success, false if 'item' is unknown.
+ */
+bool format_tx_item(tx_item_e item,
+                    char *dest_title,
+                    size_t dest_title_size,
+                    char *dest_text,
+                    size_t dest_text_size);
+
+/**
+ * Format the name of the network of G_context.network_magic, for known networks, or its magic.
+ */
+void format_network_name(char *dest, size_t dest_size);
+
+/**
+ * Number of items of the batch review: its transactions count, network, max total fees, tokens and destinations.
+ */
+uint16_t get_batch_items_count(void);
+
+/**
+ * Format item 'index' of the batch review.
+ *
+ * @return true if success, false if 'index' is past the last item or the amount can't be formatted.
+ */
+bool format_batch_item(uint16_t index,
+                       char *dest_title,
+                       size_t dest_title_size,
+                       char *dest_text,
+                       size_t dest_text_size);
+
+/**
+ * Review the batch in G_context.batch, to approve it before its transactions are signed.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ */
+int start_sign_batch(void);
+
+int start_sign_batch_ui(void);
+
 int start_sign_tx(void);
 
-void start_sign_tx_ui(void);
+int start_sign_tx_ui(void);
@@ -13,6 +13,7 @@
 #include "sw.h"
 #include "action/validate.h"
 #include "transaction/transaction_types.h"
+#include "transaction/tokens.h"
 #include "common/format.h"
 #include "utils.h"
 #include "menu.h"
@@ -21,68 +22,30 @@
 
 #include "nbgl_use_case.h"
 
-typedef enum item_kind_e {
-    SIGNER,
-    ACCOUNT,
-    SCOPE,
-    CONTRACT,
-    GROUP,
-} item_kind_t;
-
-typedef struct item_signer_s {
-    uint8_t signer_index;
-} item_signer_t;
-
-typedef struct item_account_s {
-    uint8_t signer_index;
-} item_account_t;
-
-typedef struct item_scope_s {
-    uint8_t signer_index;
-} item_scope_t;
-
-typedef struct item_contract_s {
-    uint8_t signer_index;
-    uint8_t contract_index;
-} item_contract_t;
-
-typedef struct item_group_s {
-    uint8_t signer_index;
-    uint8_t group_index;
-} item_group_t;
-
-typedef struct dynamic_item_s {
-    item_kind_t kind;
-    union {
-        item_signer_t as_item_signer;
-        item_account_t as_item_account;
-        item_scope_t as_item_scope;
-        item_contract_t as_item_contract;
-        item_group_t as_item_group;
-    } content;
-} dynamic_item_t;
-
 typedef struct dynamic_slot_s {
     char title[64];
-    char text[64];
+    char text[ITEM_TEXT_MAX_SIZE];
 } dynamic_slot_t;
 
 static nbgl_contentTagValueList_t content;
 static const char *review_final_long_press_text;
 static nbgl_contentTagValue_t current_pair;
-static nbgl_contentTagValue_t static_items[MAX_NUM_STEPS + 1];
 static dynamic_slot_t dyn_slots[NB_MAX_DISPLAYED_PAIRS_IN_REVIEW];
-static uint8_t static_items_nb;
-// Reserve space for preparing the dynamic items (signer) display. At the moment 42 elements max
-static dynamic_item_t
-    dyn_items[MAX_TX_SIGNERS * (3 + MAX_SIGNER_ALLOWED_CONTRACTS * 1 + MAX_SIGNER_ALLOWED_GROUPS * 1)];
-static uint8_t dyn_items_nb;
+static uint8_t transfer_items_nb;
 static const char *review_title;
+static char token_review_title[sizeof("Review transaction to\nsend ") + MAX_TICKER_LEN];
+static char token_long_press_text[sizeof("Sign transaction to\nsend ?") + MAX_TICKER_LEN];
+
+/**
+ * Properties of the transaction reviewed between the transfers and the signers.
+ */
+static const tx_item_e tx_items[] = {TX_ITEM_NETWORK,
+                                     TX_ITEM_SYSTEM_FEE,
+                                     TX_ITEM_NETWORK_FEE,
+                                     TX_ITEM_TOTAL_FEES,
+                                     TX_ITEM_VALID_UNTIL};
 
 static void create_transaction_flow(void) {
-    static_items_nb = 0;
-    dyn_items_nb = 0;
-
     if (G_context.tx_info.transaction.is_vote_script) {
         if (G_context.tx_info.transaction.is_remove_vote) {
             review_final_long_press_text = "Sign transaction to\nretract vote?";
@@ -91,78 +54,32 @@ static void create_transaction_flow(void) {
             review_final_long_press_text = "Sign transaction to\ncast vote?";
             review_title = "Review transaction to\ncast vote";
         }
-    } else if (G_context.tx_info.transaction.is_system_asset_transfer) {
-        static_items[static_items_nb].item = "To";
-        static_items[static_items_nb].value = G_tx.dst_address;
-        ++static_items_nb;
-        static_items[static_items_nb].item = "Token amount";
-        static_items[static_items_nb].value = G_tx.token_amount;
-        ++static_items_nb;
-
-        if (G_context.tx_info.transaction.is_neo) {
-            review_final_long_press_text = "Sign transaction to\nsend NEO?";
-            review_title = "Review transaction to\nsend NEO";
-        } else {
-            review_final_long_press_text = "Sign transaction to\nsend GAS?";
-            review_title = "Review transaction to\nsend GAS";
+    } else if (G_context.tx_info.transaction.is_token_transfer) {
+        // Name the token when the transfers are all of the same one
+        const transaction_t *tx = &G_context.tx_info.transaction;
+        const char *ticker = tx->transfers[0].token->ticker;
+        for (uint8_t i = 1; i < tx->transfers_size; i++) {
+            if (tx->transfers[i].token != tx->transfers[0].token) {
+                ticker = "tokens";
+                break;
+            }
         }
+        snprintf(token_long_press_text, sizeof(token_long_press_text), "Sign transaction to\nsend %s?", ticker);
+        snprintf(token_review_title, sizeof(token_review_title), "Review transaction to\nsend %s", ticker);
+        review_final_long_press_text = token_long_press_text;
+        review_title = token_review_title;
     } else {
         review_final_long_press_text = "Sign script?";
         review_title = "Review transaction\nto sign script";
     }
-
-    static_items[static_items_nb].item = "Target network";
-    static_items[static_items_nb].value = G_tx.network;
-    ++static_items_nb;
-
-    static_items[static_items_nb].item = "System fee";
-    static_items[static_items_nb].value = G_tx.system_fee;
-    ++static_items_nb;
-
-    static_items[static_items_nb].item = "Network fee";
-    static_items[static_items_nb].value = G_tx.network_fee;
-    ++static_items_nb;
-
-    static_items[static_items_nb].item = "Total fees";
-    static_items[static_items_nb].value = G_tx.total_fees;
-    ++static_items_nb;
-
-    static_items[static_items_nb].item = "Valid until height";
-    static_items[static_items_nb].value = G_tx.valid_until_block;
-    ++static_items_nb;
-
-    // dyn_items size is tailored to fit the worst case scenario
-    // if the number of element is too big for the array it would have triggered a parsing error
-    for (int i = 0; i < G_context.tx_info.transaction.signers_size; ++i) {
-        dyn_items[dyn_items_nb].kind = SIGNER;
-        dyn_items[dyn_items_nb].content.as_item_signer.signer_index = i;
-        ++dyn_items_nb;
-        dyn_items[dyn_items_nb].kind = ACCOUNT;
-        dyn_items[dyn_items_nb].content.as_item_account.signer_index = i;
-        ++dyn_items_nb;
-        dyn_items[dyn_items_nb].kind = SCOPE;
-        dyn_items[dyn_items_nb].content.as_item_scope.signer_index = i;
-        ++dyn_items_nb;
-
-        signer_t signer = G_context.tx_info.transaction.signers[i];
-        for (int j = 0; j < signer.allowed_contracts_size; ++j) {
-            dyn_items[dyn_items_nb].kind = CONTRACT;
-            dyn_items[dyn_items_nb].content.as_item_contract.signer_index = i;
-            dyn_items[dyn_items_nb].content.as_item_contract.contract_index = j;
-            ++dyn_items_nb;
-        }
-        for (int j = 0; j < signer.allowed_groups_size; ++j) {
-            dyn_items[dyn_items_nb].kind = GROUP;
-            dyn_items[dyn_items_nb].content.as_item_group.signer_index = i;
-            dyn_items[dyn_items_nb].content.as_item_group.group_index = j;
-            ++dyn_items_nb;
-        }
-    }
 }
 
 
 static void review_final_callback(bool confirmed) {
-    if (confirmed) {
+    if (G_context.state != STATE_PARSED) {
+        // Already rejected because an item could not be displayed, see get_single_action_review_pair()
+        nbgl_useCaseReviewStatus(STATUS_TYPE_TRANSACTION_REJECTED, ui_menu_main);
+    } else if (confirmed) {
         ui_action_validate_transaction(true, false);
         nbgl_useCaseReviewStatus(STATUS_TYPE_TRANSACTION_SIGNED, ui_menu_main);
     } else {
@@ -172,59 +89,43 @@ static void review_final_callback(bool confirmed) {
 }
 
 
-static void format_tag_value(dynamic_slot_t *slot, const dynamic_item_t *item) {
-    signer_t s = G_context.tx_info.transaction.signers[item->content.as_item_scope.signer_index];
-    switch (item->kind) {
-        case SIGNER:
-            format_signer(item->content.as_item_signer.signer_index,
-                          slot->title,
-                          sizeof(slot->title),
-                          slot->text,
-                          sizeof(slot->text));
-            break;
-
-        case ACCOUNT:
-            format_account(&s, slot->title, sizeof(slot->title), slot->text, sizeof(slot->text));
-            break;
-
-        case SCOPE:
-            format_scope(&s, slot->title, sizeof(slot->title), slot->text, sizeof(slot->text));
-            break;
-
-        case CONTRACT:
-            format_contract(&s,
-                            item->content.as_item_contract.contract_index,
-                            slot->title,
-                            sizeof(slot->title),
-                            slot->text,
-                            sizeof(slot->text));
-            break;
-
-        case GROUP:
-            format_group(&s,
-                         item->content.as_item_group.group_index,
-                         slot->title,
-                         sizeof(slot->title),
-                         slot->text,
-                         sizeof(slot->text));
-            break;
+/**
+ * Reject the reviewed transaction or batch when one of its items cannot be displayed, the slot shows it instead of
+ * its stale text. NBGL is still building the page, the review ends with the status shown on its final callback.
+ */
+static void reject_undisplayable_item(dynamic_slot_t *slot, void (*validate)(bool, bool)) {
+    strlcpy(slot->text, "Cannot be displayed", sizeof(slot->text));
+    if (G_context.state == STATE_PARSED) {
+        validate(false, false);
     }
 }
 
 // function called by NBGL to get the current_pair indexed by "index"
 static nbgl_contentTagValue_t *get_single_action_review_pair(uint8_t index) {
-    current_pair.valueIcon = NULL;
-    if (index < static_items_nb) {
-        // No need to copy to dyn_slots as item and value are pointers to static values
-        current_pair.item = static_items[index].item;
-        current_pair.value = static_items[index].value;
+    // Every property is formatted on demand, only the pairs currently displayed need a slot
+    dynamic_slot_t *slot = &dyn_slots[index % ARRAY_COUNT(dyn_slots)];
+    bool formatted;
+    if (index < transfer_items_nb) {
+        formatted = format_transfer_item(index, slot->title, sizeof(slot->title), slot->text, sizeof(slot->text));
+    } else if (index - transfer_items_nb < ARRAY_COUNT(tx_items)) {
+        formatted = format_tx_item(tx_items[index - transfer_items_nb],
+                                   slot->title,
+                                   sizeof(slot->title),
+                                   slot->text,
+                                   sizeof(slot->text));
     } else {
-        dynamic_item_t *item = &dyn_items[index - static_items_nb];
-        dynamic_slot_t *slot = &dyn_slots[index % ARRAY_COUNT(dyn_slots)];
-        format_tag_value(slot, item);
-        current_pair.item = slot->title;
-        current_pair.value = slot->text;
+        formatted = format_signer_item(index - transfer_items_nb - ARRAY_COUNT(tx_items),
+                                       slot->title,
+                                       sizeof(slot->title),
+                                       slot->text,
+                                       sizeof(slot->text));
+    }
+    if (!formatted) {
+        reject_undisplayable_item(slot, ui_action_validate_transaction);
     }
+    current_pair.valueIcon = NULL;
+    current_pair.item = slot->title;
+    current_pair.value = slot->text;
     return &current_pair;
 }
 
@@ -233,8 +134,54 @@ static void arbitrary_script_rejection_callback(bool confirmed) {
     ui_menu_settings(confirmed);
 }
 
-void start_sign_tx_ui(void) {
-    if (!G_context.tx_info.transaction.is_system_asset_transfer && !G_context.tx_info.transaction.is_vote_script &&
+static void review_batch_callback(bool confirmed) {
+    if (G_context.state != STATE_PARSED) {
+        // Already rejected because an item could not be displayed, see get_batch_review_pair()
+        nbgl_useCaseReviewStatus(STATUS_TYPE_TRANSACTION_REJECTED, ui_menu_main);
+        return;
+    }
+    ui_action_validate_batch(confirmed, false);
+    if (confirmed) {
+        nbgl_useCaseReviewStatus(STATUS_TYPE_TRANSACTION_SIGNED, ui_menu_main);
+    } else {
+        nbgl_useCaseReviewStatus(STATUS_TYPE_TRANSACTION_REJECTED, ui_menu_main);
+    }
+}
+
+// function called by NBGL to get the batch review pair indexed by "index"
+static nbgl_contentTagValue_t *get_batch_review_pair(uint8_t index) {
+    dynamic_slot_t *slot = &dyn_slots[index % ARRAY_COUNT(dyn_slots)];
+
+    if (!format_batch_item(index, slot->title, sizeof(slot->title), slot->text, sizeof(slot->text))) {
+        reject_undisplayable_item(slot, ui_action_validate_batch);
+    }
+    current_pair.valueIcon = NULL;
+    current_pair.item = slot->title;
+    current_pair.value = slot->text;
+    return &current_pair;
+}
+
+int start_sign_batch_ui(void) {
+    content.nbMaxLinesForValue = 0;
+    content.smallCaseForValue = false;
+    content.wrapping = true;
+    content.pairs = NULL;  // to indicate that callback should be used
+    content.callback = get_batch_review_pair;
+    content.startIndex = 0;
+    content.nbPairs = get_batch_items_count();
+
+    nbgl_useCaseReview(TYPE_TRANSACTION,
+                       &content,
+                       &C_icon_neo_n3_64x64,
+                       "Review batch of\ntransactions",
+                       "The transactions of the batch will be signed without further review",
+                       "Approve batch of\ntransactions?",
+                       review_batch_callback);
+    return 0;
+}
+
+int start_sign_tx_ui(void) {
+    if (!G_context.tx_info.transaction.is_token_transfer && !G_context.tx_info.transaction.is_vote_script &&
         !N_storage.scriptsAllowed) {
         // TODO: maybe add a mechanism to resume the transaction if the user allows the setting
         nbgl_useCaseChoice(&C_Warning_64px,
@@ -247,6 +194,15 @@ void start_sign_tx_ui(void) {
     } else {
         // Prepare steps
         create_transaction_flow();
+
+        // The review pairs are indexed by a uint8_t, 2 items per transfer fit in any case
+        transfer_items_nb = get_transfer_items_count();
+        uint16_t signer_items_nb = get_signer_items_count();
+        if (transfer_items_nb + ARRAY_COUNT(tx_items) + signer_items_nb > UINT8_MAX) {
+            G_context.state = STATE_NONE;
+            return io_send_sw(SW_DISPLAY_SIGNERS_FAIL);
+        }
+
         // start display
         content.nbMaxLinesForValue = 0;
         content.smallCaseForValue = false;
@@ -254,7 +210,7 @@ void start_sign_tx_ui(void) {
         content.pairs = NULL;  // to indicate that callback should be used
         content.callback = get_single_action_review_pair;
         content.startIndex = 0;
-        content.nbPairs = static_items_nb + dyn_items_nb;
+        content.nbPairs = transfer_items_nb + ARRAY_COUNT(tx_items) + signer_items_nb;
 
         nbgl_useCaseReview(
             TYPE_TRANSACTION,
@@ -265,6 +221,7 @@ void start_sign_tx_ui(void) {
             review_final_long_press_text,
             review_final_callback);
     }
+    return 0;
 }
 
 #endif
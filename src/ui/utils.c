@@ -30,6 +30,12 @@
  */
 #define VERIFICATION_SCRIPT_LENGTH 40
 
+void compress_public_key(const uint8_t public_key[static 64], uint8_t out[static 33]) {
+    // the prefix gives the parity of y, followed by x
+    out[0] = ((public_key[63] & 1) ? 0x03 : 0x02);
+    memcpy(&out[1], public_key, 32);
+}
+
 bool create_signature_redeem_script(const uint8_t* public_key, uint8_t* out, size_t out_len) {
     if (out_len != VERIFICATION_SCRIPT_LENGTH) {
         return false;
@@ -37,8 +43,7 @@ bool create_signature_redeem_script(const uint8_t* public_key, uint8_t* out, siz
 
     // we first have to compress the public key
     uint8_t compressed_key[33];
-    compressed_key[0] = ((public_key[63] & 1) ? 0x03 : 0x02);
-    memcpy(&compressed_key[1], public_key, 32);
+    compress_public_key(public_key, compressed_key);
 
     out[0] = 0xc;   // OpCode.PUSHDATA1;
     out[1] = 0x21;  // data size, 33 bytes for compressed public key
@@ -64,15 +69,13 @@ void public_key_hash160(const unsigned char* in, unsigned short inlen, unsigned
     CX_ASSERT(cx_hash_no_throw(&u.riprip.header, CX_LAST, buffer, 32, out, 20));
 }
 
-void script_hash_to_address(char* out, size_t out_len, const unsigned char* script_hash) {
-
+/**
+ * Compute the base58check checksum of the version and script hash of an address.
+ */
+static void address_checksum(const unsigned char* address, unsigned char checksum[static SCRIPT_HASH_CHECKSUM_LEN]) {
     static cx_sha256_t data_hash;
     unsigned char data_hash_1[SHA256_HASH_LEN];
     unsigned char data_hash_2[SHA256_HASH_LEN];
-    unsigned char address[ADDRESS_LEN_PRE];
-
-    address[0] = ADDRESS_VERSION;
-    memcpy(&address[1], script_hash, UINT160_LEN);
 
     // do a sha256 hash of the address twice.
     cx_sha256_init(&data_hash);
@@ -81,28 +84,66 @@ void script_hash_to_address(char* out, size_t out_len, const unsigned char* scri
     CX_ASSERT(cx_hash_no_throw(&data_hash.header, CX_LAST, data_hash_1, SHA256_HASH_LEN, data_hash_2, 32));
 
     // the first 4 bytes of the final hash is the checksum for base58check encode
-    // append to the end of the data
-    memcpy(&address[1 + UINT160_LEN], data_hash_2, SCRIPT_HASH_CHECKSUM_LEN);
+    memcpy(checksum, data_hash_2, SCRIPT_HASH_CHECKSUM_LEN);
+}
 
-    base58_encode(address, sizeof(address), out, out_len);
+bool script_hash_to_address(char* out, size_t out_len, const unsigned char* script_hash) {
+    unsigned char address[ADDRESS_LEN_PRE];
 
+    address[0] = ADDRESS_VERSION;
+    memcpy(&address[1], script_hash, UINT160_LEN);
+
+    // append the checksum to the end of the data
+    address_checksum(address, &address[1 + UINT160_LEN]);
+
+    // the encoder does not terminate the string, keep room for the '\0'
+    int len = out_len > 0 ? base58_encode_address(address, out, out_len - 1) : -1;
+    if (len < 0 || (size_t) len > out_len - 1) {
+        return false;
+    }
+    out[len] = '\0';
+    return true;
 }
 
-bool address_from_pubkey(const uint8_t public_key[static 64], char* out, size_t out_len) {
-    // we need to go through 3 steps
+bool base58check_decode_address(const char* address, size_t address_len, uint8_t script_hash[static UINT160_LEN]) {
+    unsigned char decoded[ADDRESS_LEN_PRE];
+    unsigned char checksum[SCRIPT_HASH_CHECKSUM_LEN];
+
+    if (base58_decode_address(address, address_len, decoded) != ADDRESS_LEN_PRE || decoded[0] != ADDRESS_VERSION) {
+        return false;
+    }
+
+    address_checksum(decoded, checksum);
+    if (memcmp(checksum, &decoded[1 + UINT160_LEN], SCRIPT_HASH_CHECKSUM_LEN) != 0) {
+        return false;
+    }
+
+    memcpy(script_hash, &decoded[1], UINT160_LEN);
+    return true;
+}
+
+bool script_hash_from_pubkey(const uint8_t public_key[static 64], uint8_t script_hash[static UINT160_LEN]) {
     // 1. create a verification script with the public key
     // 2. create a script hash of the verification script (using sha256 + ripemd160)
-    // 3. base58check encode the NEO account version + script hash to get the address
     unsigned char verification_script[VERIFICATION_SCRIPT_LENGTH];
-    unsigned char script_hash[UINT160_LEN];
 
-    // step 1
     if (!create_signature_redeem_script(public_key, verification_script, sizeof(verification_script))) {
         return false;
     }
-    // step 2
     public_key_hash160(verification_script, sizeof(verification_script), script_hash);
-    // step 3
-    script_hash_to_address(out, out_len, script_hash);
     return true;
 }
+
+bool address_from_pubkey(const uint8_t public_key[static 64], char* out, size_t out_len) {
+    // we need to go through 2 steps
+    // 1. create the script hash of the verification script of the public key
+    // 2. base58check encode the NEO account version + script hash to get the address
+    unsigned char script_hash[UINT160_LEN];
+
+    // step 1
+    if (!script_hash_from_pubkey(public_key, script_hash)) {
+        return false;
+    }
+    // step 2
+    return script_hash_to_address(out, out_len, script_hash);
+}
@@ -8,8 +8,24 @@
 
 #define ARRAY_COUNT(array) (sizeof(array) / sizeof(array[0]))
 
+void compress_public_key(const uint8_t public_key[static 64], uint8_t out[static 33]);
+
+bool script_hash_from_pubkey(const uint8_t public_key[static 64], uint8_t script_hash[static 20]);
+
 bool address_from_pubkey(const uint8_t public_key[static 64], char* out, size_t out_len);
 
-void script_hash_to_address(char* out, size_t out_len, const unsigned char* script_hash);
+/**
+ * Format the NEO N3 address of 'script_hash' in 'out', a string of ADDRESS_LEN characters terminated by '\0'.
+ *
+ * @return true if the address fits in 'out_len' bytes, false otherwise.
+ */
+bool script_hash_to_address(char* out, size_t out_len, const unsigned char* script_hash);
+
+/**
+ * Get the script hash of a NEO N3 address, checking its version and base58check checksum.
+ *
+ * @return true if the address is valid, false otherwise.
+ */
+bool base58check_decode_address(const char* address, size_t address_len, uint8_t script_hash[static 20]);
 
 #define DISPLAYABLE_APPNAME "Neo N3"
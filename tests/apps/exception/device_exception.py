@@ -18,6 +18,8 @@ class DeviceException(Exception):  # pylint: disable=too-few-public-methods
         0xB003: TxRejectSignError,
         0xB004: BadStateError,
         0xB005: SignatureFailError,
+        0xB006: BatchParsingError,
+        0xB007: TxNotInBatchError,
         0xB100: BIP44BadPurposeError,
         0xB101: BIP44BadCoinTypeError,
         0xB102: BIP44BadAccountNotHardenedError,
@@ -29,6 +31,8 @@ class DeviceException(Exception):  # pylint: disable=too-few-public-methods
         0xB108: DisplayNetworkFeeFailError,
         0xB109: DisplayTotalFeeFailError,
         0xB10A: DisplayTransferAmountError,
+        0xB10B: DisplayScriptHashFailError,
+        0xB10C: DisplaySignersFailError,
         0xB200: ConvertToAddressFailError
     }
 
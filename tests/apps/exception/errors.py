@@ -54,6 +54,14 @@ class SignatureFailError(Exception):
     pass
 
 
+class BatchParsingError(Exception):
+    pass
+
+
+class TxNotInBatchError(Exception):
+    pass
+
+
 class TxRejectSignError(Exception):
     pass
 
@@ -102,5 +110,13 @@ class DisplayTransferAmountError(Exception):
     pass
 
 
+class DisplayScriptHashFailError(Exception):
+    pass
+
+
+class DisplaySignersFailError(Exception):
+    pass
+
+
 class ConvertToAddressFailError(Exception):
     pass
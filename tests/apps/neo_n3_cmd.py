@@ -1,10 +1,10 @@
 import struct
-from typing import Tuple, Generator
+from typing import List, Tuple, Generator
 from contextlib import contextmanager
 
 from ragger.backend.interface import BackendInterface, RAPDU
 
-from .neo_n3_cmd_builder import Neo_n3_CommandBuilder, InsType
+from .neo_n3_cmd_builder import Neo_n3_CommandBuilder, InsType, SigFormat
 
 from .transaction import Transaction
 from neo3.network import payloads
@@ -63,15 +63,52 @@ class Neo_n3_Command:
         rapdu = self.backend.exchange_raw(cmd)
         return rapdu.data.decode("ascii")
 
-    def get_public_key(self, bip44_path: str) -> bytes:
+    def get_public_key(self, bip44_path: str, compressed: bool = False) -> bytes:
         response = self.backend.exchange_raw(
-            self.builder.get_public_key(bip44_path=bip44_path, display=False)
+            self.builder.get_public_key(bip44_path=bip44_path, display=False, compressed=compressed)
         ).data
 
-        assert len(response) == 65 # 04 + 64 bytes of uncompressed key
+        if compressed:
+            assert len(response) == 33 # 02 or 03 + 32 bytes of x
+        else:
+            assert len(response) == 65 # 04 + 64 bytes of uncompressed key
 
         return response
 
+    def get_public_keys(self, bip44_path: str, count: int) -> List[bytes]:
+        response = self.backend.exchange_raw(
+            self.builder.get_public_keys(bip44_path=bip44_path, count=count)
+        ).data
+
+        keys: List[bytes] = []
+        while True:
+            # response = count (1) || public_key{1} (65) || ... || public_key{count} (65)
+            assert len(response) == 1 + 65 * response[0]
+            keys += [response[1 + 65 * i:1 + 65 * (i + 1)] for i in range(response[0])]
+            if len(keys) == count:
+                return keys
+            response = self.backend.exchange_raw(self.builder.get_public_keys_next()).data
+
+    def get_extended_public_key(self, account_path: str) -> Tuple[bytes, bytes]:
+        response = self.backend.exchange_raw(
+            self.builder.get_extended_public_key(account_path=account_path)
+        ).data
+
+        # response = uncompressed public_key (65) || chain_code (32)
+        assert len(response) == 65 + 32
+
+        return response[:65], response[65:]
+
+    def get_address(self, bip44_path: str) -> Tuple[str, bytes, bytes]:
+        response = self.backend.exchange_raw(
+            self.builder.get_address(bip44_path=bip44_path, with_script_hash=True, with_public_key=True)
+        ).data
+
+        # response = address (34) || script_hash (20) || uncompressed public_key (65)
+        assert len(response) == 34 + 20 + 65
+
+        return response[:34].decode("ascii"), response[34:54], response[54:]
+
     @contextmanager
     def get_public_key_async(self, bip44_path: str) -> Generator[RAPDU, None, None]:
         payload = self.builder.get_public_key(bip44_path=bip44_path, display=True)
@@ -79,10 +116,12 @@ class Neo_n3_Command:
             yield response
 
     @contextmanager
-    def sign_tx(self, bip44_path: str, transaction: payloads.transaction.Transaction, network_magic: int) -> Generator[RAPDU, None, None]:
+    def sign_tx(self, bip44_path: str, transaction: payloads.transaction.Transaction, network_magic: int,
+                sig_format: SigFormat = SigFormat.DER) -> Generator[RAPDU, None, None]:
         for is_last, chunk in self.builder.sign_tx(bip44_path=bip44_path,
                                                    transaction=transaction,
-                                                   network_magic=network_magic):
+                                                   network_magic=network_magic,
+                                                   sig_format=sig_format):
             if not is_last:
                 self.backend.exchange_raw(chunk)
             else:
@@ -34,6 +34,17 @@ class InsType(enum.IntEnum):
     INS_GET_VERSION = 0x01
     INS_SIGN_TX = 0x02
     INS_GET_PUBLIC_KEY = 0x04
+    INS_GET_PUBLIC_KEYS = 0x05
+    INS_GET_EXTENDED_PUBLIC_KEY = 0x06
+    INS_SIGN_TX_BATCH = 0x07
+    INS_GET_ADDRESS = 0x08
+
+
+class SigFormat(enum.IntEnum):
+    """Encoding of the signatures, set with P2 of the first APDU of INS_SIGN_TX and INS_SIGN_TX_BATCH."""
+    DER = 0x00
+    RS = 0x02
+    INVOCATION_SCRIPT = 0x04
 
 
 class Neo_n3_CommandBuilder:
@@ -143,13 +154,17 @@ class Neo_n3_CommandBuilder:
                               p2=0x00,
                               cdata=b"")
 
-    def get_public_key(self, bip44_path: str, display: bool) -> bytes:
+    def get_public_key(self, bip44_path: str, display: bool, compressed: bool = False) -> bytes:
         """Command builder for GET_PUBLIC_KEY.
 
         Parameters
         ----------
         bip44_path: str
             String representation of BIP44 path.
+        display: bool
+            Whether to display the address for approval.
+        compressed: bool
+            Whether to get the compressed public key (33 bytes) instead of the uncompressed one (65 bytes).
 
         Returns
         -------
@@ -160,11 +175,92 @@ class Neo_n3_CommandBuilder:
         return self.serialize(cla=self.CLA,
                               ins=InsType.INS_GET_PUBLIC_KEY,
                               p1=0x00,
-                              p2=int(display == True),
+                              p2=int(display == True) | (int(compressed == True) << 1),
                               cdata=pack_derivation_path(bip44_path)[1:]) # No length prefix
 
-    def sign_tx(self, bip44_path: str, transaction: payloads.transaction.Transaction, network_magic: int
-                ) -> Iterator[Tuple[bool, bytes]]:
+    def get_public_keys(self, bip44_path: str, count: int) -> bytes:
+        """Command builder for the first APDU of GET_PUBLIC_KEYS.
+
+        Parameters
+        ----------
+        bip44_path: str
+            String representation of the BIP44 path of the first public key.
+        count: int
+            Number of consecutive address indexes to export.
+
+        Returns
+        -------
+        bytes
+            APDU command for GET_PUBLIC_KEYS.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_PUBLIC_KEYS,
+                              p1=0x00,
+                              p2=0x00,
+                              cdata=pack_derivation_path(bip44_path)[1:] + struct.pack("B", count))
+
+    def get_public_keys_next(self) -> bytes:
+        """Command builder for the following APDUs of GET_PUBLIC_KEYS.
+
+        Returns
+        -------
+        bytes
+            APDU command for the next page of GET_PUBLIC_KEYS.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_PUBLIC_KEYS,
+                              p1=0x01,
+                              p2=0x00,
+                              cdata=b"")
+
+    def get_extended_public_key(self, account_path: str) -> bytes:
+        """Command builder for GET_EXTENDED_PUBLIC_KEY.
+
+        Parameters
+        ----------
+        account_path: str
+            String representation of the account level of a BIP44 path (m/44'/888'/account').
+
+        Returns
+        -------
+        bytes
+            APDU command for GET_EXTENDED_PUBLIC_KEY.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_EXTENDED_PUBLIC_KEY,
+                              p1=0x00,
+                              p2=0x00,
+                              cdata=pack_derivation_path(account_path)[1:]) # No length prefix
+
+    def get_address(self, bip44_path: str, with_script_hash: bool = False, with_public_key: bool = False) -> bytes:
+        """Command builder for GET_ADDRESS.
+
+        Parameters
+        ----------
+        bip44_path: str
+            String representation of BIP44 path.
+        with_script_hash: bool
+            Whether the script hash of the account follows the address in the response.
+        with_public_key: bool
+            Whether the uncompressed public key follows the address in the response.
+
+        Returns
+        -------
+        bytes
+            APDU command for GET_ADDRESS.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_ADDRESS,
+                              p1=0x00,
+                              p2=int(with_script_hash) | (int(with_public_key) << 1),
+                              cdata=pack_derivation_path(bip44_path)[1:]) # No length prefix
+
+    def sign_tx(self, bip44_path: str, transaction: payloads.transaction.Transaction, network_magic: int,
+                open_session: bool = False, sig_format: SigFormat = SigFormat.DER) -> Iterator[Tuple[bool, bytes]]:
         """Command builder for INS_SIGN_TX.
 
         Parameters
@@ -173,6 +269,8 @@ class Neo_n3_CommandBuilder:
             String representation of BIP44 path.
         transaction : payloads.transaction.Transaction
         network_magic: network magic for MainNet, TestNet or a private network.
+        open_session: whether to send the BIP44 path, network magic and first transaction bytes in a single APDU.
+        sig_format: encoding of the returned signature.
 
         Yields
         -------
@@ -180,34 +278,106 @@ class Neo_n3_CommandBuilder:
             APDU command chunk for INS_SIGN_TX.
 
         """
-        yield False, self.serialize(cla=self.CLA,
-                                    ins=InsType.INS_SIGN_TX,
-                                    p1=0x00,
-                                    p2=0x80,
-                                    cdata=pack_derivation_path(bip44_path)[1:]) # No length prefix
-
+        path: bytes = pack_derivation_path(bip44_path)[1:] # No length prefix
         magic = struct.pack("I", network_magic)
-        yield False, self.serialize(cla=self.CLA,
-                                    ins=InsType.INS_SIGN_TX,
-                                    p1=0x01,
-                                    p2=0x80,
-                                    cdata=magic)
 
         with serialization.BinaryWriter() as writer:
             transaction.serialize_unsigned(writer)
             tx: bytes = writer.to_array()
 
+        if open_session:
+            head: bytes = tx[:MAX_APDU_LEN - len(path) - len(magic)]
+            tx = tx[len(head):]
+            yield not tx, self.serialize(cla=self.CLA,
+                                         ins=InsType.INS_SIGN_TX,
+                                         p1=0x00,
+                                         p2=(0x80 if tx else 0x00) | 0x01 | sig_format,
+                                         cdata=path + magic + head)
+            if not tx:
+                return
+        else:
+            yield False, self.serialize(cla=self.CLA,
+                                        ins=InsType.INS_SIGN_TX,
+                                        p1=0x00,
+                                        p2=0x80 | sig_format,
+                                        cdata=path)
+
+            yield False, self.serialize(cla=self.CLA,
+                                        ins=InsType.INS_SIGN_TX,
+                                        p1=0x01,
+                                        p2=0x80,
+                                        cdata=magic)
+
+        # the transaction chunks are numbered from 2 on, the ones past 0xFF keep it
         for i, (is_last, chunk) in enumerate(chunkify(tx, MAX_APDU_LEN)):
             if is_last:
                 yield True, self.serialize(cla=self.CLA,
                                            ins=InsType.INS_SIGN_TX,
-                                           p1=i + 2,
+                                           p1=min(i + 2, 0xFF),
                                            p2=0x00,
                                            cdata=chunk)
                 return
             else:
                 yield False, self.serialize(cla=self.CLA,
                                             ins=InsType.INS_SIGN_TX,
-                                            p1=i + 2,
+                                            p1=min(i + 2, 0xFF),
                                             p2=0x80,
                                             cdata=chunk)
+
+    def sign_tx_batch(self, bip44_path: str, network_magic: int, count: int, max_fees: int,
+                      tokens: List[Tuple[bytes, int]], destinations: List[bytes],
+                      sig_format: SigFormat = SigFormat.DER) -> bytes:
+        """Command builder for the batch description of INS_SIGN_TX_BATCH.
+
+        Parameters
+        ----------
+        bip44_path : str
+            String representation of BIP44 path.
+        network_magic: network magic for MainNet, TestNet or a private network.
+        count: number of transactions of the batch.
+        max_fees: maximum of system and network fees for the whole batch.
+        tokens: script hash and maximum total amount of each token the batch may transfer.
+        destinations: script hashes the batch may transfer tokens to.
+        sig_format: encoding of the signatures returned for the transactions of the batch.
+
+        Returns
+        -------
+        bytes
+            APDU command for the batch description of INS_SIGN_TX_BATCH.
+
+        """
+        cdata: bytes = pack_derivation_path(bip44_path)[1:]  # No length prefix
+        cdata += struct.pack("<IBQB", network_magic, count, max_fees, len(tokens))
+        for script_hash, amount in tokens:
+            cdata += script_hash + struct.pack("<Q", amount)
+        cdata += struct.pack("B", len(destinations)) + b"".join(destinations)
+
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_SIGN_TX_BATCH,
+                              p1=0x00,
+                              p2=sig_format,
+                              cdata=cdata)
+
+    def sign_tx_batch_tx(self, transaction: payloads.transaction.Transaction) -> Iterator[Tuple[bool, bytes]]:
+        """Command builder for a transaction of INS_SIGN_TX_BATCH.
+
+        Parameters
+        ----------
+        transaction : payloads.transaction.Transaction
+
+        Yields
+        -------
+        bytes
+            APDU command chunk for a transaction of INS_SIGN_TX_BATCH.
+
+        """
+        with serialization.BinaryWriter() as writer:
+            transaction.serialize_unsigned(writer)
+            tx: bytes = writer.to_array()
+
+        for is_last, chunk in chunkify(tx, MAX_APDU_LEN):
+            yield is_last, self.serialize(cla=self.CLA,
+                                          ins=InsType.INS_SIGN_TX_BATCH,
+                                          p1=0x01,
+                                          p2=0x00 if is_last else 0x80,
+                                          cdata=chunk)
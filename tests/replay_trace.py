@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Replay an APDU trace (doc/APDU_TRACE.md) against the app running in Speculos.
+
+    python3 replay_trace.py [--host HOST] [--port PORT] [--output OUTPUT] TRACE
+
+Each command of the trace is sent to the APDU port of Speculos and its response compared to the one recorded,
+with the time of the exchange. The commands with a review wait for it to be approved, or rejected, on the
+emulated device. Exits with status 1 if a response differs from the trace.
+"""
+
+import argparse
+import contextlib
+import json
+import socket
+import sys
+import time
+from typing import Dict, List, Tuple
+
+
+def read_trace(path: str) -> List[Dict]:
+    exchanges = []
+    with open(path, encoding="utf-8") as trace:
+        for line in trace:
+            # the trace printed by the device comes with the rest of its log
+            start = line.find("{")
+            if start < 0 or '"command"' not in line:
+                continue
+            exchanges.append(json.loads(line[start:]))
+    return exchanges
+
+
+def recv_exactly(sock: socket.socket, size: int) -> bytes:
+    data = b""
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("connection closed by Speculos")
+        data += chunk
+    return data
+
+
+def exchange(sock: socket.socket, command: bytes) -> Tuple[bytes, bytes]:
+    # the APDU port of Speculos frames the command and the response data with their length, on 4 bytes
+    sock.sendall(len(command).to_bytes(4, "big") + command)
+    size = int.from_bytes(recv_exactly(sock, 4), "big")
+    response = recv_exactly(sock, size)
+    sw = recv_exactly(sock, 2)
+    return response, sw
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Replay an APDU trace against Speculos.")
+    parser.add_argument("trace", help="trace to replay, JSON lines")
+    parser.add_argument("--host", default="127.0.0.1", help="host of Speculos")
+    parser.add_argument("--port", type=int, default=9999, help="APDU port of Speculos")
+    parser.add_argument("--output", help="record the exchanges of the replay to this trace")
+    args = parser.parse_args()
+
+    exchanges = read_trace(args.trace)
+    mismatches = 0
+    recorded_us = 0
+    replayed_us = 0
+
+    with socket.create_connection((args.host, args.port)) as sock, \
+            (open(args.output, "w", encoding="utf-8") if args.output else contextlib.nullcontext()) as output:
+        first_ns = time.monotonic_ns()
+        for n, recorded in enumerate(exchanges, start=1):
+            command = bytes.fromhex(recorded["command"])
+            start_ns = time.monotonic_ns()
+            response, sw = exchange(sock, command)
+            duration_us = (time.monotonic_ns() - start_ns) // 1000
+            recorded_us += recorded.get("duration_us", 0)
+            replayed_us += duration_us
+
+            if response != bytes.fromhex(recorded["response"]) or sw != bytes.fromhex(recorded["sw"]):
+                mismatches += 1
+                print(f"exchange {n}: response differs\n"
+                      f"  command  {command.hex()}\n"
+                      f"  expected {recorded['response']}{recorded['sw']}\n"
+                      f"  actual   {response.hex()}{sw.hex()}",
+                      file=sys.stderr)
+            if output:
+                output.write(json.dumps({
+                    "command": command.hex().upper(),
+                    "response": response.hex().upper(),
+                    "sw": sw.hex().upper(),
+                    "ts_us": (start_ns - first_ns) // 1000,
+                    "duration_us": duration_us
+                }, separators=(",", ":")) + "\n")
+
+    print(f"{len(exchanges)} exchanges replayed, {mismatches} mismatches")
+    if exchanges:
+        print(f"{replayed_us / len(exchanges):.1f} us per exchange with Speculos, "
+              f"{recorded_us / len(exchanges):.1f} us as recorded")
+    return 0 if mismatches == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -6,6 +6,9 @@ from ragger.navigator import NavInsID, NavIns
 from ragger.bip import calculate_public_key_and_chaincode, CurveChoice
 from ragger.backend import RaisePolicy
 
+from neo3.core import types, to_script_hash
+from neo3.wallet.utils import script_hash_to_address
+
 ROOT_SCREENSHOT_PATH = Path(__file__).parent.resolve()
 
 def test_get_public_key_no_confirm(backend, firmware):
@@ -16,6 +19,98 @@ def test_get_public_key_no_confirm(backend, firmware):
         assert pub_key.hex() == ref_public_key
         print(pub_key.hex())
 
+def test_get_public_key_compressed(backend, firmware):
+    client = Neo_n3_Command(backend)
+    for path in ["m/44'/888'/0'/0/0", "m/44'/888'/1'/0/0", "m/44'/888'/10'/1/23"]:
+        pub_key = client.get_public_key(bip44_path=path, compressed=True)
+        ref_public_key, _ = calculate_public_key_and_chaincode(curve=CurveChoice.Nist256p1, path=path)
+        ref_public_key = bytes.fromhex(ref_public_key)
+        # parity of y, followed by x
+        assert pub_key == bytes([0x03 if ref_public_key[64] & 1 else 0x02]) + ref_public_key[1:33]
+
+def test_get_public_key_invalid(backend, firmware):
+    client = Neo_n3_Command(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    apdu = bytearray(client.builder.get_public_key(bip44_path="m/44'/888'/0'/0/0", display=False))
+    for p1, p2 in [(0x01, 0x00), (0x00, 0x04)]:
+        apdu[2], apdu[3] = p1, p2
+        assert backend.exchange_raw(bytes(apdu)).status == 0x6A86 # Wrong P1P2
+
+def test_get_address(backend, firmware):
+    client = Neo_n3_Command(backend)
+    for path in ["m/44'/888'/0'/0/0", "m/44'/888'/1'/0/0", "m/44'/888'/10'/1/23"]:
+        address, script_hash, pub_key = client.get_address(bip44_path=path)
+        ref_public_key, _ = calculate_public_key_and_chaincode(curve=CurveChoice.Nist256p1, path=path)
+        assert pub_key.hex() == ref_public_key
+
+        # PUSHDATA1 33 compressed public key, SYSCALL System.Crypto.CheckSig
+        compressed_key = bytes([0x03 if pub_key[64] & 1 else 0x02]) + pub_key[1:33]
+        verification_script = b'\x0c\x21' + compressed_key + b'\x41\x56\xe7\xb3\x27'
+        assert script_hash == to_script_hash(verification_script).to_array()
+        assert address == script_hash_to_address(types.UInt160(script_hash))
+
+        # the address alone
+        response = backend.exchange_raw(client.builder.get_address(bip44_path=path)).data
+        assert response.decode("ascii") == address
+
+
+def test_get_public_keys(backend, firmware):
+    client = Neo_n3_Command(backend)
+    for account, start, count in [(0, 0, 1), (0, 0, 3), (1, 7, 10)]:
+        pub_keys = client.get_public_keys(bip44_path=f"m/44'/888'/{account}'/0/{start}", count=count)
+        assert len(pub_keys) == count
+        for i, pub_key in enumerate(pub_keys):
+            path = f"m/44'/888'/{account}'/0/{start + i}"
+            ref_public_key, _ = calculate_public_key_and_chaincode(curve=CurveChoice.Nist256p1, path=path)
+            assert pub_key.hex() == ref_public_key
+
+def test_get_public_keys_invalid(backend, firmware):
+    client = Neo_n3_Command(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    # no export started
+    rapdu = backend.exchange_raw(client.builder.get_public_keys_next())
+    assert rapdu.status == 0xB004 # Bad state
+
+    # range past the last valid address index
+    rapdu = backend.exchange_raw(client.builder.get_public_keys(bip44_path="m/44'/888'/0'/0/4990", count=11))
+    assert rapdu.status == 0xB105 # Bad address
+
+    # count out of bounds
+    for count in [0, 101]:
+        rapdu = backend.exchange_raw(client.builder.get_public_keys(bip44_path="m/44'/888'/0'/0/0", count=count))
+        assert rapdu.status == 0x6A87 # Wrong data length
+
+    # data after the range
+    apdu = client.builder.get_public_keys(bip44_path="m/44'/888'/0'/0/0", count=2)
+    apdu = apdu[:4] + bytes([apdu[4] + 1]) + apdu[5:] + b"\x00"
+    rapdu = backend.exchange_raw(apdu)
+    assert rapdu.status == 0x6A87 # Wrong data length
+
+    # export finished
+    client.get_public_keys(bip44_path="m/44'/888'/0'/0/0", count=2)
+    rapdu = backend.exchange_raw(client.builder.get_public_keys_next())
+    assert rapdu.status == 0xB004 # Bad state
+
+def test_get_extended_public_key(backend, firmware):
+    client = Neo_n3_Command(backend)
+    for path in ["m/44'/888'/0'", "m/44'/888'/1'", "m/44'/888'/16'"]:
+        pub_key, chain_code = client.get_extended_public_key(account_path=path)
+        ref_public_key, ref_chain_code = calculate_public_key_and_chaincode(curve=CurveChoice.Nist256p1, path=path)
+        assert pub_key.hex() == ref_public_key
+        assert chain_code.hex() == ref_chain_code
+
+def test_get_extended_public_key_invalid(backend, firmware):
+    client = Neo_n3_Command(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    rapdu = backend.exchange_raw(client.builder.get_extended_public_key(account_path="m/44'/888'/0"))
+    assert rapdu.status == 0xB102 # Account not hardened
+
+    rapdu = backend.exchange_raw(client.builder.get_extended_public_key(account_path="m/44'/888'"))
+    assert rapdu.status == 0x6A87 # Wrong data length
+
 def test_get_public_key_confirm_ok(backend, scenario_navigator):
     client = Neo_n3_Command(backend)
     path = "m/44'/888'/0'/0/0"
@@ -0,0 +1,136 @@
+import struct
+from hashlib import sha256
+
+from apps.neo_n3_cmd import Neo_n3_Command
+from apps.neo_n3_cmd_builder import InsType
+from apps.exception import errors, DeviceException
+
+from ecdsa.curves import NIST256p
+from ecdsa.keys import VerifyingKey
+from ecdsa.util import sigdecode_der
+
+from neo3.network.payloads.transaction import Transaction
+from neo3.network.payloads.verification import WitnessScope, Signer
+from neo3.core import types, serialization
+from neo3 import vm
+from neo3.wallet.utils import address_to_script_hash
+from neo3.api.wrappers import NeoToken, GasToken
+
+from ragger.backend import RaisePolicy
+
+bip44_path: str = "m/44'/888'/0'/0/0"
+magic = 860833102
+
+from_account = address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+to_account = address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+gas_hash = GasToken().hash.to_array()
+
+
+def transfer_tx(amount: int, to: bytes = to_account, scope: WitnessScope = WitnessScope.CALLED_BY_ENTRY,
+                token=GasToken()) -> Transaction:
+    signer = Signer(account=types.UInt160(from_account), scope=scope)
+    sb = vm.ScriptBuilder()
+    sb.emit_contract_call_with_args(token.hash, "transfer", [from_account, to, amount, None])
+    return Transaction(version=0,
+                       nonce=123,
+                       system_fee=100,
+                       network_fee=50,
+                       valid_until_block=1,
+                       attributes=[],
+                       signers=[signer],
+                       script=sb.to_array(),
+                       witnesses=[])
+
+
+def send_batch_tx(client: Neo_n3_Command, tx: Transaction):
+    for _, chunk in client.builder.sign_tx_batch_tx(tx):
+        rapdu = client.backend.exchange_raw(chunk)
+    return rapdu
+
+
+def test_sign_batch(backend, scenario_navigator):
+    client = Neo_n3_Command(backend)
+
+    pk: VerifyingKey = VerifyingKey.from_string(client.get_public_key(bip44_path=bip44_path),
+                                                curve=NIST256p,
+                                                hashfunc=sha256)
+
+    with backend.exchange_async_raw(client.builder.sign_tx_batch(bip44_path=bip44_path,
+                                                                 network_magic=magic,
+                                                                 count=3,
+                                                                 max_fees=450,
+                                                                 tokens=[(gas_hash, 1000)],
+                                                                 destinations=[to_account])):
+        scenario_navigator.review_approve(do_comparison=False)
+    assert backend.last_async_response.status == 0x9000
+
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    for amount in [400, 600]:
+        tx = transfer_tx(amount)
+        rapdu = send_batch_tx(client, tx)
+        assert rapdu.status == 0x9000
+
+        with serialization.BinaryWriter() as writer:
+            tx.serialize_unsigned(writer)
+            tx_data: bytes = writer.to_array()
+        assert pk.verify(signature=rapdu.data,
+                         data=struct.pack("I", magic) + sha256(tx_data).digest(),
+                         hashfunc=sha256,
+                         sigdecode=sigdecode_der) is True
+
+    # the total amount of the batch is spent, which ends it
+    rapdu = send_batch_tx(client, transfer_tx(1))
+    assert DeviceException.exc[rapdu.status] == errors.TxNotInBatchError
+    rapdu = send_batch_tx(client, transfer_tx(0))
+    assert DeviceException.exc[rapdu.status] == errors.BadStateError
+
+
+def test_sign_batch_not_in_batch(backend, scenario_navigator):
+    client = Neo_n3_Command(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    for tx in [transfer_tx(1, to=from_account),                # not an approved destination
+               transfer_tx(1, token=NeoToken()),               # not an approved token
+               transfer_tx(1, scope=WitnessScope.GLOBAL)]:     # signer scope wider than CalledByEntry
+        with backend.exchange_async_raw(client.builder.sign_tx_batch(bip44_path=bip44_path,
+                                                                     network_magic=magic,
+                                                                     count=1,
+                                                                     max_fees=1000,
+                                                                     tokens=[(gas_hash, 1000)],
+                                                                     destinations=[to_account])):
+            scenario_navigator.review_approve(do_comparison=False)
+        rapdu = send_batch_tx(client, tx)
+        assert DeviceException.exc[rapdu.status] == errors.TxNotInBatchError
+
+
+def test_sign_batch_invalid(backend):
+    client = Neo_n3_Command(backend)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    # no transaction is accepted before a batch is approved
+    rapdu = send_batch_tx(client, transfer_tx(1))
+    assert DeviceException.exc[rapdu.status] == errors.BadStateError
+
+    valid = dict(bip44_path=bip44_path, network_magic=magic, count=1, max_fees=1000,
+                 tokens=[(gas_hash, 1000)], destinations=[to_account])
+    for invalid in [dict(count=0),                                      # empty batch
+                    dict(tokens=[]),                                    # no token
+                    dict(tokens=[(b'\x01' * 20, 1)]),                   # unregistered token
+                    dict(tokens=[(gas_hash, 1), (gas_hash, 2)]),        # duplicated token
+                    dict(destinations=[]),                              # no destination
+                    dict(destinations=[to_account] * 9)]:               # too many destinations
+        rapdu = backend.exchange_raw(client.builder.sign_tx_batch(**{**valid, **invalid}))
+        assert DeviceException.exc[rapdu.status] == errors.BatchParsingError
+
+    # trailing bytes after the batch description
+    cdata = client.builder.sign_tx_batch(**valid)[5:] + b'\x00'
+    rapdu = backend.exchange_raw(client.builder.serialize(cla=client.builder.CLA,
+                                                          ins=InsType.INS_SIGN_TX_BATCH,
+                                                          cdata=cdata))
+    assert DeviceException.exc[rapdu.status] == errors.BatchParsingError
+
+    # the batch description is a single APDU
+    apdu = bytearray(client.builder.sign_tx_batch(**valid))
+    apdu[3] = 0x80
+    rapdu = backend.exchange_raw(bytes(apdu))
+    assert DeviceException.exc[rapdu.status] == errors.WrongP1P2Error
@@ -3,10 +3,11 @@ from hashlib import sha256
 from pathlib import Path
 
 from apps.neo_n3_cmd import Neo_n3_Command
+from apps.neo_n3_cmd_builder import SigFormat
 
 from ecdsa.curves import NIST256p
 from ecdsa.keys import VerifyingKey
-from ecdsa.util import sigdecode_der
+from ecdsa.util import sigdecode_der, sigdecode_string
 
 from neo3.network.payloads.transaction import Transaction, HighPriorityAttribute, OracleResponse
 from neo3.network.payloads.verification import Witness, WitnessScope, Signer
@@ -16,6 +17,7 @@ from neo3.wallet.utils import address_to_script_hash
 from neo3.api.wrappers import NeoToken
 
 from ragger.navigator import NavInsID
+from ragger.backend import RaisePolicy
 
 ROOT_SCREENSHOT_PATH = Path(__file__).parent.resolve()
 
@@ -80,6 +82,64 @@ def test_sign_tx(backend, scenario_navigator):
                      sigdecode=sigdecode_der) is True
 
 
+def test_sign_tx_compact_signature(backend, scenario_navigator):
+    client = Neo_n3_Command(backend)
+
+    bip44_path: str = "m/44'/888'/0'/0/0"
+
+    pk: VerifyingKey = VerifyingKey.from_string(
+        client.get_public_key(bip44_path=bip44_path),
+        curve=NIST256p,
+        hashfunc=sha256
+    )
+
+    signer = Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
+                    scope=WitnessScope.CALLED_BY_ENTRY)
+    magic = 860833102
+
+    from_account = address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+    to_account = address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+    sb = vm.ScriptBuilder()
+    sb.emit_contract_call_with_args(NeoToken().hash, "transfer", [from_account, to_account, 11, None])
+    tx = Transaction(version=0,
+                     nonce=123,
+                     system_fee=456,
+                     network_fee=789,
+                     valid_until_block=1,
+                     attributes=[],
+                     signers=[signer],
+                     script=sb.to_array(),
+                     witnesses=[])
+
+    with serialization.BinaryWriter() as writer:
+        tx.serialize_unsigned(writer)
+        tx_data: bytes = writer.to_array()
+
+    for sig_format in [SigFormat.RS, SigFormat.INVOCATION_SCRIPT]:
+        with client.sign_tx(bip44_path=bip44_path,
+                            transaction=tx,
+                            network_magic=magic,
+                            sig_format=sig_format):
+            scenario_navigator.review_approve(do_comparison=False)
+
+        response = backend.last_async_response.data
+        if sig_format == SigFormat.INVOCATION_SCRIPT:
+            # PUSHDATA1 64 r || s
+            assert response[:2] == b'\x0c\x40'
+            response = response[2:]
+        assert len(response) == 64
+        assert pk.verify(signature=response,
+                         data=struct.pack("I", magic) + sha256(tx_data).digest(),
+                         hashfunc=sha256,
+                         sigdecode=sigdecode_string) is True
+
+    # r || s and invocation script are exclusive
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    first_apdu = bytearray(next(client.builder.sign_tx(bip44_path=bip44_path, transaction=tx, network_magic=magic))[1])
+    first_apdu[3] |= SigFormat.RS | SigFormat.INVOCATION_SCRIPT
+    assert backend.exchange_raw(bytes(first_apdu)).status == 0x6A86 # Wrong P1P2
+
+
 def test_sign_vote_script_tx(backend, firmware, navigator, test_name):
     client = Neo_n3_Command(backend)
 
@@ -124,6 +124,23 @@ def send_raw_tx_data(backend: BackendInterface, data: bytes) -> RAPDU:
                                           cdata=data))
 
 
+def send_raw_tx_chunk(backend: BackendInterface, data: bytes, seq: int, more: bool) -> RAPDU:
+    return backend.exchange_raw(serialize(cla=CLA,
+                                          ins=InsType.INS_SIGN_TX,
+                                          p1=seq,
+                                          p2=0x80 if more else 0x00,
+                                          cdata=data))
+
+
+def send_raw_tx_chunks(backend: BackendInterface, data: bytes, chunk_size: int = 255) -> RAPDU:
+    # send the transaction over as many APDUs as needed, returning the response of the last one
+    chunks = [data[i:i + chunk_size] for i in range(0, len(data), chunk_size)]
+    for i, chunk in enumerate(chunks[:-1]):
+        rapdu = send_raw_tx_chunk(backend, chunk, seq=i + 2, more=True)
+        assert rapdu.status == 0x9000
+    return send_raw_tx_chunk(backend, chunks[-1], seq=len(chunks) + 1, more=False)
+
+
 def test_invalid_version_value(backend, firmware):
     send_bip44_and_magic(backend)
     version = struct.pack("B", 1)  # version should be 0
@@ -217,20 +234,39 @@ def test_signers_length(backend, firmware):
 
 
 def test_signers_length2(backend, firmware):
-    # test signer length too large (3 vs max 2 allowed)
+    # test signer length too large (17 vs max 16 allowed)
     send_bip44_and_magic(backend)
     version = b'\x00'
     nonce = b'\x00' * 4
     system_fee = struct.pack(">q", 0)
     network_fee = struct.pack(">q", 0)
     valid_until_block = b'\x00' * 4
-    signer_length = b'\x03'  # max allowed is 2
+    signer_length = b'\x11'  # max allowed is 16
     backend.raise_policy = RaisePolicy.RAISE_NOTHING
     rapdu = send_raw_tx_data(backend, version + nonce + system_fee + network_fee + valid_until_block + signer_length)
     assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
     assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.SIGNER_LENGTH_VALUE_ERROR
 
 
+def test_signers_max_count(backend, firmware):
+    # 16 signers are accepted, as shown by the 16th signer failing on its account and not on the signers length
+    send_bip44_and_magic(backend)
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack(">q", 0)
+    network_fee = struct.pack(">q", 0)
+    valid_until_block = b'\x00' * 4
+    signer_length = b'\x10'
+    scope = WitnessScope.CALLED_BY_ENTRY.to_bytes(1, 'little')
+    signers = b''.join(struct.pack("<I", i) + b'\x00' * 16 + scope for i in range(15))
+    duplicate_account = b'\x00' * 20
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = send_raw_tx_chunks(backend, version + nonce + system_fee + network_fee + valid_until_block + signer_length
+                               + signers + duplicate_account)
+    assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
+    assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.SIGNER_ACCOUNT_DUPLICATE_ERROR
+
+
 def test_signers_account(backend, firmware):
     send_bip44_and_magic(backend)
     version = b'\x00'
@@ -339,7 +375,7 @@ def test_signers_scope_groups(backend, firmware):
 
     scope = WitnessScope.CUSTOM_GROUPS
     scope = scope.to_bytes(1, 'little')
-    groups_count = b'\x03'
+    groups_count = b'\x11'  # max allowed is 16
 
     data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope + groups_count
     backend.raise_policy = RaisePolicy.RAISE_NOTHING
@@ -348,6 +384,29 @@ def test_signers_scope_groups(backend, firmware):
     assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.SIGNER_ALLOWED_GROUPS_LENGTH_VALUE_ERROR
 
 
+def test_signers_scope_groups_max_count(backend, firmware):
+    # 16 groups are accepted, parsing only fails on the missing attributes that follow them
+    send_bip44_and_magic(backend)
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack(">q", 0)
+    network_fee = struct.pack(">q", 0)
+    valid_until_block = b'\x00' * 4
+    signer_length = b'\x01'
+    account = b'\x00' * 20  # UInt160
+
+    scope = WitnessScope.CUSTOM_GROUPS
+    scope = scope.to_bytes(1, 'little')
+    groups_count = b'\x10'
+    groups = b'\x02' * 33 * 16  # ECPoints, 33 bytes each
+
+    data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope + groups_count
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = send_raw_tx_chunks(backend, data + groups)
+    assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
+    assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.ATTRIBUTES_LENGTH_PARSING_ERROR
+
+
 def test_signers_scope_groups_no_data(backend, firmware):
     send_bip44_and_magic(backend)
     version = b'\x00'
@@ -462,3 +521,97 @@ def test_script(backend, firmware):
     rapdu = send_raw_tx_data(backend, data)
     assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
     assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.SCRIPT_LENGTH_VALUE_ERROR
+
+
+def test_reject_on_first_bad_chunk(backend, firmware):
+    # a malformed field is reported by the chunk it is in, the remaining chunks are not needed
+    send_bip44_and_magic(backend)
+    version = struct.pack("B", 1)  # version should be 0
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = send_raw_tx_chunk(backend, version + b'\x00' * 4, seq=2, more=True)
+    assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
+    assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.VERSION_VALUE_ERROR
+
+    # the context is reset, so the host can't continue streaming the rejected transaction
+    rapdu = send_raw_tx_chunk(backend, b'\x00' * 8, seq=3, more=False)
+    assert DeviceException.exc[rapdu.status] == errors.BadStateError
+
+
+def test_fields_split_over_chunks(backend, firmware):
+    # the nonce and system fee are split over chunks, the invalid system fee is reported by the chunk completing it
+    send_bip44_and_magic(backend)
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack("<q", -1)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = send_raw_tx_chunk(backend, version + nonce[:2], seq=2, more=True)
+    assert rapdu.status == 0x9000
+    rapdu = send_raw_tx_chunk(backend, nonce[2:] + system_fee[:5], seq=3, more=True)
+    assert rapdu.status == 0x9000
+    rapdu = send_raw_tx_chunk(backend, system_fee[5:], seq=4, more=True)
+    assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
+    assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.SYSTEM_FEE_VALUE_ERROR
+
+
+def test_truncated_in_last_chunk(backend, firmware):
+    # running out of data in the last chunk reports the field being parsed, as with a single chunk transaction
+    send_bip44_and_magic(backend)
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = send_raw_tx_chunk(backend, version + nonce, seq=2, more=True)
+    assert rapdu.status == 0x9000
+    rapdu = send_raw_tx_chunk(backend, b'\x00' * 3, seq=3, more=False)
+    assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
+    assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.SYSTEM_FEE_PARSING_ERROR
+
+
+def send_open_session(backend: BackendInterface, data: bytes, more: bool) -> RAPDU:
+    # BIP44 path, network magic and the first transaction bytes in a single APDU
+    return backend.exchange_raw(serialize(cla=CLA,
+                                          ins=InsType.INS_SIGN_TX,
+                                          p1=0x00,
+                                          p2=(0x80 if more else 0x00) | 0x01,
+                                          cdata=pack_derivation_path(bip44_path)[1:] +
+                                          struct.pack("I", network_magic) + data))
+
+
+def test_open_session(backend, firmware):
+    # the transaction bytes of the first APDU are parsed like any other chunk
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack("<q", -1)
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = send_open_session(backend, version + nonce, more=True)
+    assert rapdu.status == 0x9000
+
+    # chunk 1 carries the network magic, which was already received
+    rapdu = send_raw_tx_chunk(backend, struct.pack("I", network_magic), seq=1, more=True)
+    assert DeviceException.exc[rapdu.status] == errors.BadStateError
+
+    send_open_session(backend, version + nonce, more=True)
+    rapdu = send_raw_tx_chunk(backend, system_fee, seq=2, more=True)
+    assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
+    assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.SYSTEM_FEE_VALUE_ERROR
+
+    # a single APDU transaction, rejected right away
+    rapdu = send_open_session(backend, struct.pack("B", 1), more=False)
+    assert DeviceException.exc[rapdu.status] == errors.TxParsingFailError
+    assert int.from_bytes(rapdu.data, 'little', signed=True) == ParserStatus.VERSION_VALUE_ERROR
+
+
+def test_open_session_invalid(backend, firmware):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    # no network magic after the path
+    rapdu = backend.exchange_raw(serialize(cla=CLA,
+                                           ins=InsType.INS_SIGN_TX,
+                                           p1=0x00,
+                                           p2=0x81,
+                                           cdata=pack_derivation_path(bip44_path)[1:]))
+    assert DeviceException.exc[rapdu.status] == errors.MagicParsingError
+
+    # only the first APDU may open a session
+    send_bip44_and_magic(backend)
+    rapdu = backend.exchange_raw(serialize(cla=CLA, ins=InsType.INS_SIGN_TX, p1=0x03, p2=0x81, cdata=b'\x00'))
+    assert DeviceException.exc[rapdu.status] == errors.WrongP1P2Error
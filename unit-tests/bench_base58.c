@@ -0,0 +1,85 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/base58.h"
+
+/**
+ * Compare base58_encode() and base58_encode_address(), then base58_decode() and base58_decode_address(),
+ * on random addresses.
+ * Not a test: run it by hand, e.g. `./build/bench_base58 1000000`.
+ */
+#define INPUTS_COUNT 1024
+
+static uint8_t inputs[INPUTS_COUNT][BASE58_ADDRESS_INPUT_SIZE];
+static char addresses[INPUTS_COUNT][BASE58_ADDRESS_LEN];
+
+static double bench(const char *name, int (*encode)(const uint8_t *in, char *out), long iterations) {
+    char out[BASE58_ADDRESS_MAX_SIZE];
+    size_t checksum = 0;
+
+    clock_t start = clock();
+    for (long n = 0; n < iterations; n++) {
+        checksum += encode(inputs[n % INPUTS_COUNT], out) + out[0];
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-22s %10.1f ns/address (checksum %zu)\n", name, seconds * 1e9 / iterations, checksum);
+    return seconds;
+}
+
+static double bench_decode(const char *name, int (*decode)(const char *in, uint8_t *out), long iterations) {
+    uint8_t out[BASE58_ADDRESS_INPUT_SIZE];
+    size_t checksum = 0;
+
+    clock_t start = clock();
+    for (long n = 0; n < iterations; n++) {
+        checksum += decode(addresses[n % INPUTS_COUNT], out) + out[BASE58_ADDRESS_INPUT_SIZE - 1];
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-22s %10.1f ns/address (checksum %zu)\n", name, seconds * 1e9 / iterations, checksum);
+    return seconds;
+}
+
+static int decode_generic(const char *in, uint8_t *out) {
+    return base58_decode(in, BASE58_ADDRESS_LEN, out, BASE58_ADDRESS_INPUT_SIZE);
+}
+
+static int decode_address(const char *in, uint8_t *out) {
+    return base58_decode_address(in, BASE58_ADDRESS_LEN, out);
+}
+
+static int encode_generic(const uint8_t *in, char *out) {
+    return base58_encode(in, BASE58_ADDRESS_INPUT_SIZE, out, BASE58_ADDRESS_MAX_SIZE);
+}
+
+static int encode_address(const uint8_t *in, char *out) {
+    return base58_encode_address(in, out, BASE58_ADDRESS_MAX_SIZE);
+}
+
+int main(int argc, char *argv[]) {
+    long iterations = (argc > 1) ? atol(argv[1]) : 200000;
+
+    srand(58);
+    for (size_t n = 0; n < INPUTS_COUNT; n++) {
+        inputs[n][0] = 0x35;  // NEO N3 address version
+        for (size_t i = 1; i < BASE58_ADDRESS_INPUT_SIZE; i++) {
+            inputs[n][i] = rand() & 0xff;
+        }
+        base58_encode_address(inputs[n], addresses[n], BASE58_ADDRESS_LEN);
+    }
+
+    double generic = bench("base58_encode", encode_generic, iterations);
+    double address = bench("base58_encode_address", encode_address, iterations);
+    printf("speedup %.1fx\n", generic / address);
+
+    generic = bench_decode("base58_decode", decode_generic, iterations);
+    address = bench_decode("base58_decode_address", decode_address, iterations);
+    printf("speedup %.1fx\n", generic / address);
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint*_t
+
+/**
+ * Unsigned NEO N3 transactions, as serialized for SIGN_TX, covering the script templates and signer scopes the
+ * app recognizes. The accounts, tokens and candidate are those of the functional tests.
+ */
+
+// clang-format off
+// GAS transfer, CalledByEntry signer (139 bytes)
+static const uint8_t TX_0[] = {
+    0x00, 0xc1, 0x52, 0x1f, 0x3a, 0x8f, 0x39, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd0, 0xc2, 0x12,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0xbc, 0x40, 0x00, 0x01, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84,
+    0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x01, 0x00,
+    0x5a, 0x0b, 0x02, 0x80, 0xd1, 0xf0, 0x08, 0x0c, 0x14, 0x59, 0xa2, 0x55, 0x4d, 0x7c, 0xcc, 0x5f,
+    0x95, 0xaf, 0xb9, 0x28, 0x3e, 0x40, 0x16, 0x48, 0x46, 0xb7, 0xd4, 0xaf, 0x9b, 0x0c, 0x14, 0x4a,
+    0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e,
+    0xca, 0x2c, 0x68, 0x14, 0xc0, 0x1f, 0x0c, 0x08, 0x74, 0x72, 0x61, 0x6e, 0x73, 0x66, 0x65, 0x72,
+    0x0c, 0x14, 0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e, 0xe3, 0x55, 0x61, 0x01,
+    0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2, 0x41, 0x62, 0x7d, 0x5b, 0x52,
+};
+
+// NEO transfer with the HighPriority attribute (136 bytes)
+static const uint8_t TX_1[] = {
+    0x00, 0x7d, 0x6c, 0x5b, 0x0a, 0x8f, 0x39, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa8, 0x1c, 0x13,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xa8, 0xbc, 0x40, 0x00, 0x01, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84,
+    0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x01, 0x01,
+    0x01, 0x56, 0x0b, 0x1a, 0x0c, 0x14, 0x59, 0xa2, 0x55, 0x4d, 0x7c, 0xcc, 0x5f, 0x95, 0xaf, 0xb9,
+    0x28, 0x3e, 0x40, 0x16, 0x48, 0x46, 0xb7, 0xd4, 0xaf, 0x9b, 0x0c, 0x14, 0x4a, 0x9d, 0x07, 0x86,
+    0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68,
+    0x14, 0xc0, 0x1f, 0x0c, 0x08, 0x74, 0x72, 0x61, 0x6e, 0x73, 0x66, 0x65, 0x72, 0x0c, 0x14, 0xf5,
+    0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05, 0xc4, 0x8e, 0xa3, 0x05, 0xb3, 0xf2, 0xa0,
+    0x73, 0x40, 0xef, 0x41, 0x62, 0x7d, 0x5b, 0x52,
+};
+
+// NEO vote for a candidate (142 bytes)
+static const uint8_t TX_2[] = {
+    0x00, 0x04, 0x03, 0x02, 0x01, 0x4d, 0x8c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x68, 0xfd, 0x12,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x39, 0xbe, 0x40, 0x00, 0x01, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84,
+    0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x01, 0x00,
+    0x5d, 0x0c, 0x21, 0x03, 0xb2, 0x09, 0xfd, 0x4f, 0x53, 0xa7, 0x17, 0x0e, 0xa4, 0x44, 0x4e, 0x0c,
+    0xb0, 0xa6, 0xbb, 0x6a, 0x53, 0xc2, 0xbd, 0x01, 0x69, 0x26, 0x98, 0x9c, 0xf8, 0x5f, 0x9b, 0x0f,
+    0xba, 0x17, 0xa7, 0x0c, 0x0c, 0x14, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d,
+    0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x12, 0xc0, 0x1f, 0x0c, 0x04, 0x76,
+    0x6f, 0x74, 0x65, 0x0c, 0x14, 0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05, 0xc4,
+    0x8e, 0xa3, 0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef, 0x41, 0x62, 0x7d, 0x5b, 0x52,
+};
+
+// NEO vote retraction (108 bytes)
+static const uint8_t TX_3[] = {
+    0x00, 0x08, 0x07, 0x06, 0x05, 0x4d, 0x8c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x61, 0x12,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0xbe, 0x40, 0x00, 0x01, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84,
+    0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x01, 0x00,
+    0x3b, 0x0b, 0x0c, 0x14, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5,
+    0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x12, 0xc0, 0x1f, 0x0c, 0x04, 0x76, 0x6f, 0x74,
+    0x65, 0x0c, 0x14, 0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05, 0xc4, 0x8e, 0xa3,
+    0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef, 0x41, 0x62, 0x7d, 0x5b, 0x52,
+};
+
+// batch of 4 transfers of GAS, NEO and FLM (415 bytes)
+static const uint8_t TX_4[] = {
+    0x00, 0x4c, 0x5d, 0x6e, 0x7f, 0x3c, 0xe6, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x98, 0x66, 0x15,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x9c, 0xbe, 0x40, 0x00, 0x01, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84,
+    0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x01, 0x00,
+    0xfd, 0x6c, 0x01, 0x0b, 0x02, 0x00, 0xe1, 0xf5, 0x05, 0x0c, 0x14, 0x59, 0xa2, 0x55, 0x4d, 0x7c,
+    0xcc, 0x5f, 0x95, 0xaf, 0xb9, 0x28, 0x3e, 0x40, 0x16, 0x48, 0x46, 0xb7, 0xd4, 0xaf, 0x9b, 0x0c,
+    0x14, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6,
+    0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x14, 0xc0, 0x1f, 0x0c, 0x08, 0x74, 0x72, 0x61, 0x6e, 0x73, 0x66,
+    0x65, 0x72, 0x0c, 0x14, 0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e, 0xe3, 0x55,
+    0x61, 0x01, 0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2, 0x41, 0x62, 0x7d, 0x5b, 0x52, 0x0b, 0x15, 0x0c,
+    0x14, 0x59, 0xa2, 0x55, 0x4d, 0x7c, 0xcc, 0x5f, 0x95, 0xaf, 0xb9, 0x28, 0x3e, 0x40, 0x16, 0x48,
+    0x46, 0xb7, 0xd4, 0xaf, 0x9b, 0x0c, 0x14, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f,
+    0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x14, 0xc0, 0x1f, 0x0c, 0x08,
+    0x74, 0x72, 0x61, 0x6e, 0x73, 0x66, 0x65, 0x72, 0x0c, 0x14, 0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28,
+    0x3d, 0x4d, 0x0e, 0x05, 0xc4, 0x8e, 0xa3, 0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef, 0x41, 0x62,
+    0x7d, 0x5b, 0x52, 0x0b, 0x03, 0x14, 0x1a, 0x99, 0xbe, 0x1c, 0x00, 0x00, 0x00, 0x0c, 0x14, 0x59,
+    0xa2, 0x55, 0x4d, 0x7c, 0xcc, 0x5f, 0x95, 0xaf, 0xb9, 0x28, 0x3e, 0x40, 0x16, 0x48, 0x46, 0xb7,
+    0xd4, 0xaf, 0x9b, 0x0c, 0x14, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84,
+    0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x14, 0xc0, 0x1f, 0x0c, 0x08, 0x74, 0x72,
+    0x61, 0x6e, 0x73, 0x66, 0x65, 0x72, 0x0c, 0x14, 0x28, 0xab, 0x18, 0x74, 0xda, 0x47, 0xaa, 0xd8,
+    0x2c, 0x9c, 0xb3, 0x51, 0x88, 0x55, 0x27, 0x81, 0x52, 0x1f, 0x15, 0xf0, 0x41, 0x62, 0x7d, 0x5b,
+    0x52, 0x0b, 0x03, 0x00, 0xf9, 0x02, 0x95, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x14, 0x4a, 0x9d, 0x07,
+    0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c,
+    0x68, 0x0c, 0x14, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10,
+    0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x14, 0xc0, 0x1f, 0x0c, 0x08, 0x74, 0x72, 0x61, 0x6e,
+    0x73, 0x66, 0x65, 0x72, 0x0c, 0x14, 0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e,
+    0xe3, 0x55, 0x61, 0x01, 0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2, 0x41, 0x62, 0x7d, 0x5b, 0x52,
+};
+
+// contract call with a custom contracts and groups signer and a global one (212 bytes)
+static const uint8_t TX_5[] = {
+    0x00, 0x44, 0x33, 0x22, 0x11, 0x4e, 0x61, 0xbc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0x24,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0xbf, 0x40, 0x00, 0x02, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84,
+    0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x31, 0x02,
+    0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e, 0xe3, 0x55, 0x61, 0x01, 0x13, 0x19,
+    0xf3, 0xcf, 0xa4, 0xd2, 0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05, 0xc4, 0x8e,
+    0xa3, 0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef, 0x01, 0x02, 0x15, 0x8c, 0x4a, 0x48, 0x10, 0xfa,
+    0x2a, 0x6a, 0x12, 0xf7, 0xd3, 0x3d, 0x83, 0x56, 0x80, 0x42, 0x9e, 0x1a, 0x68, 0xae, 0x61, 0x16,
+    0x1c, 0x5b, 0x3f, 0xbc, 0x98, 0xc7, 0xf1, 0xf1, 0x77, 0x65, 0x59, 0xa2, 0x55, 0x4d, 0x7c, 0xcc,
+    0x5f, 0x95, 0xaf, 0xb9, 0x28, 0x3e, 0x40, 0x16, 0x48, 0x46, 0xb7, 0xd4, 0xaf, 0x9b, 0x80, 0x00,
+    0x43, 0x17, 0x02, 0x00, 0xca, 0x9a, 0x3b, 0x0c, 0x14, 0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15,
+    0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd, 0x3e, 0xca, 0x2c, 0x68, 0x13, 0xc0, 0x1f,
+    0x0c, 0x07, 0x64, 0x65, 0x70, 0x6f, 0x73, 0x69, 0x74, 0x0c, 0x14, 0x28, 0xab, 0x18, 0x74, 0xda,
+    0x47, 0xaa, 0xd8, 0x2c, 0x9c, 0xb3, 0x51, 0x88, 0x55, 0x27, 0x81, 0x52, 0x1f, 0x15, 0xf0, 0x41,
+    0x62, 0x7d, 0x5b, 0x52,
+};
+// clang-format on
+
+typedef struct {
+    const char *name;
+    const uint8_t *data;
+    size_t len;
+} corpus_tx_t;
+
+#define CORPUS_TX(name, tx) {(name), (tx), sizeof(tx)}
+
+static const corpus_tx_t CORPUS[] = {
+    CORPUS_TX("gas_transfer", TX_0),
+    CORPUS_TX("neo_transfer_high_priority", TX_1),
+    CORPUS_TX("vote", TX_2),
+    CORPUS_TX("vote_retract", TX_3),
+    CORPUS_TX("transfers_batch", TX_4),
+    CORPUS_TX("contract_call_scopes", TX_5),
+};
+
+#define CORPUS_COUNT (sizeof(CORPUS) / sizeof(CORPUS[0]))
@@ -0,0 +1,97 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "emulator.h"
+#include "constants.h"
+#include "sw.h"
+#include "types.h"
+
+#include "bench_corpus.h"
+
+/**
+ * Time APDU sessions with the app as a whole, emulated on the host (see emulator/emulator.h).
+ * Not a test: run it by hand or in CI, e.g. `./build/bench_emulator 10000`, in a Release build.
+ *
+ * Each line gives the sessions per second. A session is the APDUs of a client request, with the review of the
+ * request approved as soon as it is displayed. The signatures are computed by OpenSSL, not by the app.
+ */
+
+#define MAINNET_MAGIC 860833102
+
+static const uint32_t BIP44_PATH[BIP44_PATH_LEN] = {0x8000002c, 0x80000378, 0x80000000, 0, 0};
+
+static volatile size_t sink;  // keeps the results alive
+
+/**
+ * Session 'n' of a benchmark, going through its inputs in turn.
+ *
+ * @return false if the session failed.
+ */
+typedef bool (*bench_session_t)(size_t n);
+
+static void bench(const char *name, bench_session_t session, long sessions) {
+    size_t apdus = emu_stats()->exchanges;
+
+    clock_t start = clock();
+    for (long n = 0; n < sessions; n++) {
+        if (!session((size_t) n)) {
+            fprintf(stderr, "%s: session %ld failed\n", name, n);
+            exit(1);
+        }
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    apdus = emu_stats()->exchanges - apdus;
+
+    printf("%-34s %10.0f sessions/s %10.0f APDUs/s\n", name, sessions / seconds, apdus / seconds);
+}
+
+static bool session_get_version(size_t n) {
+    const uint8_t apdu[] = {CLA, GET_VERSION, 0x00, 0x00, 0x00};
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    int rapdu_len = emu_exchange(apdu, sizeof(apdu), rapdu, sizeof(rapdu));
+
+    (void) n;
+    return emu_sw(rapdu, rapdu_len) == SW_OK;
+}
+
+static bool session_get_public_key(size_t n) {
+    // the address index changes every time, past the public keys cache
+    uint8_t apdu[5 + 4 * BIP44_PATH_LEN] = {CLA,  GET_PUBLIC_KEY, 0x00, 0x00, 0x14, 0x80, 0x00, 0x00, 0x2c, 0x80,
+                                            0x00, 0x03,           0x78, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                            0x00, 0x00,           0x00, 0x00, 0x00};
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+
+    apdu[sizeof(apdu) - 2] = (uint8_t) (n >> 8);
+    apdu[sizeof(apdu) - 1] = (uint8_t) n;
+    int rapdu_len = emu_exchange(apdu, sizeof(apdu), rapdu, sizeof(rapdu));
+    sink += rapdu[1];
+    return emu_sw(rapdu, rapdu_len) == SW_OK;
+}
+
+static bool session_sign_tx(size_t n) {
+    const corpus_tx_t *tx = &CORPUS[n % CORPUS_COUNT];
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    int rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, tx->data, tx->len, 0, rapdu, sizeof(rapdu));
+
+    sink += rapdu[4];
+    return emu_sw(rapdu, rapdu_len) == SW_OK;
+}
+
+int main(int argc, char *argv[]) {
+    long sessions = (argc > 1) ? atol(argv[1]) : 5000;
+
+    emu_reset();
+    emu_set_settings(true, false);
+
+    printf("%zu transactions, %ld sessions\n", CORPUS_COUNT, sessions);
+    bench("GET_VERSION", session_get_version, sessions);
+    bench("GET_PUBLIC_KEY (derived)", session_get_public_key, sessions);
+    bench("SIGN_TX (reviewed, signed)", session_sign_tx, sessions);
+
+    const emu_stats_t *stats = emu_stats();
+    printf("%zu reviews, %zu items, %zu errors\n", stats->reviews, stats->review_items, stats->review_errors);
+    return stats->review_errors == 0 ? 0 : 1;
+}
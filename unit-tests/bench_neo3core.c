@@ -0,0 +1,226 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cx.h"
+#include "apdu/parser.h"
+#include "common/base58.h"
+#include "common/buffer.h"
+#include "common/format.h"
+#include "common/varint.h"
+#include "transaction/deserialize.h"
+#include "transaction/tx_utils.h"
+#include "ui/utils.h"
+
+#include "bench_corpus.h"
+
+/**
+ * Time the parsing and formatting paths of the app over a corpus of transactions, built with the neo3core library.
+ * Not a test: run it by hand or in CI, e.g. `./build/bench_neo3core 100000`, in a Release build.
+ *
+ * Each line gives the time per operation and the heap allocations per operation. The app never allocates, a
+ * non-zero count is a regression. Allocations are counted by wrapping malloc() at link time, where the linker
+ * supports it, "-" is printed otherwise.
+ */
+
+#ifdef BENCH_COUNT_ALLOCS
+static size_t allocs;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocs++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    allocs++;
+    return __real_realloc(ptr, size);
+}
+#endif
+
+static volatile size_t sink;  // keeps the results alive
+
+static uint8_t store[TRANSACTION_STORE_LEN];
+static transaction_t parsed[CORPUS_COUNT];
+static uint8_t parsed_store[CORPUS_COUNT][TRANSACTION_STORE_LEN];
+
+/**
+ * An operation on input 'n', each benchmark going through its inputs in turn.
+ */
+typedef size_t (*bench_op_t)(size_t n);
+
+static void bench(const char *name, bench_op_t op, long iterations) {
+    size_t checksum = 0;
+
+#ifdef BENCH_COUNT_ALLOCS
+    allocs = 0;
+#endif
+    clock_t start = clock();
+    for (long n = 0; n < iterations; n++) {
+        checksum += op((size_t) n);
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    sink += checksum;
+
+#ifdef BENCH_COUNT_ALLOCS
+    printf("%-34s %10.1f ns/op %8.2f allocs/op\n", name, seconds * 1e9 / iterations, (double) allocs / iterations);
+#else
+    printf("%-34s %10.1f ns/op %8s allocs/op\n", name, seconds * 1e9 / iterations, "-");
+#endif
+}
+
+static size_t op_transaction_deserialize(size_t n) {
+    const corpus_tx_t *tx = &CORPUS[n % CORPUS_COUNT];
+    buffer_t buf = {.ptr = tx->data, .size = tx->len, .offset = 0};
+    transaction_t out;
+
+    memset(&out, 0, sizeof(out));
+    return (size_t) transaction_deserialize(&buf, &out, store, sizeof(store)) + out.transfers_size;
+}
+
+static size_t op_transaction_parser_feed(size_t n) {
+    const corpus_tx_t *tx = &CORPUS[n % CORPUS_COUNT];
+    tx_parser_t parser;
+    cx_sha256_t tx_hash;
+    cx_sha256_t script_hash;
+    transaction_t out;
+    parser_status_e status = PARSING_OK;
+
+    // as SIGN_TX receives it: APDUs of up to 255 bytes, hashed along the way
+    memset(&out, 0, sizeof(out));
+    cx_sha256_init(&tx_hash);
+    cx_sha256_init(&script_hash);
+    transaction_parser_init(&parser, store, sizeof(store), &tx_hash, &script_hash);
+    for (size_t offset = 0; offset < tx->len && status == PARSING_OK; offset += 255) {
+        size_t chunk = (tx->len - offset < 255) ? tx->len - offset : 255;
+        buffer_t buf = {.ptr = tx->data + offset, .size = chunk, .offset = 0};
+        status = transaction_parser_feed(&parser, &out, &buf, offset + chunk == tx->len);
+    }
+    return (size_t) status + (size_t) tx_hash.header.state;
+}
+
+static size_t op_try_parse_script(size_t n) {
+    transaction_t *tx = &parsed[n % CORPUS_COUNT];
+
+    try_parse_script(tx);
+    return tx->transfers_size + tx->is_vote_script;
+}
+
+static size_t op_base58_encode(size_t n) {
+    uint8_t address[BASE58_ADDRESS_INPUT_SIZE] = {0x35};
+    char out[BASE58_ADDRESS_MAX_SIZE];
+
+    memcpy(address + 1, CORPUS[n % CORPUS_COUNT].data + 26, UINT160_LEN);  // account of the first signer
+    return (size_t) base58_encode(address, sizeof(address), out, sizeof(out)) + (size_t) out[1];
+}
+
+static size_t op_base58_encode_address(size_t n) {
+    uint8_t address[BASE58_ADDRESS_INPUT_SIZE] = {0x35};
+    char out[BASE58_ADDRESS_MAX_SIZE];
+
+    memcpy(address + 1, CORPUS[n % CORPUS_COUNT].data + 26, UINT160_LEN);
+    return (size_t) base58_encode_address(address, out, sizeof(out)) + (size_t) out[1];
+}
+
+static size_t op_script_hash_to_address(size_t n) {
+    char out[BASE58_ADDRESS_MAX_SIZE];
+
+    return (size_t) script_hash_to_address(out, sizeof(out), CORPUS[n % CORPUS_COUNT].data + 26) + (size_t) out[1];
+}
+
+/**
+ * The formatting of an amount before format_amount(): the value by format_fpu64(), then prefixed with its ticker.
+ * format_amount() is slower than format_fpu64() alone (about 48 ns against 38 ns in Release on x86-64), it only
+ * wins once the ticker is added, which costs a snprintf() here (about 45 ns against 155 ns).
+ */
+static size_t op_format_fpu64(size_t n) {
+    const transaction_t *tx = &parsed[n % CORPUS_COUNT];
+    char value[32];
+    char out[32];
+
+    if (!format_fpu64(value, sizeof(value), (uint64_t) (tx->system_fee + tx->network_fee), 8)) {
+        return 0;
+    }
+    return (size_t) snprintf(out, sizeof(out), "%s %.*s", "GAS", (int) sizeof(value), value) + (size_t) out[4];
+}
+
+static size_t op_format_amount(size_t n) {
+    const transaction_t *tx = &parsed[n % CORPUS_COUNT];
+    char out[32];
+
+    return format_amount(out, sizeof(out), "GAS", (uint64_t) (tx->system_fee + tx->network_fee), 8, false) +
+           (size_t) out[4];
+}
+
+static size_t op_format_hex_account(size_t n) {
+    char out[2 * UINT160_LEN + 1];
+
+    return (size_t) format_hex(CORPUS[n % CORPUS_COUNT].data + 26, UINT160_LEN, out, sizeof(out));
+}
+
+static size_t op_format_hex_key(size_t n) {
+    const transaction_t *tx = &parsed[2 + n % 2];  // the votes, the key is zeroed for a retraction
+    char out[2 * ECPOINT_LEN + 1];
+
+    return (size_t) format_hex(tx->vote_to, ECPOINT_LEN, out, sizeof(out));
+}
+
+static size_t op_varint_read(size_t n) {
+    // 1, 3, 5 and 9 bytes encodings
+    static const uint8_t VARINTS[][9] = {{0x8b},
+                                         {0xfd, 0x9f, 0x01},
+                                         {0xfe, 0x00, 0x00, 0x01, 0x00},
+                                         {0xff, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}};
+    uint64_t value;
+
+    return (size_t) varint_read(VARINTS[n % 4], sizeof(VARINTS[0]), &value) + (size_t) value;
+}
+
+static size_t op_apdu_parser(size_t n) {
+    // SIGN_TX chunk: header, Lc and the start of a transaction
+    const corpus_tx_t *tx = &CORPUS[n % CORPUS_COUNT];
+    uint8_t apdu[5 + 255] = {0x80, 0x02, 0x02, 0x80, 0xff};
+    command_t cmd;
+
+    memcpy(apdu + 5, tx->data, tx->len < 255 ? tx->len : 255);
+    return apdu_parser(&cmd, apdu, sizeof(apdu)) + cmd.lc;
+}
+
+int main(int argc, char *argv[]) {
+    long iterations = (argc > 1) ? atol(argv[1]) : 200000;
+
+    for (size_t i = 0; i < CORPUS_COUNT; i++) {
+        buffer_t buf = {.ptr = CORPUS[i].data, .size = CORPUS[i].len, .offset = 0};
+        if (transaction_deserialize(&buf, &parsed[i], parsed_store[i], sizeof(parsed_store[i])) != PARSING_OK) {
+            fprintf(stderr, "corpus transaction '%s' doesn't parse\n", CORPUS[i].name);
+            return 1;
+        }
+    }
+
+    printf("%zu transactions, %ld iterations\n", CORPUS_COUNT, iterations);
+    bench("transaction_deserialize", op_transaction_deserialize, iterations);
+    bench("transaction_parser_feed (hashed)", op_transaction_parser_feed, iterations);
+    bench("try_parse_script", op_try_parse_script, iterations);
+    bench("base58_encode", op_base58_encode, iterations);
+    bench("base58_encode_address", op_base58_encode_address, iterations);
+    bench("script_hash_to_address", op_script_hash_to_address, iterations);
+    bench("format_fpu64 + ticker", op_format_fpu64, iterations);
+    bench("format_amount", op_format_amount, iterations);
+    bench("format_hex (account)", op_format_hex_account, iterations);
+    bench("format_hex (public key)", op_format_hex_key, iterations);
+    bench("varint_read", op_varint_read, iterations);
+    bench("apdu_parser", op_apdu_parser, iterations);
+
+    return 0;
+}
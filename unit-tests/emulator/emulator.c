@@ -0,0 +1,286 @@
+#include <setjmp.h>  // jmp_buf, setjmp, longjmp
+#include <stdint.h>  // uint*_t
+#include <stdio.h>   // FILE, fputs
+#include <string.h>  // memcpy, memset, explicit_bzero
+#include <time.h>    // clock_gettime
+
+#include "os.h"
+#include "ux.h"
+
+#include "emulator_internal.h"
+#include "constants.h"
+#include "globals.h"
+#include "io.h"
+#include "offsets.h"
+#include "sw.h"
+#include "types.h"
+#include "apdu/dispatcher.h"
+#include "apdu/parser.h"
+#include "apdu/trace.h"
+#include "common/pubkey_cache.h"
+#include "common/write.h"
+
+/**
+ * Globals of the app, defined by main.c and the SDK on the device.
+ */
+uint8_t G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+uint8_t G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
+io_apdu_media_t G_io_apdu_media;
+io_state_e G_io_state;
+ux_state_t G_ux;
+bolos_ux_params_t G_ux_params;
+global_ctx_t G_context;
+cx_sha256_t G_tx_hash;
+cx_sha256_t G_script_hash;
+
+emu_stats_t emu_counters;
+
+_Static_assert(EMU_APDU_MAX_SIZE == IO_APDU_BUFFER_SIZE, "EMU_APDU_MAX_SIZE must be the size of the APDU buffer");
+
+static struct {
+    const uint8_t *command;  /// command io_exchange() hands to the app
+    size_t command_len;      /// length of 'command'
+    jmp_buf exception;       /// APDU loop, where the exceptions are thrown to
+    bool locked;             /// PIN not validated
+    FILE *trace;             /// where the exchanges are recorded, if any
+} emu;
+
+size_t emu_strlcpy(char *dst, const char *src, size_t size) {
+    size_t len = strlen(src);
+
+    if (size > 0) {
+        size_t copy_len = (len < size - 1) ? len : size - 1;
+        memcpy(dst, src, copy_len);
+        dst[copy_len] = '\0';
+    }
+    return len;
+}
+
+size_t emu_strlcat(char *dst, const char *src, size_t size) {
+    size_t len = strnlen(dst, size);
+
+    if (len == size) {
+        return len + strlen(src);
+    }
+    return len + emu_strlcpy(dst + len, src, size - len);
+}
+
+void emu_throw(uint16_t e) {
+    longjmp(emu.exception, e);
+}
+
+void halt(void) {
+    abort();
+}
+
+unsigned int os_global_pin_is_validated(void) {
+    return emu.locked ? 0 : BOLOS_UX_OK;
+}
+
+unsigned int io_seproxyhal_spi_is_status_sent(void) {
+    return 1;
+}
+
+void io_seproxyhal_general_status(void) {
+}
+
+void io_seproxyhal_spi_send(const uint8_t *buffer, uint16_t length) {
+    (void) buffer;
+    (void) length;
+}
+
+uint16_t io_seproxyhal_spi_recv(uint8_t *buffer, uint16_t max_length, unsigned int flags) {
+    (void) buffer;
+    (void) max_length;
+    (void) flags;
+    return 0;
+}
+
+/**
+ * The SDK exchange, without the MCU: the response of the previous command is left in G_io_apdu_buffer for
+ * emu_exchange(), which then gives the app its next command.
+ */
+unsigned short io_exchange(unsigned char channel_and_flags, unsigned short tx_len) {
+    (void) tx_len;
+
+    if (channel_and_flags & IO_RETURN_AFTER_TX) {
+        return 0;
+    }
+    if ((channel_and_flags & IO_ASYNCH_REPLY) || emu.command == NULL) {
+        // nothing else to do for a device waiting for its user, like a reset of the link
+        THROW(EXCEPTION_IO_RESET);
+    }
+
+    memcpy(G_io_apdu_buffer, emu.command, emu.command_len);
+    emu.command = NULL;
+    return (unsigned short) emu.command_len;
+}
+
+/**
+ * The recorder of apdu/trace.c, writing to 'emu.trace'.
+ */
+void apdu_trace_write(const char *text) {
+    fputs(text, emu.trace);
+}
+
+uint64_t apdu_trace_time_us(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000 + (uint64_t) now.tv_nsec / 1000;
+}
+
+bool apdu_trace_enabled(void) {
+    return emu.trace != NULL;
+}
+
+/**
+ * The start of app_main().
+ */
+static void app_start(void) {
+    G_output_len = 0;
+    G_io_state = READY;
+    explicit_bzero(&G_context, sizeof(G_context));
+    pubkey_cache_flush();
+}
+
+void emu_reset(void) {
+    memset(&emu_counters, 0, sizeof(emu_counters));
+    emu.locked = false;
+    G_io_apdu_media = IO_APDU_MEDIA_USB_HID;
+    emu_ui_reset();
+    app_start();
+}
+
+void emu_set_trace(FILE *trace) {
+    emu.trace = trace;
+}
+
+void emu_set_locked(bool locked) {
+    emu.locked = locked;
+}
+
+void emu_ticker(void) {
+    G_io_seproxyhal_spi_buffer[0] = SEPROXYHAL_TAG_TICKER_EVENT;
+    G_io_seproxyhal_spi_buffer[1] = 0;
+    G_io_seproxyhal_spi_buffer[2] = 0;
+    io_event(CHANNEL_SPI);
+}
+
+/**
+ * One iteration of the loop of app_main(), on command 'emu.command'.
+ *
+ * @return true if the app is still running, false if it returned from app_main().
+ */
+static bool app_step(void) {
+    volatile bool running = true;
+    command_t cmd;
+    int input_len;
+    int e;
+
+    if ((e = setjmp(emu.exception)) == 0) {
+        memset(&cmd, 0, sizeof(cmd));
+        if ((input_len = io_recv_command()) < 0) {
+            return false;
+        }
+        if (!apdu_parser(&cmd, G_io_apdu_buffer, input_len)) {
+            io_send_sw(SW_WRONG_DATA_LENGTH);
+        } else if (apdu_dispatcher(&cmd) < 0) {
+            running = false;
+        }
+    } else if (e == EXCEPTION_IO_RESET) {
+        // main() starts the app over
+        app_start();
+    } else {
+        io_send_sw(e);
+    }
+    return running;
+}
+
+int emu_exchange(const uint8_t *apdu, size_t apdu_len, uint8_t *rapdu, size_t rapdu_size) {
+    if (apdu_len > sizeof(G_io_apdu_buffer)) {
+        return -1;
+    }
+
+    emu_counters.exchanges++;
+    emu.command = apdu;
+    emu.command_len = apdu_len;
+    bool running = app_step();
+    emu.command = NULL;
+
+    if (!running) {
+        app_start();
+        return -1;
+    }
+    // the handler responded, directly or from the review, io_recv_command() sends it along the next command
+    if (G_io_state != READY || G_output_len > rapdu_size) {
+        G_io_state = READY;
+        G_output_len = 0;
+        return -1;
+    }
+    memcpy(rapdu, G_io_apdu_buffer, G_output_len);
+    return (int) G_output_len;
+}
+
+int emu_sign_tx(const uint32_t bip44_path[static 5],
+                uint32_t magic,
+                const uint8_t *tx,
+                size_t tx_len,
+                uint8_t sig_flags,
+                uint8_t *rapdu,
+                size_t rapdu_size) {
+    uint8_t apdu[IO_APDU_BUFFER_SIZE] = {CLA, SIGN_TX, P1_START};
+    size_t offset = OFFSET_CDATA;
+    size_t sent = 0;
+    int rapdu_len;
+
+    for (size_t i = 0; i < 5; i++) {
+        write_u32_be(apdu, offset, bip44_path[i]);
+        offset += 4;
+    }
+    write_u32_le(apdu, offset, magic);
+    offset += 4;
+
+    do {
+        size_t chunk_len = sizeof(apdu) - offset;
+        if (chunk_len > tx_len - sent) {
+            chunk_len = tx_len - sent;
+        }
+        memcpy(apdu + offset, tx + sent, chunk_len);
+        sent += chunk_len;
+        if (apdu[OFFSET_P1] == P1_START) {
+            apdu[OFFSET_P2] = P2_OPEN_SESSION | sig_flags;
+        } else {
+            apdu[OFFSET_P2] = P2_LAST;
+        }
+        if (sent < tx_len) {
+            apdu[OFFSET_P2] |= P2_MORE;
+        }
+        apdu[OFFSET_LC] = (uint8_t) (offset + chunk_len - OFFSET_CDATA);
+
+        rapdu_len = emu_exchange(apdu, offset + chunk_len, rapdu, rapdu_size);
+        if (rapdu_len < 0 || emu_sw(rapdu, rapdu_len) != SW_OK) {
+            return rapdu_len;
+        }
+        // the following chunks are numbered from 2 on, as after the path (0) and the magic (1), up to 0xFF
+        if (apdu[OFFSET_P1] == P1_START) {
+            apdu[OFFSET_P1] = 2;
+        } else if (apdu[OFFSET_P1] < 0xFF) {
+            apdu[OFFSET_P1]++;
+        }
+        offset = OFFSET_CDATA;
+    } while (sent < tx_len);
+
+    return rapdu_len;
+}
+
+uint16_t emu_sw(const uint8_t *rapdu, int rapdu_len) {
+    if (rapdu_len < 2) {
+        return 0;
+    }
+    return (uint16_t) (rapdu[rapdu_len - 2] << 8 | rapdu[rapdu_len - 1]);
+}
+
+const emu_stats_t *emu_stats(void) {
+    return &emu_counters;
+}
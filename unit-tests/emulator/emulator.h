@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * In-process emulator of the app, to exchange APDUs with it from the host.
+ *
+ * The APDU loop of app_main(), the dispatcher, the handlers and io.c are the sources of the app, built against the
+ * host stand-ins of the SDK in sdk/:
+ *   - io_exchange() hands the command given to emu_exchange() to io_recv_command() (emulator.c),
+ *   - the crypto is OpenSSL, the keys are derived from the seed of the default Speculos mnemonic, so they are the
+ *     keys of the functional tests, and the signatures are deterministic (RFC 6979) (emulator_hash.c, and
+ *     emulator_crypto.c for the keys, which fuzzing/fuzz_apdu_crypto.c replaces with fast stand-ins),
+ *   - there is no screen: each review goes through all its items, formatted as for the display, and is then
+ *     approved, or rejected, right away (emulator_ui.c),
+ *   - io.c is built with HAVE_APDU_TRACE, so the exchanges can be recorded as on the device (emu_set_trace()).
+ *
+ * The emulator is a single app instance in the globals of the app, it is not thread safe.
+ */
+
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdio.h>    // FILE
+
+/**
+ * Size of the APDU buffer of the app, the maximum length of a command and of a response.
+ */
+#define EMU_APDU_MAX_SIZE (5 + 255)
+
+/**
+ * Counters since the last emu_reset().
+ */
+typedef struct {
+    size_t exchanges;     /// APDUs exchanged
+    size_t reviews;       /// reviews displayed, address, transaction or batch
+    size_t review_items;  /// items formatted for the reviews
+    size_t review_errors; /// items that could not be formatted
+    size_t approvals;     /// reviews approved
+    size_t rejections;    /// reviews rejected, by the user or by the app (arbitrary scripts not allowed)
+} emu_stats_t;
+
+/**
+ * Callback of each item of a review, as it would be displayed.
+ */
+typedef void (*emu_review_cb_t)(const char *title, const char *text, void *ctx);
+
+/**
+ * Start the app, as after it was launched: empty context and cache, default settings, reviews approved.
+ */
+void emu_reset(void);
+
+/**
+ * Change the settings of the app, as from its settings menu.
+ */
+void emu_set_settings(bool scripts_allowed, bool show_script_hash);
+
+/**
+ * Approve (default) or reject the reviews that follow.
+ */
+void emu_set_approval(bool approve);
+
+/**
+ * Get each item of the reviews that follow, or none if 'cb' is NULL.
+ */
+void emu_set_review_callback(emu_review_cb_t cb, void *ctx);
+
+/**
+ * Lock the device, or unlock it: the app sees the PIN as not validated from the next ticker event on.
+ */
+void emu_set_locked(bool locked);
+
+/**
+ * Record the exchanges that follow to 'trace', in the format of doc/APDU_TRACE.md, or stop recording if 'trace' is
+ * NULL. The times are those of the host, from the first exchange recorded.
+ */
+void emu_set_trace(FILE *trace);
+
+/**
+ * Send a ticker event to the app, as the MCU does every 100ms.
+ */
+void emu_ticker(void);
+
+/**
+ * Send APDU 'apdu' to the app and get its response.
+ *
+ * @param[in]  apdu        Command, CLA || INS || P1 || P2 || Lc || CData.
+ * @param[in]  apdu_len    Length of 'apdu'.
+ * @param[out] rapdu       Response, RData || SW.
+ * @param[in]  rapdu_size  Size of 'rapdu'.
+ *
+ * @return length of the response, or -1 if 'apdu' is too long for the APDU buffer, the response doesn't fit in
+ * 'rapdu' or the app didn't respond (it exited, was reset or still waits for something).
+ */
+int emu_exchange(const uint8_t *apdu, size_t apdu_len, uint8_t *rapdu, size_t rapdu_size);
+
+/**
+ * Sign transaction 'tx' in a SIGN_TX session opened by its first APDU (P2_OPEN_SESSION), as the client of the
+ * functional tests does: BIP44 path, network magic and the first transaction bytes, then the remaining bytes in
+ * APDUs of 255 bytes.
+ *
+ * @param[in]  bip44_path  BIP44 path of the key, of 5 levels.
+ * @param[in]  magic       Network magic.
+ * @param[in]  tx          Signed part of the transaction.
+ * @param[in]  tx_len      Length of 'tx'.
+ * @param[in]  sig_flags   Signature encoding flags of P2 (P2_SIG_RS or P2_SIG_INVOCATION), 0 for DER.
+ * @param[out] rapdu       Response of the last APDU exchanged.
+ * @param[in]  rapdu_size  Size of 'rapdu'.
+ *
+ * @return length of the response of the last APDU exchanged, which is the first one with a status word other than
+ * 0x9000 or the response to the last transaction bytes, or -1 as emu_exchange().
+ */
+int emu_sign_tx(const uint32_t bip44_path[static 5],
+                uint32_t magic,
+                const uint8_t *tx,
+                size_t tx_len,
+                uint8_t sig_flags,
+                uint8_t *rapdu,
+                size_t rapdu_size);
+
+/**
+ * Status word of response 'rapdu' of length 'rapdu_len', 0 if it is too short to have one.
+ */
+uint16_t emu_sw(const uint8_t *rapdu, int rapdu_len);
+
+/**
+ * Counters since the last emu_reset().
+ */
+const emu_stats_t *emu_stats(void);
@@ -0,0 +1,397 @@
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <string.h>   // memcmp, memcpy, memset
+
+#include "cx.h"
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/obj_mac.h>
+
+/**
+ * Mnemonic of the seed of Speculos, when it isn't given one, so the keys are those of the functional tests.
+ */
+#define SPECULOS_MNEMONIC                                                                                        \
+    "glory promote mansion idle axis finger extra february uncover one trip resource lawn turtle enact monster " \
+    "seven myth punch hobby comfort wild raise skin"
+
+#define SEED_LEN      64
+#define MAX_PATH_LEN  10
+#define HARDENED_FLAG 0x80000000u
+
+/**
+ * Extended private key, node of the derivation tree.
+ */
+typedef struct {
+    uint8_t key[32];
+    uint8_t chain_code[32];
+} node_t;
+
+static struct {
+    EC_GROUP *group;  /// secp256r1
+    BN_CTX *bn_ctx;
+    bool has_master;
+    node_t master;  /// master node of the seed
+    // last derivation: the app derives the same path over and over, for each signature
+    bool has_last;
+    uint32_t last_path[MAX_PATH_LEN];
+    size_t last_path_len;
+    node_t last_node;
+} crypto;
+
+static bool crypto_init(void) {
+    if (crypto.group == NULL) {
+        crypto.group = EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1);
+        crypto.bn_ctx = BN_CTX_new();
+    }
+    return crypto.group != NULL && crypto.bn_ctx != NULL;
+}
+
+/**
+ * Public key of private key 'd', uncompressed (65 bytes) or compressed (33 bytes) according to 'out_len'.
+ */
+static bool public_key(const uint8_t d[static 32], uint8_t *out, size_t out_len) {
+    point_conversion_form_t form = (out_len == 33) ? POINT_CONVERSION_COMPRESSED : POINT_CONVERSION_UNCOMPRESSED;
+    BIGNUM *k = BN_bin2bn(d, 32, NULL);
+    EC_POINT *point = EC_POINT_new(crypto.group);
+    bool ok = k != NULL && point != NULL && !BN_is_zero(k) &&
+              EC_POINT_mul(crypto.group, point, k, NULL, NULL, crypto.bn_ctx) == 1 &&
+              EC_POINT_point2oct(crypto.group, point, form, out, out_len, crypto.bn_ctx) == out_len;
+
+    EC_POINT_free(point);
+    BN_clear_free(k);
+    return ok;
+}
+
+cx_err_t cx_ecfp_init_private_key_no_throw(cx_curve_t curve,
+                                           const uint8_t *raw_key,
+                                           size_t key_len,
+                                           cx_ecfp_private_key_t *pvkey) {
+    if (curve != CX_CURVE_256R1 || key_len != sizeof(pvkey->d)) {
+        return CX_INVALID_PARAMETER;
+    }
+    pvkey->curve = curve;
+    pvkey->d_len = key_len;
+    memcpy(pvkey->d, raw_key, key_len);
+    return CX_OK;
+}
+
+cx_err_t cx_ecfp_generate_pair_no_throw(cx_curve_t curve,
+                                        cx_ecfp_public_key_t *pubkey,
+                                        cx_ecfp_private_key_t *privkey,
+                                        bool keep_private) {
+    // the app always derives its keys, a new private key is never generated
+    if (curve != CX_CURVE_256R1 || !keep_private || privkey->d_len != sizeof(privkey->d) || !crypto_init() ||
+        !public_key(privkey->d, pubkey->W, sizeof(pubkey->W))) {
+        return CX_INVALID_PARAMETER;
+    }
+    pubkey->curve = curve;
+    pubkey->W_len = sizeof(pubkey->W);
+    return CX_OK;
+}
+
+/**
+ * HMAC-SHA256 of the concatenation of 'v' (32 bytes), 'sep' (if not negative), 'x' and 'h' (32 bytes, if not NULL)
+ * with key 'k', into 'out'.
+ */
+static void rfc6979_hmac(const uint8_t k[static 32],
+                         const uint8_t v[static 32],
+                         int sep,
+                         const uint8_t *x,
+                         const uint8_t *h,
+                         uint8_t out[static 32]) {
+    uint8_t data[32 + 1 + 32 + 32];
+    size_t len = 0;
+    unsigned int out_len = 32;
+
+    memcpy(data, v, 32);
+    len += 32;
+    if (sep >= 0) {
+        data[len++] = (uint8_t) sep;
+    }
+    if (x != NULL) {
+        memcpy(data + len, x, 32);
+        len += 32;
+        memcpy(data + len, h, 32);
+        len += 32;
+    }
+    HMAC(EVP_sha256(), k, 32, data, len, out, &out_len);
+}
+
+/**
+ * Nonce of the signature of hash 'hash' by private key 'x', as of RFC 6979 (section 3.2) with HMAC-SHA256, which is
+ * what the device does for CX_RND_RFC6979.
+ */
+static BIGNUM *rfc6979_nonce(const uint8_t x[static 32], const uint8_t hash[static 32], const BIGNUM *n) {
+    uint8_t h[32];
+    uint8_t v[32];
+    uint8_t k[32];
+    BIGNUM *nonce = BN_bin2bn(hash, 32, NULL);
+
+    // bits2octets(hash): the hash modulo the order, the order is 256 bits too
+    if (nonce == NULL || (BN_cmp(nonce, n) >= 0 && BN_sub(nonce, nonce, n) != 1) || BN_bn2binpad(nonce, h, 32) != 32) {
+        BN_free(nonce);
+        return NULL;
+    }
+
+    memset(v, 0x01, sizeof(v));
+    memset(k, 0x00, sizeof(k));
+    rfc6979_hmac(k, v, 0x00, x, h, k);
+    rfc6979_hmac(k, v, -1, NULL, NULL, v);
+    rfc6979_hmac(k, v, 0x01, x, h, k);
+    rfc6979_hmac(k, v, -1, NULL, NULL, v);
+    for (;;) {
+        rfc6979_hmac(k, v, -1, NULL, NULL, v);
+        if (BN_bin2bn(v, 32, nonce) == NULL) {
+            BN_free(nonce);
+            return NULL;
+        }
+        if (!BN_is_zero(nonce) && BN_cmp(nonce, n) < 0) {
+            return nonce;
+        }
+        rfc6979_hmac(k, v, 0x00, NULL, NULL, k);
+        rfc6979_hmac(k, v, -1, NULL, NULL, v);
+    }
+}
+
+cx_err_t cx_ecdsa_sign_no_throw(const cx_ecfp_private_key_t *pvkey,
+                                uint32_t mode,
+                                cx_md_t hashID,
+                                const uint8_t *hash,
+                                size_t hash_len,
+                                uint8_t *sig,
+                                size_t *sig_len,
+                                uint32_t *info) {
+    (void) hashID;
+
+    // only the deterministic signature of a SHA-256 hash is supported, as the app signs
+    if ((mode & CX_RND_RFC6979) != CX_RND_RFC6979 || pvkey->curve != CX_CURVE_256R1 ||
+        pvkey->d_len != sizeof(pvkey->d) || hash_len != 32 || !crypto_init()) {
+        return CX_INVALID_PARAMETER;
+    }
+
+    cx_err_t error = CX_INTERNAL_ERROR;
+    const BIGNUM *n = EC_GROUP_get0_order(crypto.group);
+    BIGNUM *d = BN_bin2bn(pvkey->d, 32, NULL);
+    BIGNUM *k = rfc6979_nonce(pvkey->d, hash, n);
+    BIGNUM *kinv = BN_new();
+    BIGNUM *r = BN_new();
+    BIGNUM *y = BN_new();
+    EC_POINT *point = EC_POINT_new(crypto.group);
+    EC_KEY *key = EC_KEY_new();
+    ECDSA_SIG *signature = NULL;
+
+    // the nonce is computed here, OpenSSL only signs with it: r is the x-coordinate of k.G modulo the order
+    if (d == NULL || k == NULL || kinv == NULL || r == NULL || y == NULL || point == NULL || key == NULL ||
+        EC_KEY_set_group(key, crypto.group) != 1 || EC_KEY_set_private_key(key, d) != 1 ||
+        EC_POINT_mul(crypto.group, point, k, NULL, NULL, crypto.bn_ctx) != 1 ||
+        EC_POINT_get_affine_coordinates(crypto.group, point, r, y, crypto.bn_ctx) != 1 ||
+        BN_mod_inverse(kinv, k, n, crypto.bn_ctx) == NULL) {
+        goto end;
+    }
+    if (info != NULL) {
+        *info = BN_is_odd(y) ? 1 : 0;  // CX_ECCINFO_PARITY_ODD
+        if (BN_cmp(r, n) >= 0) {
+            *info |= 2;  // CX_ECCINFO_xGTn
+        }
+    }
+    if (BN_nnmod(r, r, n, crypto.bn_ctx) != 1 ||
+        (signature = ECDSA_do_sign_ex(hash, (int) hash_len, kinv, r, key)) == NULL) {
+        goto end;
+    }
+
+    int der_len = i2d_ECDSA_SIG(signature, NULL);
+    if (der_len <= 0 || (size_t) der_len > *sig_len) {
+        error = CX_INVALID_PARAMETER;
+        goto end;
+    }
+    i2d_ECDSA_SIG(signature, &sig);
+    *sig_len = (size_t) der_len;
+    error = CX_OK;
+
+end:
+    ECDSA_SIG_free(signature);
+    EC_KEY_free(key);
+    EC_POINT_free(point);
+    BN_free(y);
+    BN_free(r);
+    BN_clear_free(kinv);
+    BN_clear_free(k);
+    BN_clear_free(d);
+    return error;
+}
+
+/**
+ * Read DER integer 'value' at 'offset' of 'sig', at most 'max_size' bytes long.
+ */
+static bool decode_der_integer(const uint8_t *sig,
+                               size_t sig_len,
+                               size_t *offset,
+                               size_t max_size,
+                               const uint8_t **value,
+                               size_t *value_len) {
+    if (*offset + 2 > sig_len || sig[*offset] != 0x02) {
+        return false;
+    }
+    size_t len = sig[*offset + 1];
+    *offset += 2;
+    if (len == 0 || len > max_size || *offset + len > sig_len) {
+        return false;
+    }
+    *value = sig + *offset;
+    *value_len = len;
+    *offset += len;
+    return true;
+}
+
+int cx_ecfp_decode_sig_der(const uint8_t *sig,
+                           size_t sig_len,
+                           size_t max_size,
+                           const uint8_t **r,
+                           size_t *r_len,
+                           const uint8_t **s,
+                           size_t *s_len) {
+    size_t offset = 2;
+
+    if (sig_len < 2 || sig[0] != 0x30 || sig[1] != sig_len - 2 ||
+        !decode_der_integer(sig, sig_len, &offset, max_size, r, r_len) ||
+        !decode_der_integer(sig, sig_len, &offset, max_size, s, s_len) || offset != sig_len) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * 'node' as 'key' + 'tweak' modulo the order, for a tweak and a result of the curve (SLIP-10).
+ *
+ * @return true if success, false if another tweak must be tried.
+ */
+static bool node_add_tweak(node_t *node, const uint8_t key[static 32], const uint8_t tweak[static 32]) {
+    const BIGNUM *n = EC_GROUP_get0_order(crypto.group);
+    BIGNUM *a = BN_bin2bn(tweak, 32, NULL);
+    BIGNUM *b = BN_bin2bn(key, 32, NULL);
+    bool ok = a != NULL && b != NULL && BN_cmp(a, n) < 0 && BN_mod_add(a, a, b, n, crypto.bn_ctx) == 1 &&
+              !BN_is_zero(a) && BN_bn2binpad(a, node->key, 32) == 32;
+
+    BN_clear_free(a);
+    BN_clear_free(b);
+    return ok;
+}
+
+static void hmac_sha512(const uint8_t *key, size_t key_len, const uint8_t *data, size_t len, uint8_t out[static 64]) {
+    unsigned int out_len = 64;
+
+    HMAC(EVP_sha512(), key, (int) key_len, data, len, out, &out_len);
+}
+
+/**
+ * Master node of 'seed' for secp256r1 (SLIP-10).
+ */
+static void node_master(const uint8_t *seed, size_t seed_len, node_t *node) {
+    static const uint8_t CURVE_KEY[] = "Nist256p1 seed";
+    static const uint8_t ZERO[32] = {0};
+    uint8_t i[64];
+
+    hmac_sha512(CURVE_KEY, sizeof(CURVE_KEY) - 1, seed, seed_len, i);
+    while (!node_add_tweak(node, ZERO, i)) {
+        hmac_sha512(CURVE_KEY, sizeof(CURVE_KEY) - 1, i, sizeof(i), i);
+    }
+    memcpy(node->chain_code, i + 32, 32);
+}
+
+/**
+ * Child 'index' of 'node', in place (SLIP-10).
+ */
+static bool node_child(node_t *node, uint32_t index) {
+    uint8_t data[1 + 32 + 4];
+    uint8_t i[64];
+    node_t parent = *node;
+
+    if (index & HARDENED_FLAG) {
+        data[0] = 0x00;
+        memcpy(data + 1, parent.key, 32);
+    } else if (!public_key(parent.key, data, 33)) {
+        return false;
+    }
+    data[33] = (uint8_t) (index >> 24);
+    data[34] = (uint8_t) (index >> 16);
+    data[35] = (uint8_t) (index >> 8);
+    data[36] = (uint8_t) index;
+
+    hmac_sha512(parent.chain_code, 32, data, sizeof(data), i);
+    while (!node_add_tweak(node, parent.key, i)) {
+        data[0] = 0x01;
+        memcpy(data + 1, i + 32, 32);
+        hmac_sha512(parent.chain_code, 32, data, sizeof(data), i);
+    }
+    memcpy(node->chain_code, i + 32, 32);
+    memset(&parent, 0, sizeof(parent));
+    return true;
+}
+
+cx_err_t os_derive_bip32_with_seed_no_throw(unsigned int derivation_mode,
+                                            cx_curve_t curve,
+                                            const uint32_t *path,
+                                            size_t path_len,
+                                            uint8_t raw_privkey[static 64],
+                                            uint8_t *chain_code,
+                                            unsigned char *seed,
+                                            size_t seed_len) {
+    (void) derivation_mode;
+
+    if (curve != CX_CURVE_256R1 || path_len > MAX_PATH_LEN || !crypto_init()) {
+        return CX_INVALID_PARAMETER;
+    }
+
+    node_t node;
+    if (seed != NULL) {
+        node_master(seed, seed_len, &node);
+    } else if (crypto.has_last && crypto.last_path_len == path_len && memcmp(crypto.last_path, path, path_len * sizeof(*path)) == 0) {
+        memcpy(raw_privkey, crypto.last_node.key, 32);
+        if (chain_code != NULL) {
+            memcpy(chain_code, crypto.last_node.chain_code, 32);
+        }
+        return CX_OK;
+    } else {
+        if (!crypto.has_master) {
+            uint8_t device_seed[SEED_LEN];
+            // BIP39 seed of the mnemonic, without passphrase
+            if (PKCS5_PBKDF2_HMAC(SPECULOS_MNEMONIC,
+                                  -1,
+                                  (const uint8_t *) "mnemonic",
+                                  8,
+                                  2048,
+                                  EVP_sha512(),
+                                  sizeof(device_seed),
+                                  device_seed) != 1) {
+                return CX_INTERNAL_ERROR;
+            }
+            node_master(device_seed, sizeof(device_seed), &crypto.master);
+            crypto.has_master = true;
+        }
+        node = crypto.master;
+    }
+
+    for (size_t i = 0; i < path_len; i++) {
+        if (!node_child(&node, path[i])) {
+            return CX_INTERNAL_ERROR;
+        }
+    }
+    if (seed == NULL) {
+        memcpy(crypto.last_path, path, path_len * sizeof(*path));
+        crypto.last_path_len = path_len;
+        crypto.last_node = node;
+        crypto.has_last = true;
+    }
+
+    memcpy(raw_privkey, node.key, 32);
+    if (chain_code != NULL) {
+        memcpy(chain_code, node.chain_code, 32);
+    }
+    memset(&node, 0, sizeof(node));
+    return CX_OK;
+}
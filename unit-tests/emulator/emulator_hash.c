@@ -0,0 +1,45 @@
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint*_t
+
+#include "cx.h"
+
+int cx_sha256_init(cx_sha256_t *hash) {
+    hash->header.algo = CX_SHA256;
+    SHA256_Init(&hash->ctx);
+    return CX_SHA256;
+}
+
+int cx_ripemd160_init(cx_ripemd160_t *hash) {
+    hash->header.algo = CX_RIPEMD160;
+    RIPEMD160_Init(&hash->ctx);
+    return CX_RIPEMD160;
+}
+
+cx_err_t cx_hash_no_throw(cx_hash_t *hash, uint32_t mode, const uint8_t *in, size_t len, uint8_t *out, size_t out_len) {
+    switch (hash->algo) {
+        case CX_SHA256: {
+            SHA256_CTX *ctx = &((cx_sha256_t *) hash)->ctx;
+            SHA256_Update(ctx, in, len);
+            if (mode & CX_LAST) {
+                if (out_len < SHA256_DIGEST_LENGTH) {
+                    return CX_INVALID_PARAMETER;
+                }
+                SHA256_Final(out, ctx);
+            }
+            return CX_OK;
+        }
+        case CX_RIPEMD160: {
+            RIPEMD160_CTX *ctx = &((cx_ripemd160_t *) hash)->ctx;
+            RIPEMD160_Update(ctx, in, len);
+            if (mode & CX_LAST) {
+                if (out_len < RIPEMD160_DIGEST_LENGTH) {
+                    return CX_INVALID_PARAMETER;
+                }
+                RIPEMD160_Final(out, ctx);
+            }
+            return CX_OK;
+        }
+        default:
+            return CX_INVALID_PARAMETER;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+/**
+ * Shared by the modules of the emulator, not part of its API.
+ */
+
+#include "emulator.h"
+
+extern emu_stats_t emu_counters;
+
+/**
+ * Back to the default settings and reviews approved, without review callback.
+ */
+void emu_ui_reset(void);
@@ -0,0 +1,147 @@
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <string.h>   // memset
+
+// N_storage_real is const for the app, written by nvm_write() on the device: define it writable here
+#define N_storage_real N_storage_real_const
+#include "shared_context.h"
+#undef N_storage_real
+
+#include "emulator_internal.h"
+#include "globals.h"
+#include "menu.h"
+#include "sign_tx_common.h"
+#include "ui_get_public_key.h"
+#include "action/validate.h"
+#include "ui/utils.h"
+
+internalStorage_t N_storage_real;
+settings_strings_t strings;
+
+static struct {
+    bool approve;           /// answer of the reviews
+    emu_review_cb_t cb;     /// callback of the review items, if any
+    void *cb_ctx;           /// context of 'cb'
+} ui;
+
+void emu_ui_reset(void) {
+    ui.approve = true;
+    ui.cb = NULL;
+    ui.cb_ctx = NULL;
+    emu_set_settings(false, false);
+}
+
+void emu_set_settings(bool scripts_allowed, bool show_script_hash) {
+    N_storage_real.scriptsAllowed = scripts_allowed;
+    N_storage_real.showScriptHash = show_script_hash;
+    N_storage_real.initialized = 1;
+}
+
+void emu_set_approval(bool approve) {
+    ui.approve = approve;
+}
+
+void emu_set_review_callback(emu_review_cb_t cb, void *ctx) {
+    ui.cb = cb;
+    ui.cb_ctx = ctx;
+}
+
+/**
+ * Display review item 'title' / 'text', formatted by 'formatted'.
+ */
+static void review_item(bool formatted, const char *title, const char *text) {
+    emu_counters.review_items++;
+    if (!formatted) {
+        emu_counters.review_errors++;
+        return;
+    }
+    if (ui.cb != NULL) {
+        ui.cb(title, text, ui.cb_ctx);
+    }
+}
+
+/**
+ * Fill 'text' with stale characters, as left in the slot of the previous item on the device, so an item formatted
+ * without its '\0' shows.
+ */
+static void stale_slot(char *text, size_t size) {
+    memset(text, '0', size - 1);
+    text[size - 1] = '\0';
+}
+
+/**
+ * Answer of the user at the end of a review.
+ */
+static bool review_end(void) {
+    emu_counters.reviews++;
+    if (ui.approve) {
+        emu_counters.approvals++;
+    } else {
+        emu_counters.rejections++;
+    }
+    return ui.approve;
+}
+
+void ui_menu_main(void) {
+}
+
+void ui_menu_settings(bool confirm) {
+    (void) confirm;
+}
+
+int ui_display_address(void) {
+    char address[ITEM_TEXT_MAX_SIZE];
+
+    stale_slot(address, sizeof(address));
+    review_item(address_from_pubkey(G_context.raw_public_key, address, sizeof(address)), "Address", address);
+    ui_action_validate_pubkey(review_end(), true);
+    return 0;
+}
+
+int start_sign_tx_ui(void) {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+    char title[ITEM_TEXT_MAX_SIZE];
+    char text[ITEM_TEXT_MAX_SIZE];
+
+    if (!tx->is_token_transfer && !tx->is_vote_script && !N_storage.scriptsAllowed) {
+        // no review, the app rejects the transaction
+        emu_counters.rejections++;
+        ui_action_validate_transaction(false, true);
+        return 0;
+    }
+
+    // every item either UI displays
+    for (uint16_t i = 0; i < get_transfer_items_count(); i++) {
+        stale_slot(text, sizeof(text));
+        review_item(format_transfer_item(i, title, sizeof(title), text, sizeof(text)), title, text);
+    }
+    for (tx_item_e item = TX_ITEM_VOTE_TO; item <= TX_ITEM_SCRIPT_HASH; item++) {
+        if ((item == TX_ITEM_VOTE_TO && (!tx->is_vote_script || tx->is_remove_vote)) ||
+            (item == TX_ITEM_SCRIPT_HASH && !N_storage.showScriptHash)) {
+            continue;
+        }
+        stale_slot(text, sizeof(text));
+        review_item(format_tx_item(item, title, sizeof(title), text, sizeof(text)), title, text);
+    }
+    for (uint16_t i = 0; i < get_signer_items_count(); i++) {
+        stale_slot(text, sizeof(text));
+        review_item(format_signer_item(i, title, sizeof(title), text, sizeof(text)), title, text);
+    }
+
+    ui_action_validate_transaction(review_end(), true);
+    return 0;
+}
+
+int start_sign_batch_ui(void) {
+    char title[ITEM_TEXT_MAX_SIZE];
+    char text[ITEM_TEXT_MAX_SIZE];
+
+    for (uint16_t i = 0; i < get_batch_items_count(); i++) {
+        stale_slot(text, sizeof(text));
+        review_item(format_batch_item(i, title, sizeof(title), text, sizeof(text)), title, text);
+    }
+
+    ui_action_validate_batch(review_end(), true);
+    return 0;
+}
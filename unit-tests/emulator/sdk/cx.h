@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * Host stand-in for the BOLOS SDK cx.h, backed by OpenSSL (see emulator_hash.c and emulator_crypto.c): real SHA-256,
+ * RIPEMD-160 and ECDSA over secp256r1, so the signatures returned by the emulator verify like those of a device.
+ */
+
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdlib.h>   // abort
+
+// the low level hash contexts are deprecated by OpenSSL 3, but are plain structs the app can keep in its globals
+#define OPENSSL_SUPPRESS_DEPRECATED
+#include <openssl/ripemd.h>
+#include <openssl/sha.h>
+
+#include "os.h"
+
+typedef uint32_t cx_err_t;
+
+#define CX_OK                0x00000000
+#define CX_INTERNAL_ERROR    0xFFFFFF85
+#define CX_INVALID_PARAMETER 0xFFFFFF88
+
+#define CX_LAST        (1 << 0)
+#define CX_RND_RFC6979 (3 << 9)
+
+#define CX_CHECK(call)        \
+    do {                      \
+        error = (call);       \
+        if (error != CX_OK) { \
+            goto end;         \
+        }                     \
+    } while (0)
+
+#define CX_ASSERT(call)        \
+    do {                       \
+        if ((call) != CX_OK) { \
+            abort();           \
+        }                      \
+    } while (0)
+
+typedef enum {
+    CX_NONE = 0,
+    CX_RIPEMD160 = 1,
+    CX_SHA256 = 3,
+} cx_md_t;
+
+typedef enum {
+    CX_CURVE_256R1 = 0x22,
+} cx_curve_t;
+
+typedef struct cx_hash_header_s {
+    cx_md_t algo;
+} cx_hash_t;
+
+struct cx_sha256_s {
+    cx_hash_t header;
+    SHA256_CTX ctx;
+};
+typedef struct cx_sha256_s cx_sha256_t;
+
+struct cx_ripemd160_s {
+    cx_hash_t header;
+    RIPEMD160_CTX ctx;
+};
+typedef struct cx_ripemd160_s cx_ripemd160_t;
+
+int cx_sha256_init(cx_sha256_t *hash);
+int cx_ripemd160_init(cx_ripemd160_t *hash);
+
+cx_err_t cx_hash_no_throw(cx_hash_t *hash, uint32_t mode, const uint8_t *in, size_t len, uint8_t *out, size_t out_len);
+
+typedef struct {
+    cx_curve_t curve;
+    size_t d_len;
+    uint8_t d[32];
+} cx_ecfp_256_private_key_t;
+typedef cx_ecfp_256_private_key_t cx_ecfp_private_key_t;
+
+typedef struct {
+    cx_curve_t curve;
+    size_t W_len;
+    uint8_t W[65];
+} cx_ecfp_256_public_key_t;
+typedef cx_ecfp_256_public_key_t cx_ecfp_public_key_t;
+
+cx_err_t cx_ecfp_init_private_key_no_throw(cx_curve_t curve,
+                                           const uint8_t *raw_key,
+                                           size_t key_len,
+                                           cx_ecfp_private_key_t *pvkey);
+
+cx_err_t cx_ecfp_generate_pair_no_throw(cx_curve_t curve,
+                                        cx_ecfp_public_key_t *pubkey,
+                                        cx_ecfp_private_key_t *privkey,
+                                        bool keep_private);
+
+cx_err_t cx_ecdsa_sign_no_throw(const cx_ecfp_private_key_t *pvkey,
+                                uint32_t mode,
+                                cx_md_t hashID,
+                                const uint8_t *hash,
+                                size_t hash_len,
+                                uint8_t *sig,
+                                size_t *sig_len,
+                                uint32_t *info);
+
+int cx_ecfp_decode_sig_der(const uint8_t *sig,
+                           size_t sig_len,
+                           size_t max_size,
+                           const uint8_t **r,
+                           size_t *r_len,
+                           const uint8_t **s,
+                           size_t *s_len);
+
+cx_err_t os_derive_bip32_with_seed_no_throw(unsigned int derivation_mode,
+                                            cx_curve_t curve,
+                                            const uint32_t *path,
+                                            size_t path_len,
+                                            uint8_t raw_privkey[static 64],
+                                            uint8_t *chain_code,
+                                            unsigned char *seed,
+                                            size_t seed_len);
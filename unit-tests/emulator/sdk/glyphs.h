@@ -0,0 +1,5 @@
+#pragma once
+
+/**
+ * Host stand-in for the glyphs.h generated by the SDK build, the emulator displays none.
+ */
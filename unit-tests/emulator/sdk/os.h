@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * Host stand-in for the BOLOS SDK os.h, with what the app sources compiled into the emulator use (see emulator.h).
+ */
+
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdio.h>    // snprintf
+#include <string.h>   // memset
+
+#define PRINTF(...)
+
+#define PIC(x) (x)
+
+#define explicit_bzero(p, n) memset((p), 0, (n))
+
+// not in every libc, the SDK provides its own
+#define strlcpy emu_strlcpy
+#define strlcat emu_strlcat
+size_t emu_strlcpy(char *dst, const char *src, size_t size);
+size_t emu_strlcat(char *dst, const char *src, size_t size);
+
+#define U4BE(buf, off)                                                                     \
+    (((uint32_t) (buf)[off] << 24) | ((uint32_t) (buf)[(off) + 1] << 16) |                 \
+     ((uint32_t) (buf)[(off) + 2] << 8) | (uint32_t) (buf)[(off) + 3])
+
+/**
+ * Exceptions, thrown back to the APDU loop of the emulator as they are to app_main() on the device.
+ */
+#define EXCEPTION          1
+#define INVALID_PARAMETER  2
+#define EXCEPTION_IO_RESET 16
+
+#define THROW(e) emu_throw(e)
+void emu_throw(uint16_t e) __attribute__((noreturn));
+
+void halt(void);
+
+#define BOLOS_UX_OK 0xAA
+
+unsigned int os_global_pin_is_validated(void);
+
+#define IO_APDU_BUFFER_SIZE (5 + 255)
+
+#ifndef IO_SEPROXYHAL_BUFFER_SIZE_B
+#define IO_SEPROXYHAL_BUFFER_SIZE_B 300
+#endif
+
+extern uint8_t G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+#define CHANNEL_APDU           0
+#define CHANNEL_KEYBOARD       1
+#define CHANNEL_SPI            2
+#define IO_RESET_AFTER_REPLIED 0x80
+#define IO_RETURN_AFTER_TX     0x20
+#define IO_ASYNCH_REPLY        0x10
+#define IO_FLAGS               0xF8
+
+unsigned short io_exchange(unsigned char channel_and_flags, unsigned short tx_len);
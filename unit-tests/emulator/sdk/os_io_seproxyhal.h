@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * Host stand-in for the BOLOS SDK os_io_seproxyhal.h: the events io_event() handles and the SPI link to the MCU,
+ * which the emulator never goes through.
+ */
+
+#include "os.h"
+
+#define SEPROXYHAL_TAG_BUTTON_PUSH_EVENT       0x05
+#define SEPROXYHAL_TAG_FINGER_EVENT            0x0C
+#define SEPROXYHAL_TAG_DISPLAY_PROCESSED_EVENT 0x0D
+#define SEPROXYHAL_TAG_TICKER_EVENT            0x0E
+#define SEPROXYHAL_TAG_STATUS_EVENT            0x0F
+
+#define SEPROXYHAL_TAG_STATUS_EVENT_FLAG_USB_POWERED 0x00000008
+
+typedef enum {
+    IO_APDU_MEDIA_NONE = 0,
+    IO_APDU_MEDIA_USB_HID = 1,
+} io_apdu_media_t;
+
+extern io_apdu_media_t G_io_apdu_media;
+
+unsigned int io_seproxyhal_spi_is_status_sent(void);
+void io_seproxyhal_general_status(void);
+void io_seproxyhal_spi_send(const uint8_t *buffer, uint16_t length);
+uint16_t io_seproxyhal_spi_recv(uint8_t *buffer, uint16_t max_length, unsigned int flags);
@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * Host stand-in for the BOLOS SDK ux.h. The emulator has no screen: neither HAVE_BAGL nor HAVE_NBGL is defined and
+ * the review is done by emulator_ui.c.
+ */
+
+#include "os.h"
+
+typedef struct {
+    uint8_t unused;
+} ux_state_t;
+
+typedef struct {
+    uint8_t unused;
+} bolos_ux_params_t;
+
+#define UX_DEFAULT_EVENT()
+#define UX_TICKER_EVENT(seph_packet, callback)
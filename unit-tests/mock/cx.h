@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * Host stand-in for the BOLOS SDK cx.h, with just what the modules of the neo3core library use.
+ *
+ * The hashes are not SHA-256 nor RIPEMD-160 but a cheap deterministic mix of the input (see cx_mock.c): the
+ * library is meant to measure the parsing and formatting code, not the crypto, which the device does in hardware.
+ */
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint*_t
+#include <stdlib.h>  // abort
+
+#include "os.h"
+
+typedef uint32_t cx_err_t;
+
+#define CX_OK   0x00000000
+#define CX_LAST (1 << 0)
+
+#define CX_ASSERT(call)          \
+    do {                         \
+        if ((call) != CX_OK) {   \
+            abort();             \
+        }                        \
+    } while (0)
+
+typedef struct cx_hash_header_s {
+    uint64_t state;
+} cx_hash_t;
+
+struct cx_sha256_s {
+    cx_hash_t header;
+};
+typedef struct cx_sha256_s cx_sha256_t;
+
+struct cx_ripemd160_s {
+    cx_hash_t header;
+};
+typedef struct cx_ripemd160_s cx_ripemd160_t;
+
+cx_err_t cx_sha256_init_no_throw(cx_sha256_t *hash);
+cx_err_t cx_ripemd160_init_no_throw(cx_ripemd160_t *hash);
+
+static inline int cx_sha256_init(cx_sha256_t *hash) {
+    CX_ASSERT(cx_sha256_init_no_throw(hash));
+    return 0;
+}
+
+static inline int cx_ripemd160_init(cx_ripemd160_t *hash) {
+    CX_ASSERT(cx_ripemd160_init_no_throw(hash));
+    return 0;
+}
+
+cx_err_t cx_hash_no_throw(cx_hash_t *hash, uint32_t mode, const uint8_t *in, size_t len, uint8_t *out, size_t out_len);
@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * Host stand-in for the BOLOS SDK os.h, with just what the modules of the neo3core library use.
+ */
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint*_t
+#include <string.h>  // memset
+
+#define PRINTF(...)
+
+#define PIC(x) (x)
+
+#define explicit_bzero(p, n) memset((p), 0, (n))
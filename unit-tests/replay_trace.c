@@ -0,0 +1,259 @@
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "emulator.h"
+#include "sw.h"
+
+/**
+ * Replay an APDU trace (doc/APDU_TRACE.md) against the app emulated on the host (see emulator/emulator.h).
+ *
+ *   replay_trace [-s] [-r N] [-o OUTPUT] TRACE
+ *
+ *   -s         allow arbitrary scripts in the settings of the app
+ *   -r N       replay the trace N times, in a single app instance
+ *   -o OUTPUT  record the exchanges of the replay to OUTPUT, with the times of the host
+ *
+ * Each command of the trace is sent to the app and its response compared to the one recorded. The reviews are
+ * approved, except for the commands recorded with SW_DENY, whose reviews are rejected. The trace is expected to start
+ * with the app, and its keys to be those of the default Speculos mnemonic, as in the functional tests.
+ *
+ * Exits with status 1 if a response differs from the trace, 2 if the trace can't be read.
+ */
+
+#define TRACE_MAX_LINE_LEN 4096
+
+typedef struct {
+    uint8_t command[EMU_APDU_MAX_SIZE];
+    size_t command_len;
+    uint8_t response[EMU_APDU_MAX_SIZE];  /// RData || SW
+    size_t response_len;
+    uint64_t duration_us;  /// 0 if not recorded
+} exchange_t;
+
+/**
+ * Value of field 'name' in JSON object 'line', as is, without the quotes of a string.
+ *
+ * @return pointer to the value, of length '*value_len', or NULL if there is no such field.
+ */
+static const char *json_field(const char *line, const char *name, size_t *value_len) {
+    size_t name_len = strlen(name);
+
+    for (const char *p = strchr(line, '"'); p != NULL; p = strchr(p + 1, '"')) {
+        if (strncmp(p + 1, name, name_len) != 0 || p[1 + name_len] != '"') {
+            continue;
+        }
+        const char *value = p + name_len + 2;
+        while (isspace((unsigned char) *value)) {
+            value++;
+        }
+        if (*value++ != ':') {
+            continue;
+        }
+        while (isspace((unsigned char) *value)) {
+            value++;
+        }
+        if (*value == '"') {
+            const char *end = strchr(++value, '"');
+            if (end == NULL) {
+                return NULL;
+            }
+            *value_len = (size_t) (end - value);
+        } else {
+            *value_len = strcspn(value, ",} \t\r\n");
+        }
+        return value;
+    }
+    return NULL;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = (char) tolower((unsigned char) c);
+    return (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+}
+
+/**
+ * Decode hex string 'hex' of length 'hex_len' to 'out' of size 'out_size'.
+ *
+ * @return length of the bytes decoded, or -1 if 'hex' isn't hex or doesn't fit.
+ */
+static int hex_decode(const char *hex, size_t hex_len, uint8_t *out, size_t out_size) {
+    if (hex_len % 2 != 0 || hex_len / 2 > out_size) {
+        return -1;
+    }
+    for (size_t i = 0; i < hex_len / 2; i++) {
+        int high = hex_digit(hex[2 * i]);
+        int low = hex_digit(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return -1;
+        }
+        out[i] = (uint8_t) (high << 4 | low);
+    }
+    return (int) (hex_len / 2);
+}
+
+/**
+ * Parse exchange 'exchange' from trace line 'line'.
+ *
+ * @return false if the line isn't an exchange.
+ */
+static bool parse_exchange(const char *line, exchange_t *exchange) {
+    const char *value;
+    size_t value_len;
+    int len;
+
+    if ((value = json_field(line, "command", &value_len)) == NULL ||
+        (len = hex_decode(value, value_len, exchange->command, sizeof(exchange->command))) < 0) {
+        return false;
+    }
+    exchange->command_len = (size_t) len;
+
+    if ((value = json_field(line, "response", &value_len)) == NULL ||
+        (len = hex_decode(value, value_len, exchange->response, sizeof(exchange->response) - 2)) < 0) {
+        return false;
+    }
+    exchange->response_len = (size_t) len;
+
+    if ((value = json_field(line, "sw", &value_len)) == NULL ||
+        hex_decode(value, value_len, exchange->response + exchange->response_len, 2) != 2) {
+        return false;
+    }
+    exchange->response_len += 2;
+
+    value = json_field(line, "duration_us", &value_len);
+    exchange->duration_us = (value != NULL) ? strtoull(value, NULL, 10) : 0;
+    return true;
+}
+
+static void print_hex(const char *name, const uint8_t *data, size_t len) {
+    fprintf(stderr, "  %-8s ", name);
+    for (size_t i = 0; i < len; i++) {
+        fprintf(stderr, "%02x", data[i]);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[]) {
+    bool scripts_allowed = false;
+    long repeat = 1;
+    const char *output_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "sr:o:")) != -1) {
+        switch (opt) {
+            case 's':
+                scripts_allowed = true;
+                break;
+            case 'r':
+                repeat = atol(optarg);
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-s] [-r N] [-o OUTPUT] TRACE\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind != argc - 1 || repeat < 1) {
+        fprintf(stderr, "usage: %s [-s] [-r N] [-o OUTPUT] TRACE\n", argv[0]);
+        return 2;
+    }
+
+    FILE *input = fopen(argv[optind], "r");
+    if (input == NULL) {
+        perror(argv[optind]);
+        return 2;
+    }
+    size_t exchanges_size = 64;
+    size_t exchanges_count = 0;
+    exchange_t *exchanges = malloc(exchanges_size * sizeof(exchange_t));
+    char line[TRACE_MAX_LINE_LEN];
+    for (size_t line_number = 1; exchanges != NULL && fgets(line, sizeof(line), input) != NULL; line_number++) {
+        // anything else than an exchange, like the rest of the log of the device, is skipped
+        if (strstr(line, "\"command\"") == NULL) {
+            continue;
+        }
+        if (exchanges_count == exchanges_size) {
+            exchanges_size *= 2;
+            exchange_t *resized = realloc(exchanges, exchanges_size * sizeof(exchange_t));
+            if (resized == NULL) {
+                free(exchanges);
+            }
+            exchanges = resized;
+        }
+        if (exchanges != NULL && !parse_exchange(line, &exchanges[exchanges_count++])) {
+            fprintf(stderr, "%s:%zu: invalid exchange\n", argv[optind], line_number);
+            return 2;
+        }
+    }
+    fclose(input);
+    if (exchanges == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+
+    FILE *output = NULL;
+    if (output_path != NULL && (output = fopen(output_path, "w")) == NULL) {
+        perror(output_path);
+        return 2;
+    }
+
+    emu_reset();
+    emu_set_settings(scripts_allowed, false);
+    emu_set_trace(output);
+
+    size_t mismatches = 0;
+    uint64_t recorded_us = 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long n = 0; n < repeat; n++) {
+        for (size_t i = 0; i < exchanges_count; i++) {
+            const exchange_t *exchange = &exchanges[i];
+            uint8_t rapdu[EMU_APDU_MAX_SIZE];
+
+            emu_set_approval(emu_sw(exchange->response, (int) exchange->response_len) != SW_DENY);
+            int rapdu_len = emu_exchange(exchange->command, exchange->command_len, rapdu, sizeof(rapdu));
+            recorded_us += exchange->duration_us;
+
+            if (rapdu_len != (int) exchange->response_len ||
+                memcmp(rapdu, exchange->response, exchange->response_len) != 0) {
+                if (mismatches++ < 10) {
+                    fprintf(stderr, "exchange %zu: response differs\n", i + 1);
+                    print_hex("command", exchange->command, exchange->command_len);
+                    print_hex("expected", exchange->response, exchange->response_len);
+                    print_hex("actual", rapdu, rapdu_len > 0 ? (size_t) rapdu_len : 0);
+                }
+            }
+        }
+        // the output records a single replay
+        emu_set_trace(NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double host_us = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+
+    if (output != NULL) {
+        fclose(output);
+    }
+    free(exchanges);
+
+    size_t replayed = exchanges_count * (size_t) repeat;
+    printf("%zu exchanges replayed, %zu mismatches\n", replayed, mismatches);
+    if (replayed > 0) {
+        printf("%.1f us per exchange on the host", host_us / replayed);
+        if (recorded_us > 0) {
+            printf(", %.1f us as recorded", (double) recorded_us / replayed);
+        }
+        printf("\n");
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdlib.h>
 
 #include <cmocka.h>
 
@@ -27,8 +28,108 @@ static void test_base58(void **state) {
     assert_string_equal((char *) out2, expected_out2);
 }
 
+static void assert_encode_address_equal(const uint8_t *in) {
+    char expected[BASE58_ADDRESS_MAX_SIZE + 1] = {0};
+    char out[BASE58_ADDRESS_MAX_SIZE + 1] = {0};
+
+    int expected_len = base58_encode(in, BASE58_ADDRESS_INPUT_SIZE, expected, sizeof(expected));
+    assert_int_equal(base58_encode_address(in, out, sizeof(out)), expected_len);
+    assert_string_equal(out, expected);
+}
+
+static void test_base58_encode_address(void **state) {
+    (void) state;
+
+    // version 0x35 and script hash 0x1bc1c66f9ad71d1e58e2ae2ecc4cea0a45a88ec5, zero checksum
+    const uint8_t address[BASE58_ADDRESS_INPUT_SIZE] = {0x35, 0xc5, 0x8e, 0xa8, 0x45, 0x0a, 0xea, 0x4c, 0xcc,
+                                                        0x2e, 0xae, 0xe2, 0x58, 0x1e, 0x1d, 0xd7, 0x9a, 0x6f,
+                                                        0xc6, 0xc1, 0x1b, 0x00, 0x00, 0x00, 0x00};
+    uint8_t in[BASE58_ADDRESS_INPUT_SIZE];
+    char out[BASE58_ADDRESS_MAX_SIZE] = {0};
+
+    assert_encode_address_equal(address);
+
+    // leading zeros, all zeros and the largest value
+    memset(in, 0, sizeof(in));
+    assert_encode_address_equal(in);
+    in[3] = 0x01;
+    assert_encode_address_equal(in);
+    memset(in, 0xff, sizeof(in));
+    assert_encode_address_equal(in);
+
+    srand(58);
+    for (int n = 0; n < 10000; n++) {
+        for (size_t i = 0; i < sizeof(in); i++) {
+            in[i] = rand() & 0xff;
+        }
+        assert_encode_address_equal(in);
+    }
+
+    // output too small
+    assert_int_equal(base58_encode_address(address, out, 33), -1);
+}
+
+static void test_base58_decode_address(void **state) {
+    (void) state;
+
+    const char address[] = "NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf";
+    uint8_t expected[BASE58_ADDRESS_INPUT_SIZE];
+    uint8_t in[BASE58_ADDRESS_INPUT_SIZE];
+    uint8_t out[BASE58_ADDRESS_INPUT_SIZE];
+    char encoded[BASE58_ADDRESS_MAX_SIZE];
+    char invalid[BASE58_ADDRESS_LEN];
+
+    assert_int_equal(base58_decode(address, sizeof(address) - 1, expected, sizeof(expected)), sizeof(expected));
+    assert_int_equal(base58_decode_address(address, sizeof(address) - 1, out), sizeof(out));
+    assert_memory_equal(out, expected, sizeof(out));
+    assert_int_equal(out[0], 0x35);
+
+    srand(58);
+    for (int n = 0; n < 10000; n++) {
+        in[0] = 0x35;
+        for (size_t i = 1; i < sizeof(in); i++) {
+            in[i] = rand() & 0xff;
+        }
+        assert_int_equal(base58_encode_address(in, encoded, sizeof(encoded)), BASE58_ADDRESS_LEN);
+        assert_int_equal(base58_decode_address(encoded, BASE58_ADDRESS_LEN, out), sizeof(out));
+        assert_memory_equal(out, in, sizeof(out));
+    }
+
+    // wrong length
+    assert_int_equal(base58_decode_address(address, sizeof(address) - 2, out), -1);
+    assert_int_equal(base58_decode_address(address, sizeof(address), out), -1);
+
+    // characters out of the alphabet
+    const char bad_chars[] = {'0', 'O', 'I', 'l', '+', (char) 0x80};
+    for (size_t i = 0; i < sizeof(bad_chars); i++) {
+        memcpy(invalid, address, sizeof(invalid));
+        invalid[10] = bad_chars[i];
+        assert_int_equal(base58_decode_address(invalid, sizeof(invalid), out), -1);
+    }
+
+    // leading '1' not matching a leading zero byte
+    memset(invalid, 'z', sizeof(invalid));
+    invalid[0] = '1';
+    assert_int_equal(base58_decode_address(invalid, sizeof(invalid), out), -1);
+    // while matching leading zero bytes, they are decoded as base58_decode() does
+    memset(invalid, '2', sizeof(invalid));
+    invalid[0] = '1';
+    invalid[1] = '1';
+    assert_int_equal(base58_decode_address(invalid, sizeof(invalid), out), sizeof(out));
+    assert_int_equal(base58_decode(invalid, sizeof(invalid), expected, sizeof(expected)), sizeof(expected));
+    assert_memory_equal(out, expected, sizeof(out));
+
+    // the largest value still fits
+    memset(invalid, 'z', sizeof(invalid));
+    assert_int_equal(base58_decode_address(invalid, sizeof(invalid), out), sizeof(out));
+    assert_int_equal(base58_decode(invalid, sizeof(invalid), expected, sizeof(expected)), sizeof(expected));
+    assert_memory_equal(out, expected, sizeof(out));
+}
+
 int main() {
-    const struct CMUnitTest tests[] = {cmocka_unit_test(test_base58)};
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_base58),
+                                       cmocka_unit_test(test_base58_encode_address),
+                                       cmocka_unit_test(test_base58_decode_address)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
\ No newline at end of file
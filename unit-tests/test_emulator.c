@@ -0,0 +1,528 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#define OPENSSL_SUPPRESS_DEPRECATED
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/obj_mac.h>
+#include <openssl/sha.h>
+
+#include "emulator.h"
+#include "cx.h"
+#include "constants.h"
+#include "sw.h"
+#include "types.h"
+#include "apdu/dispatcher.h"
+#include "common/base58.h"
+#include "ui/utils.h"
+
+#include "bench_corpus.h"
+
+#define MAINNET_MAGIC 860833102
+
+// m/44'/888'/0'/0/0
+static const uint32_t BIP44_PATH[BIP44_PATH_LEN] = {0x8000002c, 0x80000378, 0x80000000, 0, 0};
+
+static const uint8_t GET_PUBLIC_KEY_APDU[] = {CLA,  GET_PUBLIC_KEY, 0x00, 0x00, 0x14, 0x80, 0x00, 0x00,
+                                              0x2c, 0x80,           0x00, 0x03, 0x78, 0x80, 0x00, 0x00,
+                                              0x00, 0x00,           0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                              0x00};
+
+/**
+ * Public key of BIP44_PATH, uncompressed.
+ */
+static void get_public_key(uint8_t public_key[static 65]) {
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+
+    assert_int_equal(emu_exchange(GET_PUBLIC_KEY_APDU, sizeof(GET_PUBLIC_KEY_APDU), rapdu, sizeof(rapdu)), 65 + 2);
+    assert_int_equal(emu_sw(rapdu, 65 + 2), SW_OK);
+    memcpy(public_key, rapdu, 65);
+}
+
+/**
+ * Whether 'sig' is the signature of 'tx' on MainNet, by 'public_key'.
+ */
+static bool signature_verifies(const uint8_t public_key[static 65],
+                               const uint8_t *tx,
+                               size_t tx_len,
+                               const uint8_t *sig,
+                               size_t sig_len) {
+    uint8_t data[4 + SHA256_DIGEST_LENGTH] = {MAINNET_MAGIC & 0xff,
+                                              (MAINNET_MAGIC >> 8) & 0xff,
+                                              (MAINNET_MAGIC >> 16) & 0xff,
+                                              (MAINNET_MAGIC >> 24) & 0xff};
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    const uint8_t *key_data = public_key;
+
+    SHA256(tx, tx_len, data + 4);
+    SHA256(data, sizeof(data), hash);
+
+    EC_KEY *key = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+    assert_non_null(key);
+    assert_non_null(o2i_ECPublicKey(&key, &key_data, 65));
+    int verified = ECDSA_verify(0, hash, sizeof(hash), sig, (int) sig_len, key);
+    EC_KEY_free(key);
+    return verified == 1;
+}
+
+static void check_review_item(const char *title, const char *text, void *ctx) {
+    if (strcmp(title, "Address") == 0) {
+        strcpy((char *) ctx, text);
+    }
+}
+
+#define FROM_ADDRESS "NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM"
+#define TO_ADDRESS   "NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf"
+
+/**
+ * Destinations of a review, the texts of the items titled 'title', numbered or not ("To", "To 1/4").
+ */
+typedef struct {
+    const char *title;
+    char texts[8][64];
+    size_t count;
+} review_destinations_t;
+
+static void collect_destinations(const char *title, const char *text, void *ctx) {
+    review_destinations_t *destinations = ctx;
+    size_t len = strlen(destinations->title);
+
+    if (strncmp(title, destinations->title, len) == 0 && (title[len] == '\0' || title[len] == ' ')) {
+        assert_true(destinations->count < 8);
+        assert_true(strlen(text) < sizeof(destinations->texts[0]));
+        strcpy(destinations->texts[destinations->count++], text);
+    }
+}
+
+static void test_rfc6979(void **state) {
+    (void) state;
+
+    // RFC 6979 A.2.5, ECDSA with P-256 and SHA-256 of "sample"
+    const uint8_t d[32] = {0xc9, 0xaf, 0xa9, 0xd8, 0x45, 0xba, 0x75, 0x16, 0x6b, 0x5c, 0x21,
+                           0x57, 0x67, 0xb1, 0xd6, 0x93, 0x4e, 0x50, 0xc3, 0xdb, 0x36, 0xe8,
+                           0x9b, 0x12, 0x7b, 0x8a, 0x62, 0x2b, 0x12, 0x0f, 0x67, 0x21};
+    const uint8_t r[32] = {0xef, 0xd4, 0x8b, 0x2a, 0xac, 0xb6, 0xa8, 0xfd, 0x11, 0x40, 0xdd,
+                           0x9c, 0xd4, 0x5e, 0x81, 0xd6, 0x9d, 0x2c, 0x87, 0x7b, 0x56, 0xaa,
+                           0xf9, 0x91, 0xc3, 0x4d, 0x0e, 0xa8, 0x4e, 0xaf, 0x37, 0x16};
+    const uint8_t s[32] = {0xf7, 0xcb, 0x1c, 0x94, 0x2d, 0x65, 0x7c, 0x41, 0xd4, 0x36, 0xc7,
+                           0xa1, 0xb6, 0xe2, 0x9f, 0x65, 0xf3, 0xe9, 0x00, 0xdb, 0xb9, 0xaf,
+                           0xf4, 0x06, 0x4d, 0xc4, 0xab, 0x2f, 0x84, 0x3a, 0xcd, 0xa8};
+    cx_ecfp_private_key_t private_key;
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    uint8_t sig[MAX_DER_SIG_LEN];
+    size_t sig_len = sizeof(sig);
+    const uint8_t *sig_r;
+    const uint8_t *sig_s;
+    size_t r_len;
+    size_t s_len;
+
+    SHA256((const uint8_t *) "sample", 6, hash);
+    assert_int_equal(cx_ecfp_init_private_key_no_throw(CX_CURVE_256R1, d, sizeof(d), &private_key), CX_OK);
+    assert_int_equal(
+        cx_ecdsa_sign_no_throw(&private_key, CX_RND_RFC6979 | CX_LAST, CX_SHA256, hash, 32, sig, &sig_len, NULL),
+        CX_OK);
+    assert_int_equal(cx_ecfp_decode_sig_der(sig, sig_len, 33, &sig_r, &r_len, &sig_s, &s_len), 1);
+    assert_int_equal(r_len, 33);  // with a leading zero
+    assert_memory_equal(sig_r + 1, r, sizeof(r));
+    assert_int_equal(s_len, 33);
+    assert_memory_equal(sig_s + 1, s, sizeof(s));
+}
+
+static void test_app_name_version(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    const uint8_t get_app_name[] = {CLA, GET_APP_NAME, 0x00, 0x00, 0x00};
+    const uint8_t get_version[] = {CLA, GET_VERSION, 0x00, 0x00, 0x00};
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    int rapdu_len;
+
+    rapdu_len = emu_exchange(get_app_name, sizeof(get_app_name), rapdu, sizeof(rapdu));
+    assert_int_equal(rapdu_len, 6 + 2);
+    assert_memory_equal(rapdu, "NEO N3", 6);
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+
+    rapdu_len = emu_exchange(get_version, sizeof(get_version), rapdu, sizeof(rapdu));
+    assert_int_equal(rapdu_len, APPVERSION_LEN + 2);
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+}
+
+static void test_address_review(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    uint8_t apdu[sizeof(GET_PUBLIC_KEY_APDU)];
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    uint8_t public_key[65];
+    char address[64] = {0};
+    int rapdu_len;
+
+    // the key of the Speculos seed, the address shown by the functional tests
+    memcpy(apdu, GET_PUBLIC_KEY_APDU, sizeof(apdu));
+    apdu[3] = P2_PUBKEY_DISPLAY;
+    emu_set_review_callback(check_review_item, address);
+    rapdu_len = emu_exchange(apdu, sizeof(apdu), rapdu, sizeof(rapdu));
+    assert_int_equal(rapdu_len, 65 + 2);
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+    assert_string_equal(address, "NWsqzwMPiy6WkMZrd92BSTfoFyMj1L9AVz");
+    get_public_key(public_key);
+    assert_memory_equal(rapdu, public_key, sizeof(public_key));
+
+    emu_set_approval(false);
+    rapdu_len = emu_exchange(apdu, sizeof(apdu), rapdu, sizeof(rapdu));
+    assert_int_equal(rapdu_len, 2);
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_DENY);
+
+    assert_int_equal(emu_stats()->reviews, 2);
+    assert_int_equal(emu_stats()->approvals, 1);
+    assert_int_equal(emu_stats()->rejections, 1);
+}
+
+static void test_base58check_decode_address(void **state) {
+    (void) state;
+
+    // script hashes in script byte order
+    // clang-format off
+    const uint8_t to_script_hash[UINT160_LEN] = {
+        0x59, 0xa2, 0x55, 0x4d, 0x7c, 0xcc, 0x5f, 0x95, 0xaf, 0xb9, 0x28, 0x3e, 0x40, 0x16, 0x48, 0x46,
+        0xb7, 0xd4, 0xaf, 0x9b};
+    const uint8_t from_script_hash[UINT160_LEN] = {
+        0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd,
+        0x3e, 0xca, 0x2c, 0x68};
+    // clang-format on
+    uint8_t script_hash[UINT160_LEN];
+    uint8_t decoded[1 + UINT160_LEN + 4];
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    char address[ADDRESS_LEN + 2];
+
+    assert_true(base58check_decode_address(TO_ADDRESS, ADDRESS_LEN, script_hash));
+    assert_memory_equal(script_hash, to_script_hash, UINT160_LEN);
+    assert_true(base58check_decode_address(FROM_ADDRESS, ADDRESS_LEN, script_hash));
+    assert_memory_equal(script_hash, from_script_hash, UINT160_LEN);
+
+    // the Speculos address encodes back to itself
+    assert_true(base58check_decode_address("NWsqzwMPiy6WkMZrd92BSTfoFyMj1L9AVz", ADDRESS_LEN, script_hash));
+    assert_true(script_hash_to_address(address, sizeof(address), script_hash));
+    assert_string_equal(address, "NWsqzwMPiy6WkMZrd92BSTfoFyMj1L9AVz");
+
+    // a character of the checksum flipped
+    strcpy(address, TO_ADDRESS);
+    address[ADDRESS_LEN - 1] = (address[ADDRESS_LEN - 1] == 'f') ? 'g' : 'f';
+    assert_false(base58check_decode_address(address, ADDRESS_LEN, script_hash));
+
+    // the same script hash with the NEO Legacy version and a valid checksum
+    decoded[0] = 0x17;
+    memcpy(decoded + 1, to_script_hash, UINT160_LEN);
+    SHA256(decoded, 1 + UINT160_LEN, hash);
+    SHA256(hash, sizeof(hash), hash);
+    memcpy(decoded + 1 + UINT160_LEN, hash, 4);
+    int len = base58_encode(decoded, sizeof(decoded), address, sizeof(address) - 1);
+    assert_int_equal(len, ADDRESS_LEN);
+    address[len] = '\0';
+    assert_int_equal(address[0], 'A');
+    assert_false(base58check_decode_address(address, ADDRESS_LEN, script_hash));
+
+    // too long, too short and not base58
+    strcpy(address, TO_ADDRESS "1");
+    assert_false(base58check_decode_address(address, ADDRESS_LEN + 1, script_hash));
+    assert_false(base58check_decode_address(TO_ADDRESS, ADDRESS_LEN - 1, script_hash));
+    strcpy(address, TO_ADDRESS);
+    address[10] = '0';
+    assert_false(base58check_decode_address(address, ADDRESS_LEN, script_hash));
+}
+
+static void test_sign_corpus(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    uint8_t signature[MAX_DER_SIG_LEN];
+    uint8_t public_key[65];
+    int rapdu_len;
+
+    get_public_key(public_key);
+    emu_set_settings(true, true);
+    for (size_t i = 0; i < CORPUS_COUNT; i++) {
+        rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, CORPUS[i].data, CORPUS[i].len, 0, rapdu, sizeof(rapdu));
+        assert_true(rapdu_len > 2 && rapdu_len <= (int) sizeof(signature) + 2);
+        assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+        assert_true(signature_verifies(public_key, CORPUS[i].data, CORPUS[i].len, rapdu, rapdu_len - 2));
+
+        // deterministic signatures, the same in any encoding
+        memcpy(signature, rapdu, rapdu_len - 2);
+        assert_int_equal(emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, CORPUS[i].data, CORPUS[i].len, 0, rapdu, sizeof(rapdu)),
+                         rapdu_len);
+        assert_memory_equal(rapdu, signature, rapdu_len - 2);
+        assert_int_equal(
+            emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, CORPUS[i].data, CORPUS[i].len, P2_SIG_INVOCATION, rapdu, sizeof(rapdu)),
+            INVOCATION_SCRIPT_LEN + 2);
+        assert_int_equal(emu_sw(rapdu, INVOCATION_SCRIPT_LEN + 2), SW_OK);
+    }
+
+    assert_int_equal(emu_stats()->reviews, 3 * CORPUS_COUNT);
+    assert_int_equal(emu_stats()->approvals, 3 * CORPUS_COUNT);
+    assert_true(emu_stats()->review_items > 3 * CORPUS_COUNT * 5);
+    assert_int_equal(emu_stats()->review_errors, 0);
+}
+
+static void test_transfer_destinations(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    const corpus_tx_t *transfer = &CORPUS[0];
+    const corpus_tx_t *batch = &CORPUS[4];
+    review_destinations_t destinations = {.title = "To"};
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    int rapdu_len;
+
+    // the emulator fills the slot of each item with stale characters, the address ends at its 34 characters
+    emu_set_review_callback(collect_destinations, &destinations);
+    rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, transfer->data, transfer->len, 0, rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+    assert_int_equal(destinations.count, 1);
+    assert_int_equal(strlen(destinations.texts[0]), ADDRESS_LEN);
+    assert_string_equal(destinations.texts[0], TO_ADDRESS);
+
+    // "To 1/4" .. "To 4/4", the last transfer back to the sender
+    const char *batch_destinations[] = {TO_ADDRESS, TO_ADDRESS, TO_ADDRESS, FROM_ADDRESS};
+    destinations.count = 0;
+    rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, batch->data, batch->len, 0, rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+    assert_int_equal(destinations.count, 4);
+    for (size_t i = 0; i < destinations.count; i++) {
+        assert_string_equal(destinations.texts[i], batch_destinations[i]);
+    }
+    assert_int_equal(emu_stats()->review_errors, 0);
+}
+
+static void test_batch_destinations(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    // clang-format off
+    const uint8_t sign_batch[] = {
+        CLA, SIGN_TX_BATCH, P1_BATCH_START, 0x00, 0x67,
+        // m/44'/888'/0'/0/0
+        0x80, 0x00, 0x00, 0x2c, 0x80, 0x00, 0x03, 0x78, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        // MainNet, 2 transactions, 1 GAS of fees
+        0x4e, 0x45, 0x4f, 0x33, 0x02, 0x00, 0xe1, 0xf5, 0x05, 0x00, 0x00, 0x00, 0x00,
+        // 10 GAS
+        0x01,
+        0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e, 0xe3, 0x55, 0x61, 0x01, 0x13, 0x19,
+        0xf3, 0xcf, 0xa4, 0xd2, 0x00, 0xca, 0x9a, 0x3b, 0x00, 0x00, 0x00, 0x00,
+        // TO_ADDRESS and FROM_ADDRESS
+        0x02,
+        0x59, 0xa2, 0x55, 0x4d, 0x7c, 0xcc, 0x5f, 0x95, 0xaf, 0xb9, 0x28, 0x3e, 0x40, 0x16, 0x48, 0x46,
+        0xb7, 0xd4, 0xaf, 0x9b,
+        0x4a, 0x9d, 0x07, 0x86, 0x65, 0x84, 0x15, 0x81, 0x7f, 0x7d, 0x84, 0xe5, 0x10, 0x62, 0xc6, 0xbd,
+        0x3e, 0xca, 0x2c, 0x68};
+    // clang-format on
+    review_destinations_t destinations = {.title = "Destination"};
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    int rapdu_len;
+
+    // the emulator fills the slot of each item with stale characters, the addresses end at their 34 characters
+    emu_set_review_callback(collect_destinations, &destinations);
+    rapdu_len = emu_exchange(sign_batch, sizeof(sign_batch), rapdu, sizeof(rapdu));
+    assert_int_equal(rapdu_len, 2);
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+    assert_int_equal(emu_stats()->reviews, 1);
+    assert_int_equal(emu_stats()->review_errors, 0);
+    assert_int_equal(destinations.count, 2);
+    assert_string_equal(destinations.texts[0], TO_ADDRESS);
+    assert_string_equal(destinations.texts[1], FROM_ADDRESS);
+}
+
+static void test_sign_rejected(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    const corpus_tx_t *transfer = &CORPUS[0];
+    const corpus_tx_t *contract_call = &CORPUS[CORPUS_COUNT - 1];
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    int rapdu_len;
+
+    // arbitrary scripts are not allowed by default, no review
+    rapdu_len =
+        emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, contract_call->data, contract_call->len, 0, rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_DENY);
+    assert_int_equal(emu_stats()->reviews, 0);
+    assert_int_equal(emu_stats()->rejections, 1);
+
+    emu_set_approval(false);
+    rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, transfer->data, transfer->len, 0, rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_DENY);
+    assert_int_equal(emu_stats()->reviews, 1);
+    assert_int_equal(emu_stats()->rejections, 2);
+
+    // the session ended with the rejection
+    const uint8_t next_chunk[] = {CLA, SIGN_TX, 0x02, P2_LAST, 0x01, 0x00};
+    rapdu_len = emu_exchange(next_chunk, sizeof(next_chunk), rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_BAD_STATE);
+}
+
+/**
+ * Write the fields of a transaction before its signers at 'tx': version, nonce, fees and valid until block.
+ */
+static size_t write_tx_header(uint8_t *tx) {
+    memset(tx, 0, 25);
+    tx[21] = 1;  // valid until block
+    return 25;
+}
+
+static void test_sign_long_transaction(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    // a CalledByEntry signer, no attribute, then a script of 1200 bytes: PUSHDATA2 of 1195 bytes, DROP, RET
+    uint8_t tx[25 + 1 + UINT160_LEN + 1 + 1 + 3 + 1200];
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    uint8_t public_key[65];
+    size_t len = write_tx_header(tx);
+    int rapdu_len;
+
+    tx[len++] = 1;
+    memset(tx + len, 0x11, UINT160_LEN);
+    len += UINT160_LEN;
+    tx[len++] = CALLED_BY_ENTRY;
+    tx[len++] = 0;
+    tx[len++] = 0xFD;
+    tx[len++] = 1200 & 0xFF;
+    tx[len++] = 1200 >> 8;
+    tx[len++] = 0x0D;
+    tx[len++] = 1195 & 0xFF;
+    tx[len++] = 1195 >> 8;
+    memset(tx + len, 0x42, 1195);
+    len += 1195;
+    tx[len++] = 0x45;
+    tx[len++] = 0x40;
+    assert_int_equal(len, sizeof(tx));
+    assert_true(len > TRANSACTION_STORE_LEN);
+
+    // the script doesn't fit the store, it is reviewed as an arbitrary script
+    rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, tx, len, 0, rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_DENY);
+    assert_int_equal(emu_stats()->reviews, 0);
+
+    get_public_key(public_key);
+    emu_set_settings(true, true);
+    rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, tx, len, 0, rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_OK);
+    assert_true(signature_verifies(public_key, tx, len, rapdu, rapdu_len - 2));
+    assert_int_equal(emu_stats()->reviews, 1);
+    assert_int_equal(emu_stats()->review_errors, 0);
+}
+
+static void test_sign_store_overflow(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    // two signers with 16 allowed groups each, whose 2 * (20 + 16 * 33) bytes don't fit the store
+    uint8_t tx[25 + 1 + 2 * (UINT160_LEN + 1 + 1 + MAX_SIGNER_ALLOWED_GROUPS * ECPOINT_LEN)];
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    size_t len = write_tx_header(tx);
+    int rapdu_len;
+
+    tx[len++] = 2;
+    for (size_t i = 0; i < 2; i++) {
+        memset(tx + len, 0x11 + i, UINT160_LEN);
+        len += UINT160_LEN;
+        tx[len++] = CUSTOM_GROUPS;
+        tx[len++] = MAX_SIGNER_ALLOWED_GROUPS;
+        for (size_t j = 0; j < MAX_SIGNER_ALLOWED_GROUPS; j++) {
+            tx[len] = 0x02;
+            memset(tx + len + 1, (int) j, ECPOINT_LEN - 1);
+            len += ECPOINT_LEN;
+        }
+    }
+    assert_int_equal(len, sizeof(tx));
+
+    rapdu_len = emu_sign_tx(BIP44_PATH, MAINNET_MAGIC, tx, len, 0, rapdu, sizeof(rapdu));
+    assert_int_equal(rapdu_len, 1 + 2);
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_TX_PARSING_FAIL);
+    assert_int_equal((int8_t) rapdu[0], INVALID_LENGTH_ERROR);
+    assert_int_equal(emu_stats()->reviews, 0);
+}
+
+static void test_invalid_apdus(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    const uint8_t wrong_lc[] = {CLA, GET_VERSION, 0x00, 0x00, 0x02, 0x00};
+    const uint8_t wrong_cla[] = {0xE0, GET_VERSION, 0x00, 0x00, 0x00};
+    const uint8_t wrong_ins[] = {CLA, 0x7F, 0x00, 0x00, 0x00};
+    const uint8_t too_long[EMU_APDU_MAX_SIZE + 1] = {CLA, GET_VERSION, 0x00, 0x00, 0xFF};
+    // 2 public keys from m/44'/888'/0'/0/0, and a byte after the range
+    const uint8_t trailing_data[] = {CLA,  GET_PUBLIC_KEYS, 0x00, 0x00, 0x16, 0x80, 0x00, 0x00, 0x2c, 0x80,
+                                     0x00, 0x03,            0x78, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                     0x00, 0x00,            0x00, 0x00, 0x00, 0x02, 0x00};
+    uint8_t rapdu[EMU_APDU_MAX_SIZE];
+    int rapdu_len;
+
+    rapdu_len = emu_exchange(wrong_lc, sizeof(wrong_lc), rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_WRONG_DATA_LENGTH);
+    rapdu_len = emu_exchange(wrong_cla, sizeof(wrong_cla), rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_CLA_NOT_SUPPORTED);
+    rapdu_len = emu_exchange(wrong_ins, sizeof(wrong_ins), rapdu, sizeof(rapdu));
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_INS_NOT_SUPPORTED);
+    rapdu_len = emu_exchange(trailing_data, sizeof(trailing_data), rapdu, sizeof(rapdu));
+    assert_int_equal(rapdu_len, 2);
+    assert_int_equal(emu_sw(rapdu, rapdu_len), SW_WRONG_DATA_LENGTH);
+    assert_int_equal(emu_exchange(too_long, sizeof(too_long), rapdu, sizeof(rapdu)), -1);
+    // the response doesn't fit
+    assert_int_equal(emu_exchange(GET_PUBLIC_KEY_APDU, sizeof(GET_PUBLIC_KEY_APDU), rapdu, 2), -1);
+
+    // the app still works
+    uint8_t public_key[65];
+    get_public_key(public_key);
+}
+
+static void test_locked(void **state) {
+    (void) state;
+
+    emu_reset();
+
+    uint8_t public_key[65];
+    uint8_t locked_public_key[65];
+
+    // the cached public keys are flushed while the device is locked, and derived again
+    get_public_key(public_key);
+    emu_set_locked(true);
+    emu_ticker();
+    emu_set_locked(false);
+    get_public_key(locked_public_key);
+    assert_memory_equal(public_key, locked_public_key, sizeof(public_key));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_rfc6979),
+                                       cmocka_unit_test(test_app_name_version),
+                                       cmocka_unit_test(test_address_review),
+                                       cmocka_unit_test(test_base58check_decode_address),
+                                       cmocka_unit_test(test_sign_corpus),
+                                       cmocka_unit_test(test_transfer_destinations),
+                                       cmocka_unit_test(test_batch_destinations),
+                                       cmocka_unit_test(test_sign_rejected),
+                                       cmocka_unit_test(test_sign_long_transaction),
+                                       cmocka_unit_test(test_sign_store_overflow),
+                                       cmocka_unit_test(test_invalid_apdus),
+                                       cmocka_unit_test(test_locked)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
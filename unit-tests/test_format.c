@@ -3,6 +3,8 @@
 #include <setjmp.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <cmocka.h>
@@ -82,6 +84,70 @@ static void test_format_fpu64(void **state) {
     assert_false(format_fpu64(temp2, sizeof(temp2) - 20, amount, 18));
 }
 
+static void assert_format_amount_equal(uint64_t value, uint8_t decimals) {
+    char expected[64] = {0};
+    char out[64];
+
+    assert_true(format_fpu64(expected, sizeof(expected), value, decimals));
+    memset(out, 'x', sizeof(out));
+    assert_true(format_amount(out, sizeof(out), NULL, value, decimals, false));
+    assert_string_equal(out, expected);
+}
+
+static void test_format_amount(void **state) {
+    (void) state;
+
+    char temp[32];
+
+    const uint64_t values[] = {0ull,
+                               1ull,
+                               99ull,
+                               100ull,
+                               99999999ull,
+                               100000000ull,
+                               100000001ull,
+                               1234567890123456ull,
+                               9999999999999999ull,
+                               10000000000000000ull,
+                               9223372036854775807ull,
+                               18446744073709551615ull};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        for (uint8_t decimals = 0; decimals <= 22; decimals++) {
+            assert_format_amount_equal(values[i], decimals);
+        }
+    }
+
+    srand(8);
+    for (int n = 0; n < 10000; n++) {
+        uint64_t value = ((uint64_t) rand() << 62) ^ ((uint64_t) rand() << 31) ^ (uint64_t) rand();
+        assert_format_amount_equal(value >> (rand() % 64), rand() % 19);
+    }
+
+    assert_true(format_amount(temp, sizeof(temp), "GAS", 100000000ull, 8, false));
+    assert_string_equal(temp, "GAS 1.00000000");
+    assert_true(format_amount(temp, sizeof(temp), "NEO", 42ull, 0, false));
+    assert_string_equal(temp, "NEO 42.0");
+
+    // trailing zeros
+    assert_true(format_amount(temp, sizeof(temp), "GAS", 100000000ull, 8, true));
+    assert_string_equal(temp, "GAS 1.0");
+    assert_true(format_amount(temp, sizeof(temp), "GAS", 120050000ull, 8, true));
+    assert_string_equal(temp, "GAS 1.2005");
+    assert_true(format_amount(temp, sizeof(temp), "GAS", 100ull, 8, true));
+    assert_string_equal(temp, "GAS 0.000001");
+    assert_true(format_amount(temp, sizeof(temp), NULL, 0ull, 8, true));
+    assert_string_equal(temp, "0.0");
+    assert_true(format_amount(temp, sizeof(temp), NULL, 10ull, 0, true));
+    assert_string_equal(temp, "10.0");
+
+    // buffer too small
+    assert_true(format_amount(temp, sizeof("GAS 0.00000100"), "GAS", 100ull, 8, false));
+    assert_false(format_amount(temp, sizeof("GAS 0.00000100") - 1, "GAS", 100ull, 8, false));
+    assert_true(format_amount(temp, sizeof("1.2005"), NULL, 120050000ull, 8, true));
+    assert_false(format_amount(temp, sizeof("1.2005") - 1, NULL, 120050000ull, 8, true));
+    assert_false(format_amount(temp, 0, NULL, 0ull, 0, false));
+}
+
 static void test_format_hex(void **state) {
     (void) state;
 
@@ -94,11 +160,42 @@ static void test_format_hex(void **state) {
     assert_int_equal(-1, format_hex(address, sizeof(address), output, sizeof(address)));
 }
 
+static void test_format_hex_grouped(void **state) {
+    (void) state;
+
+    uint8_t bytes[256];
+    char output[2 * sizeof(bytes) + 1];
+    char expected[2 * sizeof(bytes) + 1];
+
+    // every byte value through the lookup table
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (uint8_t) i;
+        snprintf(expected + 2 * i, 3, "%02X", (unsigned int) i);
+    }
+    assert_int_equal(sizeof(output), format_hex_grouped(bytes, sizeof(bytes), 0, output, sizeof(output)));
+    assert_string_equal(output, expected);
+
+    const uint8_t key[] = {0x02, 0x4a, 0xcf, 0x5b, 0x2f, 0x42, 0x9d, 0x52, 0x81, 0xe9, 0x13};
+    char spaced[sizeof("024ACF5B 2F429D52 81E913")];
+
+    assert_int_equal(sizeof(spaced), format_hex_grouped(key, sizeof(key), 4, spaced, sizeof(spaced)));
+    assert_string_equal(spaced, "024ACF5B 2F429D52 81E913");
+    assert_int_equal(-1, format_hex_grouped(key, sizeof(key), 4, spaced, sizeof(spaced) - 1));
+
+    // no trailing space after a full group
+    assert_int_equal(sizeof("024ACF5B 2F429D52"), format_hex_grouped(key, 8, 4, spaced, sizeof(spaced)));
+    assert_string_equal(spaced, "024ACF5B 2F429D52");
+    assert_int_equal(1, format_hex_grouped(key, 0, 4, spaced, sizeof(spaced)));
+    assert_string_equal(spaced, "");
+}
+
 int main() {
     const struct CMUnitTest tests[] = {cmocka_unit_test(test_format_i64),
                                        cmocka_unit_test(test_format_u64),
                                        cmocka_unit_test(test_format_fpu64),
-                                       cmocka_unit_test(test_format_hex)};
+                                       cmocka_unit_test(test_format_amount),
+                                       cmocka_unit_test(test_format_hex),
+                                       cmocka_unit_test(test_format_hex_grouped)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,83 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "common/pubkey_cache.h"
+
+static void make_entry(uint32_t address_index, uint32_t *path, uint8_t *public_key, uint8_t *script_hash) {
+    const uint32_t account[] = {0x8000002C, 0x80000378, 0x80000000, 0};
+
+    memcpy(path, account, sizeof(account));
+    path[BIP44_PATH_LEN - 1] = address_index;
+    memset(public_key, (uint8_t) address_index, 64);
+    memset(script_hash, (uint8_t) ~address_index, UINT160_LEN);
+}
+
+static void test_pubkey_cache_get(void **state) {
+    (void) state;
+
+    uint32_t path[BIP44_PATH_LEN];
+    uint8_t public_key[64], expected_key[64];
+    uint8_t script_hash[UINT160_LEN], expected_hash[UINT160_LEN];
+
+    pubkey_cache_flush();
+    make_entry(1, path, expected_key, expected_hash);
+    assert_false(pubkey_cache_get(path, public_key, script_hash));
+
+    pubkey_cache_put(path, expected_key, expected_hash);
+    assert_true(pubkey_cache_get(path, public_key, script_hash));
+    assert_memory_equal(public_key, expected_key, sizeof(public_key));
+    assert_memory_equal(script_hash, expected_hash, sizeof(script_hash));
+    // the script hash is optional
+    memset(public_key, 0, sizeof(public_key));
+    assert_true(pubkey_cache_get(path, public_key, NULL));
+    assert_memory_equal(public_key, expected_key, sizeof(public_key));
+
+    // another address index of the same account
+    path[BIP44_PATH_LEN - 1] = 2;
+    assert_false(pubkey_cache_get(path, public_key, NULL));
+
+    pubkey_cache_flush();
+    path[BIP44_PATH_LEN - 1] = 1;
+    assert_false(pubkey_cache_get(path, public_key, NULL));
+}
+
+static void test_pubkey_cache_eviction(void **state) {
+    (void) state;
+
+    uint32_t path[BIP44_PATH_LEN];
+    uint8_t public_key[64], expected_key[64];
+    uint8_t script_hash[UINT160_LEN];
+
+    pubkey_cache_flush();
+    for (uint32_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        make_entry(i, path, public_key, script_hash);
+        pubkey_cache_put(path, public_key, script_hash);
+    }
+
+    // using the oldest entry saves it from the next eviction
+    make_entry(0, path, expected_key, script_hash);
+    assert_true(pubkey_cache_get(path, public_key, NULL));
+    make_entry(PUBKEY_CACHE_SIZE, path, public_key, script_hash);
+    pubkey_cache_put(path, public_key, script_hash);
+
+    for (uint32_t i = 0; i <= PUBKEY_CACHE_SIZE; i++) {
+        make_entry(i, path, expected_key, script_hash);
+        assert_int_equal(pubkey_cache_get(path, public_key, NULL), i != 1);
+        if (i != 1) {
+            assert_memory_equal(public_key, expected_key, sizeof(public_key));
+        }
+    }
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_pubkey_cache_get),
+                                       cmocka_unit_test(test_pubkey_cache_eviction)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
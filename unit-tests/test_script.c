@@ -0,0 +1,153 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "transaction/script.h"
+
+static void test_vm_decode(void **state) {
+    (void) state;
+
+    uint8_t script[] = {0x10,                    // PUSH0
+                        0x00, 0xff,              // PUSHINT8 -1
+                        0x0c, 0x02, 0xab, 0xcd,  // PUSHDATA1 2 bytes
+                        0x41, 0x62, 0x7d, 0x5b, 0x52,  // SYSCALL System.Contract.Call
+                        0x0d, 0x05, 0x00, 0x01};       // PUSHDATA2 5 bytes, truncated
+    buffer_t buf = {.ptr = script, .size = sizeof(script), .offset = 0};
+    vm_instruction_t ins;
+
+    assert_true(vm_decode(&buf, &ins));
+    assert_int_equal(ins.opcode, OPCODE_PUSH0);
+    assert_int_equal(ins.operand_len, 0);
+
+    assert_true(vm_decode(&buf, &ins));
+    assert_int_equal(ins.opcode, OPCODE_PUSHINT8);
+    assert_int_equal(ins.operand_len, 1);
+    assert_ptr_equal(ins.operand, script + 2);
+
+    assert_true(vm_decode(&buf, &ins));
+    assert_int_equal(ins.opcode, OPCODE_PUSHDATA1);
+    assert_int_equal(ins.operand_len, 2);
+    assert_ptr_equal(ins.operand, script + 5);
+
+    assert_true(vm_decode(&buf, &ins));
+    assert_int_equal(ins.opcode, OPCODE_SYSCALL);
+    assert_memory_equal(ins.operand, script + 8, 4);
+
+    assert_false(vm_decode(&buf, &ins));
+}
+
+static const uint8_t METHOD[] = {'f', 'o', 'o'};
+
+static const script_step_t STEPS_A[] = {
+    {.match = MATCH_INTEGER, .capture = 0},
+    {.opcode = OPCODE_PUSHDATA1, .match = MATCH_BYTES, .capture = CAPTURE_NONE, .operand_len = 3, .operand = METHOD},
+};
+
+static const script_step_t STEPS_B[] = {
+    {.match = MATCH_NULL_OR_POINT, .capture = 1},
+    {.opcode = OPCODE_PUSHDATA1, .match = MATCH_DATA, .capture = 2, .operand_len = 3},
+    {.opcode = OPCODE_PACK, .match = MATCH_OPCODE, .capture = CAPTURE_NONE},
+};
+
+static const script_template_t TEMPLATES[] = {
+    {.steps = STEPS_A, .steps_count = 2},
+    {.steps = STEPS_B, .steps_count = 3},
+};
+
+static void test_script_match(void **state) {
+    (void) state;
+
+    script_capture_t captures[3];
+
+    uint8_t a[] = {0x00, 0x80, 0x0c, 0x03, 'f', 'o', 'o'};
+    assert_int_equal(script_match(a, sizeof(a), TEMPLATES, 2, captures, NULL, NULL), 0);
+    assert_int_equal(captures[0].value, -128);
+
+    uint8_t a_int64[] = {0x03, 0x00, 0xe8, 0x76, 0x48, 0x17, 0x00, 0x00, 0x00, 0x0c, 0x03, 'f', 'o', 'o'};
+    assert_int_equal(script_match(a_int64, sizeof(a_int64), TEMPLATES, 2, captures, NULL, NULL), 0);
+    assert_int_equal(captures[0].value, 100000000000);
+
+    // extra code after a complete template
+    uint8_t a_extra[] = {0x11, 0x0c, 0x03, 'f', 'o', 'o', 0x40};
+    assert_int_equal(script_match(a_extra, sizeof(a_extra), TEMPLATES, 2, captures, NULL, NULL), -1);
+
+    // wrong method name
+    uint8_t a_method[] = {0x11, 0x0c, 0x03, 'f', 'o', 'x'};
+    assert_int_equal(script_match(a_method, sizeof(a_method), TEMPLATES, 2, captures, NULL, NULL), -1);
+
+    // incomplete template
+    uint8_t a_short[] = {0x11};
+    assert_int_equal(script_match(a_short, sizeof(a_short), TEMPLATES, 2, captures, NULL, NULL), -1);
+
+    uint8_t b_null[] = {0x0b, 0x0c, 0x03, 'b', 'a', 'r', 0xc0};
+    assert_int_equal(script_match(b_null, sizeof(b_null), TEMPLATES, 2, captures, NULL, NULL), 1);
+    assert_null(captures[1].data);
+    assert_ptr_equal(captures[2].data, b_null + 3);
+
+    uint8_t b_point[35 + 6] = {0x0c, 0x21, 0x03};
+    memcpy(b_point + 35, (uint8_t[]){0x0c, 0x03, 'b', 'a', 'r', 0xc0}, 6);
+    assert_int_equal(script_match(b_point, sizeof(b_point), TEMPLATES, 2, captures, NULL, NULL), 1);
+    assert_ptr_equal(captures[1].data, b_point + 2);
+
+    // not a compressed point
+    b_point[2] = 0x04;
+    assert_int_equal(script_match(b_point, sizeof(b_point), TEMPLATES, 2, captures, NULL, NULL), -1);
+}
+
+static const script_template_t REPEATED_TEMPLATES[] = {
+    {.steps = STEPS_A, .steps_count = 2, .max_passes = 3},
+};
+
+static bool record_pass(uint8_t template_index, uint8_t pass, const script_capture_t *captures, void *ctx) {
+    int64_t *values = (int64_t *) ctx;
+
+    assert_int_equal(template_index, 0);
+    values[pass] = captures[0].value;
+    // reject a pass with a zero amount
+    return captures[0].value != 0;
+}
+
+static void test_script_match_repeated(void **state) {
+    (void) state;
+
+    script_capture_t captures[1];
+    int64_t values[3] = {0};
+
+    uint8_t once[] = {0x11, 0x0c, 0x03, 'f', 'o', 'o'};
+    assert_int_equal(script_match(once, sizeof(once), REPEATED_TEMPLATES, 1, captures, record_pass, values), 0);
+    assert_int_equal(values[0], 1);
+
+    uint8_t three[] = {0x11, 0x0c, 0x03, 'f', 'o', 'o', 0x12, 0x0c, 0x03, 'f', 'o', 'o', 0x13, 0x0c, 0x03, 'f', 'o', 'o'};
+    assert_int_equal(script_match(three, sizeof(three), REPEATED_TEMPLATES, 1, captures, record_pass, values), 0);
+    assert_int_equal(values[0], 1);
+    assert_int_equal(values[1], 2);
+    assert_int_equal(values[2], 3);
+
+    // one pass more than allowed
+    uint8_t four[sizeof(three) + 6];
+    memcpy(four, three, sizeof(three));
+    memcpy(four + sizeof(three), once, sizeof(once));
+    assert_int_equal(script_match(four, sizeof(four), REPEATED_TEMPLATES, 1, captures, record_pass, values), -1);
+
+    // incomplete second pass
+    uint8_t partial[] = {0x11, 0x0c, 0x03, 'f', 'o', 'o', 0x12};
+    assert_int_equal(script_match(partial, sizeof(partial), REPEATED_TEMPLATES, 1, captures, record_pass, values), -1);
+
+    // pass rejected by the callback
+    uint8_t rejected[] = {0x11, 0x0c, 0x03, 'f', 'o', 'o', 0x10, 0x0c, 0x03, 'f', 'o', 'o'};
+    assert_int_equal(script_match(rejected, sizeof(rejected), REPEATED_TEMPLATES, 1, captures, record_pass, values),
+                     -1);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_vm_decode),
+                                       cmocka_unit_test(test_script_match),
+                                       cmocka_unit_test(test_script_match_repeated)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,61 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "transaction/tokens.h"
+
+static void test_tokens_sorted(void **state) {
+    (void) state;
+
+    for (size_t i = 1; i < TOKENS_COUNT; i++) {
+        assert_true(memcmp(TOKENS[i - 1].script_hash, TOKENS[i].script_hash, UINT160_LEN) < 0);
+    }
+}
+
+static void test_token_lookup(void **state) {
+    (void) state;
+
+    // NEO 0xef4073a0f2b305a38ec4050e4d3d28bc40ea63f5
+    const uint8_t neo[UINT160_LEN] = {0xf5, 0x63, 0xea, 0x40, 0xbc, 0x28, 0x3d, 0x4d, 0x0e, 0x05,
+                                      0xc4, 0x8e, 0xa3, 0x05, 0xb3, 0xf2, 0xa0, 0x73, 0x40, 0xef};
+    // GAS 0xd2a4cff31913016155e38e474a2c06d08be276cf
+    const uint8_t gas[UINT160_LEN] = {0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e,
+                                      0xe3, 0x55, 0x61, 0x01, 0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2};
+    uint8_t unknown[UINT160_LEN];
+    const token_info_t *token;
+
+    token = token_lookup(neo);
+    assert_non_null(token);
+    assert_string_equal(token->ticker, "NEO");
+    assert_int_equal(token->decimals, 0);
+
+    token = token_lookup(gas);
+    assert_non_null(token);
+    assert_string_equal(token->ticker, "GAS");
+    assert_int_equal(token->decimals, 8);
+
+    // every entry can be found
+    for (size_t i = 0; i < TOKENS_COUNT; i++) {
+        assert_ptr_equal(token_lookup(TOKENS[i].script_hash), &TOKENS[i]);
+    }
+
+    // before, between and after the registry entries
+    memset(unknown, 0x00, sizeof(unknown));
+    assert_null(token_lookup(unknown));
+    memcpy(unknown, gas, sizeof(unknown));
+    unknown[UINT160_LEN - 1] ^= 0x01;
+    assert_null(token_lookup(unknown));
+    memset(unknown, 0xff, sizeof(unknown));
+    assert_null(token_lookup(unknown));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_tokens_sorted), cmocka_unit_test(test_token_lookup)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}